@@ -0,0 +1,367 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mylib/util.h>
+#include <mylib/arena.h>
+
+/**
+ * @brief Alignment of blocks, enough for any scalar type.
+ */
+#define ARENA_ALIGN 16
+
+/**
+ * @brief Rounds a size up to the alignment of blocks.
+ */
+#define ARENA_ROUND(x) (((x) + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1))
+
+/**
+ * @brief Slab.
+ */
+struct slab
+{
+	struct slab *next; /**< Previous slab.        */
+	size_t size;       /**< Usable bytes.         */
+	size_t used;       /**< Bytes handed out.     */
+	char *base;        /**< First usable byte.    */
+};
+
+/**
+ * @brief Header of a block, right before the block itself.
+ */
+struct block
+{
+	size_t size;                                /**< Usable bytes. */
+	char pad[ARENA_ALIGN - sizeof(size_t)];     /**< Alignment.    */
+};
+
+/**
+ * @brief Arena.
+ *
+ * @details Hands out blocks from large slabs by bumping a pointer, and
+ *          releases them all at once when destroyed. Blocks are never
+ *          freed on their own, so the memory in use only grows and its
+ *          current value is also its peak. Blocks larger than a quarter
+ *          of a slab get a slab of their own, so that they do not waste
+ *          the rest of the current one. Arenas may be shared by threads.
+ */
+struct arena
+{
+	size_t slabsize;               /**< Usable bytes of regular slabs. */
+	struct slab *slabs;            /**< Current slab, then older ones. */
+	int nslabs;                    /**< Number of slabs.               */
+	size_t size;                   /**< Bytes held in slabs.           */
+	size_t used;                   /**< Bytes handed out.              */
+	unsigned long int nallocs;     /**< Number of blocks handed out.   */
+	pthread_mutex_t lock;          /**< Serializes allocations.        */
+};
+
+/*====================================================================*
+ * SLAB                                                               *
+ *====================================================================*/
+
+/**
+ * @brief Adds a slab to an arena.
+ *
+ * @details Large slabs go behind the current one, which keeps serving
+ *          small blocks.
+ *
+ * @param a    Target arena.
+ * @param size Usable bytes.
+ *
+ * @returns The new slab.
+ */
+static struct slab *slab_create(struct arena *a, size_t size)
+{
+	struct slab *s;
+
+	if ((s = malloc(ARENA_ROUND(sizeof(struct slab)) + size)) == NULL)
+		error("cannot allocate arena slab");
+
+	s->size = size;
+	s->used = 0;
+	s->base = (char *) s + ARENA_ROUND(sizeof(struct slab));
+
+	if ((size > a->slabsize) && (a->slabs != NULL))
+	{
+		s->next = a->slabs->next;
+		a->slabs->next = s;
+	}
+	else
+	{
+		s->next = a->slabs;
+		a->slabs = s;
+	}
+
+	a->nslabs++;
+	a->size += size;
+
+	return (s);
+}
+
+/*====================================================================*
+ * ARENA                                                              *
+ *====================================================================*/
+
+/**
+ * @brief Creates an arena.
+ *
+ * @param slabsize Usable bytes of each slab.
+ *
+ * @returns An arena.
+ */
+struct arena *arena_create(size_t slabsize)
+{
+	struct arena *a;
+
+	/* Sanity check. */
+	assert(slabsize > 0);
+
+	if ((a = malloc(sizeof(struct arena))) == NULL)
+		error("cannot allocate arena");
+
+	a->slabsize = ARENA_ROUND(slabsize);
+	a->slabs = NULL;
+	a->nslabs = 0;
+	a->size = 0;
+	a->used = 0;
+	a->nallocs = 0;
+	pthread_mutex_init(&a->lock, NULL);
+
+	return (a);
+}
+
+/**
+ * @brief Destroys an arena, and all blocks handed out by it.
+ *
+ * @param a Target arena.
+ */
+void arena_destroy(struct arena *a)
+{
+	/* Sanity check. */
+	assert(a != NULL);
+
+	while (a->slabs != NULL)
+	{
+		struct slab *s = a->slabs;
+
+		a->slabs = s->next;
+		free(s);
+	}
+	pthread_mutex_destroy(&a->lock);
+	free(a);
+}
+
+/**
+ * @brief Allocates a block from an arena.
+ *
+ * @param a    Target arena.
+ * @param size Number of bytes.
+ *
+ * @returns A block of memory, aligned for any scalar type.
+ */
+void *arena_alloc(struct arena *a, size_t size)
+{
+	struct block *b;
+	struct slab *s;
+	size_t need;
+
+	/* Sanity check. */
+	assert(a != NULL);
+
+	need = sizeof(struct block) + ARENA_ROUND(size);
+
+	pthread_mutex_lock(&a->lock);
+
+	s = a->slabs;
+	if (need > a->slabsize/4)
+		s = slab_create(a, need);
+	else if ((s == NULL) || (s->used + need > s->size))
+		s = slab_create(a, a->slabsize);
+
+	b = (struct block *) (s->base + s->used);
+	b->size = size;
+	s->used += need;
+	a->used += need;
+	a->nallocs++;
+
+	pthread_mutex_unlock(&a->lock);
+
+	return (b + 1);
+}
+
+/**
+ * @brief Resizes a block of an arena.
+ *
+ * @param a    Target arena.
+ * @param p    Target block, NULL for a new one.
+ * @param size New number of bytes.
+ *
+ * @returns The resized block, with the contents of the old one.
+ */
+void *arena_realloc(struct arena *a, void *p, size_t size)
+{
+	size_t old;
+	void *q;
+
+	/* Sanity check. */
+	assert(a != NULL);
+
+	if (p == NULL)
+		return (arena_alloc(a, size));
+
+	/* Blocks never shrink. */
+	old = ((struct block *) p - 1)->size;
+	if (size <= old)
+		return (p);
+
+	q = arena_alloc(a, size);
+	memcpy(q, p, old);
+
+	return (q);
+}
+
+/**
+ * @brief Allocates a block from an arena, or from the C library.
+ *
+ * @param a    Target arena, NULL for the C library.
+ * @param size Number of bytes.
+ *
+ * @returns A block of memory.
+ */
+void *arena_smalloc(struct arena *a, size_t size)
+{
+	return ((a != NULL) ? arena_alloc(a, size) : smalloc(size));
+}
+
+/**
+ * @brief Allocates a zero-filled block from an arena, or from the C library.
+ *
+ * @param a    Target arena, NULL for the C library.
+ * @param n    Number of elements.
+ * @param size Size of each element.
+ *
+ * @returns A zero-filled block of memory.
+ */
+void *arena_scalloc(struct arena *a, size_t n, size_t size)
+{
+	void *p;
+
+	if (a == NULL)
+		return (scalloc(n, size));
+
+	p = arena_alloc(a, n*size);
+	memset(p, 0, n*size);
+
+	return (p);
+}
+
+/**
+ * @brief Resizes a block of an arena, or of the C library.
+ *
+ * @param a    Arena the block came from, NULL for the C library.
+ * @param p    Target block, NULL for a new one.
+ * @param size New number of bytes.
+ *
+ * @returns The resized block, with the contents of the old one.
+ */
+void *arena_srealloc(struct arena *a, void *p, size_t size)
+{
+	return ((a != NULL) ? arena_realloc(a, p, size) : srealloc(p, size));
+}
+
+/**
+ * @brief Releases a block allocated with arena_smalloc(), arena_scalloc()
+ * or arena_srealloc().
+ * Arena blocks are only released when their arena is destroyed.
+ *
+ * @param a Arena the block came from, NULL for the C library.
+ * @param p Target block.
+ */
+void arena_sfree(struct arena *a, void *p)
+{
+	if (a == NULL)
+		sfree(p);
+}
+
+/**
+ * @brief Returns the number of bytes handed out by an arena.
+ *
+ * @param a Target arena.
+ *
+ * @returns Bytes handed out, headers included.
+ */
+size_t arena_used(const struct arena *a)
+{
+	/* Sanity check. */
+	assert(a != NULL);
+
+	return (a->used);
+}
+
+/**
+ * @brief Returns the number of bytes held by an arena.
+ *
+ * @param a Target arena.
+ *
+ * @returns Bytes held in slabs.
+ */
+size_t arena_size(const struct arena *a)
+{
+	/* Sanity check. */
+	assert(a != NULL);
+
+	return (a->size);
+}
+
+/**
+ * @brief Returns the number of slabs of an arena.
+ *
+ * @param a Target arena.
+ *
+ * @returns Number of slabs.
+ */
+int arena_nslabs(const struct arena *a)
+{
+	/* Sanity check. */
+	assert(a != NULL);
+
+	return (a->nslabs);
+}
+
+/**
+ * @brief Returns the number of blocks handed out by an arena.
+ *
+ * @param a Target arena.
+ *
+ * @returns Number of blocks handed out.
+ */
+unsigned long int arena_nallocs(const struct arena *a)
+{
+	/* Sanity check. */
+	assert(a != NULL);
+
+	return (a->nallocs);
+}
@@ -23,6 +23,7 @@
 #include <stdlib.h>
 
 #include <mylib/util.h>
+#include <mylib/arena.h>
 #include <mylib/array.h>
 
 /**
@@ -32,6 +33,7 @@ struct array
 {
 	unsigned long int size; /**< Maximum size. */
 	void **elements;        /**< Elements.     */
+	arena_tt arena;         /**< Arena.        */
 };
 
 /**
@@ -40,13 +42,25 @@ struct array
  * @param size Array size.
  */
 struct array *array_create(unsigned long int size)
+{
+	return (array_create_arena(size, NULL));
+}
+
+/**
+ * @brief Creates an array in an arena.
+ *
+ * @param size  Array size.
+ * @param arena Arena, NULL for the C library.
+ */
+struct array *array_create_arena(unsigned long int size, arena_tt arena)
 {
 	struct array *a;
 
 	/* Create array. */
-	a = smalloc(sizeof(struct array));
+	a = arena_smalloc(arena, sizeof(struct array));
 	a->size = size;
-	a->elements = smalloc(size*sizeof(void *));
+	a->elements = arena_smalloc(arena, size*sizeof(void *));
+	a->arena = arena;
 
 	return (a);
 }
@@ -61,8 +75,8 @@ void array_destroy(struct array *a)
 	/* Sanity check. */
 	assert(a != NULL);
 
-	free(a->elements);
-	free(a);
+	arena_sfree(a->arena, a->elements);
+	arena_sfree(a->arena, a);
 }
 
 /**
@@ -115,12 +129,14 @@ void *array_get(const struct array *a, unsigned long int idx)
 /**
  * @brief Shuffles an array.
  *
- * @param a Target array.
+ * @param a   Target array.
+ * @param rng Random sequence.
  */
-void array_shuffle(struct array *a)
+void array_shuffle(struct array *a, struct rng *rng)
 {
 	/* Sanity check. */
 	assert(a != NULL);
+	assert(rng != NULL);
 
 	/* Shuffle array. */
 	for (unsigned long int i = 0; i < a->size - 1; i++)
@@ -128,7 +144,7 @@ void array_shuffle(struct array *a)
 		int j;     /* Shuffle index.  */
 		void *tmp; /* Temporary data. */
 
-		j = rand()%a->size;
+		j = rng_next(rng)%a->size;
 
 		tmp = a->elements[i];
 		a->elements[i] = a->elements[j];
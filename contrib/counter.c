@@ -0,0 +1,179 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <mylib/util.h>
+#include <mylib/counter.h>
+
+/**
+ * @brief Counter.
+ *
+ * @details Counts occurrences of keys in [0, n) with one slot per key.
+ *          Keys are also listed in the order they were first counted,
+ *          so that counted keys can be walked and cleared without
+ *          touching the whole domain.
+ */
+struct counter
+{
+	int n;       /**< Number of keys.               */
+	int *counts; /**< Occurrences of each key.      */
+	int *keys;   /**< Counted keys, in order.       */
+	int size;    /**< Number of counted keys.       */
+	int total;   /**< Occurrences of all keys.      */
+};
+
+/**
+ * @brief Creates a counter.
+ *
+ * @param n Number of keys.
+ *
+ * @returns A counter.
+ */
+struct counter *counter_create(int n)
+{
+	struct counter *c;
+
+	/* Sanity check. */
+	assert(n > 0);
+
+	c = smalloc(sizeof(struct counter));
+	c->n = n;
+	c->counts = scalloc(n, sizeof(int));
+	c->keys = smalloc(n*sizeof(int));
+	c->size = 0;
+	c->total = 0;
+
+	return (c);
+}
+
+/**
+ * @brief Destroys a counter.
+ *
+ * @param c Target counter.
+ */
+void counter_destroy(struct counter *c)
+{
+	/* Sanity check. */
+	assert(c != NULL);
+
+	sfree(c->keys);
+	sfree(c->counts);
+	sfree(c);
+}
+
+/**
+ * @brief Resets a counter.
+ *
+ * @param c Target counter.
+ */
+void counter_clear(struct counter *c)
+{
+	/* Sanity check. */
+	assert(c != NULL);
+
+	for (int i = 0; i < c->size; i++)
+		c->counts[c->keys[i]] = 0;
+	c->size = 0;
+	c->total = 0;
+}
+
+/**
+ * @brief Counts an occurrence of a key.
+ *
+ * @param c   Target counter.
+ * @param key Target key.
+ */
+void counter_increment(struct counter *c, int key)
+{
+	/* Sanity check. */
+	assert(c != NULL);
+	assert((key >= 0) && (key < c->n));
+
+	if (c->counts[key]++ == 0)
+		c->keys[c->size++] = key;
+	c->total++;
+}
+
+/**
+ * @brief Returns the occurrences of a key.
+ *
+ * @param c   Target counter.
+ * @param key Target key.
+ *
+ * @returns The number of times the key was counted.
+ */
+int counter_get(const struct counter *c, int key)
+{
+	/* Sanity check. */
+	assert(c != NULL);
+	assert((key >= 0) && (key < c->n));
+
+	return (c->counts[key]);
+}
+
+/**
+ * @brief Returns the number of distinct keys counted.
+ *
+ * @param c Target counter.
+ *
+ * @returns The number of distinct keys counted.
+ */
+int counter_size(const struct counter *c)
+{
+	/* Sanity check. */
+	assert(c != NULL);
+
+	return (c->size);
+}
+
+/**
+ * @brief Returns the ith distinct key counted.
+ *
+ * @param c Target counter.
+ * @param i Key index, in the order keys were first counted.
+ *
+ * @returns The ith distinct key counted.
+ */
+int counter_key(const struct counter *c, int i)
+{
+	/* Sanity check. */
+	assert(c != NULL);
+	assert((i >= 0) && (i < c->size));
+
+	return (c->keys[i]);
+}
+
+/**
+ * @brief Returns the occurrences of all keys.
+ *
+ * @param c Target counter.
+ *
+ * @returns The sum of the occurrences of all keys.
+ */
+int counter_total(const struct counter *c)
+{
+	/* Sanity check. */
+	assert(c != NULL);
+
+	return (c->total);
+}
@@ -77,7 +77,7 @@ static inline struct dqnode *dqnode_create(void *obj, int counter)
  */
 static inline void dqnode_destroy(struct dqnode *node)
 {
-	free(node);
+	sfree(node);
 }
 
 /*====================================================================*
@@ -115,7 +115,7 @@ void dqueue_destroy(struct dqueue *q)
 	/* House keeping. */
 	while (!dqueue_empty(q))
 		dqueue_remove(q);
-	free(q);
+	sfree(q);
 }
 
 /**
@@ -191,9 +191,7 @@ void dqueue_insert(struct dqueue *q, void *obj, int counter)
 	}
 
 	/* Create new node. */
-	tmp = smalloc(sizeof(struct dqueue));
-	tmp->obj = obj;
-	tmp->counter = counter;
+	tmp = dqnode_create(obj, counter);
 
 	/* Insert object. */
 	tmp->next = node->next;
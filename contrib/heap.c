@@ -0,0 +1,351 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <mylib/util.h>
+#include <mylib/heap.h>
+
+/**
+ * @brief Initial heap capacity.
+ */
+#define HEAP_INITIAL_CAPACITY 16
+
+/**
+ * @brief Heap node.
+ */
+struct hnode
+{
+	void *obj;               /**< Underlying object.             */
+	long int key;            /**< Priority, smallest first.      */
+	unsigned long int order; /**< Insertion order, to break ties. */
+	int handle;              /**< Handle given on insertion.     */
+};
+
+/**
+ * @brief Heap.
+ *
+ * @details A binary min-heap laid out in an array. Each object gets a
+ *          handle on insertion that tracks its position in the heap, so
+ *          that its key can be decreased later. Objects with equal keys
+ *          leave the heap in insertion order.
+ */
+struct heap
+{
+	int size;                     /**< Current heap size.                 */
+	int capacity;                 /**< Number of nodes allocated.         */
+	struct hnode *nodes;          /**< Nodes, in heap order.              */
+	int *positions;               /**< Position of each handle, or -1.    */
+	int *free_handles;            /**< Handles available for reuse.       */
+	int nfree;                    /**< Number of handles available.       */
+	unsigned long int next_order; /**< Insertion order of the next node.  */
+};
+
+/*====================================================================*
+ * HEAP NODE                                                          *
+ *====================================================================*/
+
+/**
+ * @brief Asserts if a heap node goes before another.
+ *
+ * @param a First node.
+ * @param b Second node.
+ *
+ * @returns True if the first node goes before the second.
+ */
+static inline bool hnode_before(const struct hnode *a, const struct hnode *b)
+{
+	return ((a->key < b->key) || ((a->key == b->key) && (a->order < b->order)));
+}
+
+/**
+ * @brief Places a node at a given position of a heap.
+ *
+ * @param h    Target heap.
+ * @param pos  Target position.
+ * @param node Target node.
+ */
+static inline void heap_place(struct heap *h, int pos, const struct hnode *node)
+{
+	h->nodes[pos] = *node;
+	h->positions[node->handle] = pos;
+}
+
+/**
+ * @brief Moves a node towards the root of a heap.
+ *
+ * @param h   Target heap.
+ * @param pos Position of the node.
+ */
+static void heap_sift_up(struct heap *h, int pos)
+{
+	struct hnode node = h->nodes[pos];
+
+	while (pos > 0)
+	{
+		int parent = (pos - 1)/2;
+
+		if (!hnode_before(&node, &h->nodes[parent]))
+			break;
+
+		heap_place(h, pos, &h->nodes[parent]);
+		pos = parent;
+	}
+
+	heap_place(h, pos, &node);
+}
+
+/**
+ * @brief Moves a node towards the leaves of a heap.
+ *
+ * @param h   Target heap.
+ * @param pos Position of the node.
+ */
+static void heap_sift_down(struct heap *h, int pos)
+{
+	struct hnode node = h->nodes[pos];
+
+	while (2*pos + 1 < h->size)
+	{
+		int child = 2*pos + 1;
+
+		if ((child + 1 < h->size) && hnode_before(&h->nodes[child + 1], &h->nodes[child]))
+			child++;
+		if (!hnode_before(&h->nodes[child], &node))
+			break;
+
+		heap_place(h, pos, &h->nodes[child]);
+		pos = child;
+	}
+
+	heap_place(h, pos, &node);
+}
+
+/*====================================================================*
+ * HEAP                                                               *
+ *====================================================================*/
+
+/**
+ * @brief Creates a heap.
+ * 
+ * @returns A heap.
+ */
+struct heap *heap_create(void)
+{
+	struct heap *h;
+
+	h = smalloc(sizeof(struct heap));
+
+	/* Initialize heap. */
+	h->size = 0;
+	h->capacity = HEAP_INITIAL_CAPACITY;
+	h->nodes = smalloc(HEAP_INITIAL_CAPACITY*sizeof(struct hnode));
+	h->positions = smalloc(HEAP_INITIAL_CAPACITY*sizeof(int));
+	h->free_handles = smalloc(HEAP_INITIAL_CAPACITY*sizeof(int));
+	h->nfree = 0;
+	h->next_order = 0;
+
+	return (h);
+}
+
+/**
+ * @brief Destroys a heap.
+ * 
+ * @param h Target heap.
+ */
+void heap_destroy(struct heap *h)
+{
+	/* Sanity check. */
+	assert(h != NULL);
+
+	sfree(h->free_handles);
+	sfree(h->positions);
+	sfree(h->nodes);
+	sfree(h);
+}
+
+/**
+ * @brief Returns the size of a heap.
+ *
+ * @param h Target heap.
+ *
+ * @returns The current size of the target heap.
+ */
+int heap_size(const struct heap *h)
+{
+	/* Sanity check. */
+	assert(h != NULL);
+
+	return (h->size);
+}
+
+/**
+ * @brief Asserts if a heap is empty.
+ *
+ * @param h Target heap.
+ *
+ * @returns True if the target heap is empty and false otherwise.
+ */
+bool heap_empty(const struct heap *h)
+{
+	return (heap_size(h) == 0);
+}
+
+/**
+ * @brief Inserts an object in a heap.
+ * 
+ * @param h   Target heap.
+ * @param obj Target object.
+ * @param key Object's key.
+ *
+ * @returns A handle to the object, valid until it leaves the heap.
+ */
+int heap_insert(struct heap *h, void *obj, long int key)
+{
+	struct hnode node;
+
+	/* Sanity check. */
+	assert(h != NULL);
+	assert(obj != NULL);
+
+	/* Grow heap. */
+	if (h->size == h->capacity)
+	{
+		h->capacity *= 2;
+		h->nodes = srealloc(h->nodes, h->capacity*sizeof(struct hnode));
+		h->positions = srealloc(h->positions, h->capacity*sizeof(int));
+		h->free_handles = srealloc(h->free_handles, h->capacity*sizeof(int));
+	}
+
+	/* Handles in use never outnumber nodes. */
+	node.obj = obj;
+	node.key = key;
+	node.order = h->next_order++;
+	node.handle = (h->nfree > 0) ? h->free_handles[--h->nfree] : h->size;
+
+	heap_place(h, h->size++, &node);
+	heap_sift_up(h, h->size - 1);
+
+	return (node.handle);
+}
+
+/**
+ * @brief Removes the object with the smallest key from a heap.
+ * 
+ * @param h Target heap.
+ * 
+ * @returns The object with the smallest key.
+ */
+void *heap_remove(struct heap *h)
+{
+	struct hnode top;
+
+	/* Sanity check. */
+	assert(h != NULL);
+	assert(h->size > 0);
+
+	top = h->nodes[0];
+	h->positions[top.handle] = -1;
+	h->free_handles[h->nfree++] = top.handle;
+
+	if (--h->size > 0)
+	{
+		heap_place(h, 0, &h->nodes[h->size]);
+		heap_sift_down(h, 0);
+	}
+
+	return (top.obj);
+}
+
+/**
+ * @brief Returns the object with the smallest key in a heap.
+ *
+ * @param h Target heap.
+ *
+ * @returns The object with the smallest key.
+ */
+void *heap_peek(const struct heap *h)
+{
+	/* Sanity check. */
+	assert(h != NULL);
+	assert(h->size > 0);
+
+	return (h->nodes[0].obj);
+}
+
+/**
+ * @brief Returns the smallest key in a heap.
+ *
+ * @param h Target heap.
+ *
+ * @returns The smallest key in the target heap.
+ */
+long int heap_next_key(const struct heap *h)
+{
+	/* Sanity check. */
+	assert(h != NULL);
+	assert(h->size > 0);
+
+	return (h->nodes[0].key);
+}
+
+/**
+ * @brief Returns the key of an object in a heap.
+ *
+ * @param h      Target heap.
+ * @param handle Object's handle.
+ *
+ * @returns The key of the target object.
+ */
+long int heap_key(const struct heap *h, int handle)
+{
+	/* Sanity check. */
+	assert(h != NULL);
+	assert((handle >= 0) && (handle < h->capacity));
+	assert(h->positions[handle] >= 0);
+
+	return (h->nodes[h->positions[handle]].key);
+}
+
+/**
+ * @brief Decreases the key of an object in a heap.
+ *
+ * @param h      Target heap.
+ * @param handle Object's handle.
+ * @param key    New key, no greater than the current one.
+ */
+void heap_decrease_key(struct heap *h, int handle, long int key)
+{
+	int pos;
+
+	/* Sanity check. */
+	assert(h != NULL);
+	assert((handle >= 0) && (handle < h->capacity));
+	assert(h->positions[handle] >= 0);
+
+	pos = h->positions[handle];
+	assert(key <= h->nodes[pos].key);
+
+	h->nodes[pos].key = key;
+	heap_sift_up(h, pos);
+}
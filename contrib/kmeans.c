@@ -11,11 +11,13 @@
 
 struct kmeans
 {
-    int max_iter;   /**< Max. number of iterations.             */
-    int n_clusters; /**< Current ideal number of clusters.      */
+    int max_iter;    /**< Max. number of iterations.             */
+    int n_clusters;  /**< Current ideal number of clusters.      */
 
-    int n_vectors;  /**< Total number of arrays in vectors.     */
-    int v_length;   /**< Total of elements in each array.       */
+    int n_vectors;   /**< Total number of arrays in vectors.     */
+    int v_length;    /**< Total of elements in each array.       */
+
+    struct rng *rng; /**< Random sequence of medoid choices.     */
 };
 
 /**
@@ -24,21 +26,24 @@ struct kmeans
  * @param max_iter  Max number of desired iterations.
  * @param n_cluster Number of desired clusters. 
  * @param v_length  Total of elements in each array.
+ * @param rng       Random sequence of medoid choices.
  * 
  * @returns New KMeans instance.
 */
-kmeans_tt kmeans_create(int max_iter, int n_clusters, int v_length)
+kmeans_tt kmeans_create(int max_iter, int n_clusters, int v_length, struct rng *rng)
 {
     struct kmeans *k;
 
     /* Sanity check. */
     assert(v_length > 0);
+    assert(rng != NULL);
 
     k = (struct kmeans*) malloc(sizeof(struct kmeans));
     k->max_iter = max_iter;
     k->n_clusters = n_clusters;
     k->n_vectors = 0;
     k->v_length = v_length;
+    k->rng = rng;
 
     return k;
 }
@@ -265,7 +270,7 @@ void kmeans_initialize_medoids(struct kmeans *k, int **me, int **vectors)
     int selected[k->n_vectors];
     for ( int i = 0; i < k->n_vectors; i++ ) selected[i] = 0;
 
-    int first_medoid_idx = rand() % k->n_vectors;
+    int first_medoid_idx = rng_next(k->rng) % k->n_vectors;
     selected[first_medoid_idx] = 1;
 
     for ( int i= 0; i < k->v_length; i++)
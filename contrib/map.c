@@ -1,105 +1,214 @@
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
-#include "mem.h"
+#include <string.h>
 
 #include <mylib/util.h>
+#include <mylib/arena.h>
 #include <mylib/map.h>
 
+/**
+ * @brief Initial number of entries. Must be a power of two.
+ */
+#define MAP_INITIAL_CAPACITY 8
+
+/**
+ * @name Hash Slot Markers
+ */
+/**@{*/
+#define MAP_SLOT_EMPTY   -1 /**< Never used.        */
+#define MAP_SLOT_REMOVED -2 /**< Used, then freed.  */
+/**@}*/
+
 /*====================================================================*
- * MAP NODE                                                           *
+ * MAP                                                                *
  *====================================================================*/
+
 /**
- * @brief Map node.
+ * @brief Map.
+ *
+ * @details Counts the occurrences of keys, which are copied by value.
+ *          Entries are kept densely, in insertion order, so that they
+ *          can be walked by index. An open-addressing hash table with
+ *          linear probing maps keys to entries.
  */
-struct mnode
+struct map
 {
-    void *obj;          /**< Underlying object.          */
-    int num_obj;        /**< Current number of this obj. */
-    struct mnode *next; /**< Next object in the map.     */
+    int size;                   /**< Current map size.                  */
+    int first;                  /**< Index of the first entry.          */
+    int capacity;               /**< Number of entries allocated.       */
+    size_t keysize;             /**< Size of keys (bytes).              */
+    struct map_return *entries; /**< Entries, in insertion order.       */
+    char *keys;                 /**< Copies of the entries' keys.       */
+    int *slots;                 /**< Hash table of entry indexes.       */
+    int nslots;                 /**< Hash table size, a power of two.   */
+    int nremoved;               /**< Slots marked as removed.           */
+    arena_tt arena;             /**< Arena, NULL for the C library.     */
 };
 
 /**
- * @brief Creates a map node.
- * 
- * @param obj Object to store in the node.
- * 
- * @returns A map node.
+ * @brief Hashes a key.
+ *
+ * @param m   Target map.
+ * @param obj Target key.
+ *
+ * @returns The home slot of the key.
  */
-static inline struct mnode *mnode_create(void *obj)
+static inline int map_hash(const struct map *m, const void *obj)
 {
-    struct mnode *node;
-    node = smalloc(sizeof(struct mnode));
+    const unsigned char *bytes = obj;
+    uint32_t h = 2166136261u;
 
-    /* Initialize map node. */
-    node->obj = obj;
-    node->num_obj = 1;
-    node->next = NULL;
+    /* FNV-1a. */
+    for ( size_t i = 0; i < m->keysize; i++ )
+        h = (h ^ bytes[i])*16777619u;
 
-    return(node);
+    return (h & (m->nslots - 1));
 }
 
 /**
- * @brief Destroys a map node.
- * 
- * @param node Target map node.
+ * @brief Looks a key up.
+ *
+ * @param m   Target map.
+ * @param obj Target key.
+ *
+ * @returns The slot holding the key, or the slot where it would be
+ * inserted if the key is not in the map.
  */
-static inline void mnode_destroy(struct mnode *node)
+static int map_lookup(const struct map *m, const void *obj)
 {
-    /* Sanity check. */
-    assert(node != NULL);
+    int free_slot = -1;
 
-    free(node);
+    for ( int s = map_hash(m, obj); ; s = (s + 1) & (m->nslots - 1) )
+    {
+        int idx = m->slots[s];
+
+        if ( idx == MAP_SLOT_EMPTY )
+            return ( (free_slot >= 0) ? free_slot : s );
+        if ( idx == MAP_SLOT_REMOVED )
+        {
+            if ( free_slot < 0 )
+                free_slot = s;
+        }
+        else if ( !memcmp(m->entries[idx].obj, obj, m->keysize) )
+            return (s);
+    }
 }
 
-/*====================================================================*
- * MAP RETURN                                                         *
- *====================================================================*/
-static inline struct map_return *map_return_create(struct mnode *node)
+/**
+ * @brief Rebuilds the hash table of a map.
+ *
+ * @param m      Target map.
+ * @param nslots New hash table size.
+ */
+static void map_rehash(struct map *m, int nslots)
 {
-    /* Sanity check. */
-    assert(node != NULL);
-    struct map_return *m_r = smalloc(sizeof(struct map_return));
-    m_r->obj = node->obj;
-    m_r->num_obj = node->num_obj;
+    /* Same size, same table. */
+    if ( (m->slots == NULL) || (nslots != m->nslots) )
+    {
+        arena_sfree(m->arena, m->slots);
+        m->slots = arena_smalloc(m->arena, nslots*sizeof(int));
+    }
+    m->nslots = nslots;
+    m->nremoved = 0;
+    for ( int s = 0; s < nslots; s++ )
+        m->slots[s] = MAP_SLOT_EMPTY;
 
-    return (m_r);
+    for ( int i = m->first; i < m->first + m->size; i++ )
+        m->slots[map_lookup(m, m->entries[i].obj)] = i;
 }
 
-/*====================================================================*
- * MAP                                                                *
- *====================================================================*/
-
 /**
- * @brief Map.
+ * @brief Makes room for one more entry at the end of a map.
+ *
+ * @details Entries freed at the front are reclaimed first; the map only
+ *          grows when it is full of live entries.
+ *
+ * @param m Target map.
  */
-struct map
+static void map_make_room(struct map *m)
 {
-    int size;                     /**< Current map size.          */
-    struct mnode head;            /**< Dummy head node.           */
-    struct mnode *tail;           /**< Tail node.                 */
-    int (*compare)(void*, void*); /**< Function to compare nodes. */
-};
+    if ( m->first + m->size < m->capacity )
+        return;
+
+    if ( m->first > 0 )
+    {
+        memmove(m->keys, m->keys + m->first*m->keysize, m->size*m->keysize);
+        memmove(m->entries, m->entries + m->first, m->size*sizeof(struct map_return));
+        m->first = 0;
+    }
+    else
+    {
+        m->capacity *= 2;
+        m->keys = arena_srealloc(m->arena, m->keys, m->capacity*m->keysize);
+        m->entries = arena_srealloc(m->arena, m->entries, m->capacity*sizeof(struct map_return));
+    }
+
+    for ( int i = 0; i < m->size; i++ )
+        m->entries[i].obj = m->keys + i*m->keysize;
+
+    /* Entries moved, so do their indexes. */
+    map_rehash(m, m->nslots);
+}
 
 /**
  * @brief Creates a map.
  * 
- * @param compare Function to compare nodes.
+ * @param keysize Size of keys (bytes).
  * 
  * @returns A map struct.
  */
-struct map *map_create(int (*compare)(void*, void*))
+struct map *map_create(size_t keysize)
+{
+    return (map_create_arena(keysize, NULL));
+}
+
+/**
+ * @brief Creates a map in an arena.
+ * 
+ * @param keysize Size of keys (bytes).
+ * @param arena   Arena, NULL for the C library.
+ * 
+ * @returns A map struct.
+ */
+struct map *map_create_arena(size_t keysize, arena_tt arena)
 {
     struct map *m;
 
-    m = smalloc(sizeof(struct map));
+    /* Sanity check. */
+    assert(keysize > 0);
+
+    m = arena_smalloc(arena, sizeof(struct map));
+    m->arena = arena;
     m->size = 0;
-    m->head.next = NULL;
-    m->tail = &m->head;
-    m->compare = compare;
+    m->first = 0;
+    m->capacity = MAP_INITIAL_CAPACITY;
+    m->keysize = keysize;
+    m->entries = arena_smalloc(arena, MAP_INITIAL_CAPACITY*sizeof(struct map_return));
+    m->keys = arena_smalloc(arena, MAP_INITIAL_CAPACITY*keysize);
+    m->slots = NULL;
+    map_rehash(m, 2*MAP_INITIAL_CAPACITY);
 
     return (m);
 }
 
+/**
+ * @brief Removes all objects from a map, keeping its memory.
+ *
+ * @param m Target map.
+ */
+void map_clear(struct map *m)
+{
+    /* Sanity check. */
+    assert(m != NULL);
+
+    m->size = 0;
+    m->first = 0;
+    m->nremoved = 0;
+    for ( int s = 0; s < m->nslots; s++ )
+        m->slots[s] = MAP_SLOT_EMPTY;
+}
+
 /**
  * @brief Returns the size of a map.
  *
@@ -130,52 +239,41 @@ bool map_empty(const struct map *m)
     return (map_size(m) == 0);
 }
 
-static inline struct mnode *map_search_node(struct map *m, int index)
-{
-    /* Sanity Check. */
-    assert(m != NULL);
-    assert(index >= 0);
-    assert(index <= m->size);
-
-    /* Get object. */
-    struct mnode *node = m->head.next;
-    for ( int i = 0; i < index; i++ )
-        node = node->next;
-
-    return (node);
-}
-
 /**
  * @brief Inserts a new object in map's queue only if it already doens't exists. If it exists, increase obj's number of appearances.
  * 
  * @param m   Target map.
- * @param obj Target object.
+ * @param obj Target object, copied into the map.
  */
-void map_insert(struct map *m, void *obj)
+void map_insert(struct map *m, const void *obj)
 {
+    int s, idx;
+
     /* Sanity check. */
     assert(m != NULL);
+    assert(obj != NULL);
 
-    int obj_index = -1;
-    for ( int i = 0; i < map_size(m); i++ )
+    s = map_lookup(m, obj);
+    if ( m->slots[s] >= 0 )
     {
-        struct mnode *node = map_search_node(m, i);
-        if ( m->compare(obj, node->obj) ) 
-        {
-            node->num_obj++;
-            obj_index = i;
-            i = map_size(m);
-        }
+        m->entries[m->slots[s]].num_obj++;
+        return;
     }
 
-
-    if ( obj_index == -1 )
-    {
-        struct mnode *node = mnode_create(obj);
-        m->tail->next = node;
-        m->tail = node;
-        m->size++;
-    }
+    /* Keep the load factor under 3/4, tombstones included. */
+    if ( 4*(m->size + m->nremoved + 1) > 3*m->nslots )
+        map_rehash(m, (2*(m->size + 1) > m->nslots) ? 2*m->nslots : m->nslots);
+    map_make_room(m);
+    s = map_lookup(m, obj);
+
+    idx = m->first + m->size;
+    m->entries[idx].obj = m->keys + idx*m->keysize;
+    m->entries[idx].num_obj = 1;
+    memcpy(m->entries[idx].obj, obj, m->keysize);
+    if ( m->slots[s] == MAP_SLOT_REMOVED )
+        m->nremoved--;
+    m->slots[s] = idx;
+    m->size++;
 }
 
 /**
@@ -187,21 +285,18 @@ void map_insert(struct map *m, void *obj)
  */
 struct map_return *map_remove(struct map *m)
 {
+    struct map_return *obj;
+
     /* Sanity check. */
     assert(m != NULL);
     assert(m->size != 0);
-    struct mnode *node;
 
-    node = m->head.next;
-    m->head.next = node->next;
+    obj = &m->entries[m->first];
+    m->slots[map_lookup(m, obj->obj)] = MAP_SLOT_REMOVED;
+    m->nremoved++;
+    m->first++;
     m->size--;
 
-    if ( m->size == 0 )
-        m->tail = &m->head;
-    
-    struct map_return *obj = map_return_create(node);
-    mnode_destroy(node);
-
     return (obj);
 }
 
@@ -218,18 +313,9 @@ struct map_return *map_peek(struct map *m, int index)
     /* Sanity Check. */
     assert(m != NULL);
     assert(index >= 0);
-    assert(index <= m->size);
-
-    /* Get object. */
-    struct mnode *node = m->head.next;
-    for ( int i = 0; i < index; i++ )
-        node = node->next;
-    
-    struct map_return *obj = map_return_create(node);
-    node = NULL;
-    free(node);
+    assert(index < m->size);
 
-    return (obj);
+    return (&m->entries[m->first + index]);
 }
 
 /**
@@ -242,45 +328,8 @@ void map_destroy(struct map *m)
     /* Sanity check. */
     assert(m != NULL);
 
-    while (!map_empty(m))
-        map_remove(m);
-    free(m);
-}
-
-/**
- * @brief Converts two objects into ulong int and check if they are equals
- * 
- * @param obj1 First object.
- * @param obj2 Second object.
- * 
- * @returns 1 if values are equals. 0 otherwise.
- */
-int map_compare_ulong_int(void *obj1, void *obj2)
-{
-    assert(obj1 != NULL);
-	assert(obj2 != NULL);
-
-	unsigned long int *a = (unsigned long int*) obj1;
-	unsigned long int *b = (unsigned long int*) obj2;
-    
-	return (a == b);
+    arena_sfree(m->arena, m->slots);
+    arena_sfree(m->arena, m->keys);
+    arena_sfree(m->arena, m->entries);
+    arena_sfree(m->arena, m);
 }
-
-/**
- * @brief Converts two objects into integers and check if they are equals
- * 
- * @param obj1 First object.
- * @param obj2 Second object.
- * 
- * @returns 1 if values are equals. 0 otherwise.
- */
-int map_compare_int(void *obj1, void *obj2)
-{
-	assert(obj1 != NULL);
-	assert(obj2 != NULL);
-
-	int *a = (int*) obj1;
-	int *b = (int*) obj2;
-
-	return (a == b);
-}
\ No newline at end of file
@@ -24,59 +24,66 @@
 #include <stdlib.h>
 
 #include <mylib/util.h>
+#include <mylib/arena.h>
 #include <mylib/queue.h>
 
 /**
- * @brief Queue node.
+ * @brief Initial queue capacity. Must be a power of two.
  */
-struct qnode
-{
-	void *obj;          /**< Underlying object.       */
-	struct qnode *next; /**< Next objet in the queue. */
-};
+#define QUEUE_INITIAL_CAPACITY 8
 
 /**
  * @brief Queue.
+ *
+ * @details Objects live in a ring buffer whose capacity is a power of
+ *          two, so that indexes wrap around with a mask. The buffer
+ *          doubles when full and never shrinks.
  */
 struct queue
 {
-	int size;           /**< Current queue size. */
-	struct qnode head;  /**< Dummy head node.    */
-	struct qnode *tail; /**< Tail node.          */
+	int size;     /**< Current queue size.           */
+	int head;     /**< Index of the first object.    */
+	int capacity; /**< Number of slots in the ring.  */
+	void **objs;  /**< Ring of objects.              */
+	arena_tt arena; /**< Arena, NULL for the C library. */
 };
 
 /*====================================================================*
- * QUEUE NODE                                                         *
+ * RING BUFFER                                                        *
  *====================================================================*/
 
 /**
- * @brief Creates a queue node.
- * 
- * @param obj Object to store in the node.
- * 
- * @returns A queue node.
+ * @brief Returns the slot of the nth object of a queue.
+ *
+ * @param q Target queue.
+ * @param n Object index.
+ *
+ * @returns The slot of the nth object.
  */
-static inline struct qnode *qnode_create(void *obj)
+static inline int queue_slot(const struct queue *q, int n)
 {
-	struct qnode *node;
-	
-	node = smalloc(sizeof(struct qnode));
-	
-	/* Initialize queue node. */
-	node->obj = obj;
-	node->next = NULL;
-	
-	return (node);
+	return ((q->head + n) & (q->capacity - 1));
 }
 
 /**
- * @brief Destroys a queue node.
- * 
- * @param node Target queue node.
+ * @brief Doubles the capacity of a queue.
+ *
+ * @param q Target queue.
  */
-static inline void qnode_destroy(struct qnode *node)
+static void queue_grow(struct queue *q)
 {
-	free(node);
+	void **objs;
+
+	objs = arena_smalloc(q->arena, 2*q->capacity*sizeof(void *));
+
+	/* Unwrap objects at the beginning of the new ring. */
+	for (int i = 0; i < q->size; i++)
+		objs[i] = q->objs[queue_slot(q, i)];
+
+	arena_sfree(q->arena, q->objs);
+	q->objs = objs;
+	q->head = 0;
+	q->capacity *= 2;
 }
 
 /*====================================================================*
@@ -89,15 +96,29 @@ static inline void qnode_destroy(struct qnode *node)
  * @returns A queue.
  */
 struct queue *queue_create(void)
+{
+	return (queue_create_arena(NULL));
+}
+
+/**
+ * @brief Creates a queue in an arena.
+ *
+ * @param arena Arena, NULL for the C library.
+ *
+ * @returns A queue.
+ */
+struct queue *queue_create_arena(arena_tt arena)
 {
 	struct queue *q;
 	
-	q = smalloc(sizeof(struct queue));
+	q = arena_smalloc(arena, sizeof(struct queue));
 	
 	/* Initialize queue. */
 	q->size = 0;
-	q->head.next = NULL;
-	q->tail = &q->head;
+	q->head = 0;
+	q->capacity = QUEUE_INITIAL_CAPACITY;
+	q->objs = arena_smalloc(arena, QUEUE_INITIAL_CAPACITY*sizeof(void *));
+	q->arena = arena;
 	
 	return (q);
 }
@@ -113,9 +134,8 @@ void queue_destroy(struct queue *q)
 	assert(q != NULL);
 	
 	/* House keeping. */
-	while (!queue_empty(q))
-		queue_remove(q);
-	free(q);
+	arena_sfree(q->arena, q->objs);
+	arena_sfree(q->arena, q);
 }
 
 /**
@@ -153,46 +173,41 @@ bool queue_empty(const struct queue *q)
  */
 void queue_insert(struct queue *q, void *obj)
 {
-	struct qnode *node;
-	
 	/* Sanity check. */
 	assert(q != NULL);
 	assert(obj != NULL);
 	
-	/* Link object. */
-	node = qnode_create(obj);
-	q->tail->next = node;
-	q->tail = node;
+	if (q->size == q->capacity)
+		queue_grow(q);
+
+	q->objs[queue_slot(q, q->size)] = obj;
 	q->size++;
 }
 
 /**
- * @brief Inserts an object in a specified position in a queue.
+ * @brief Replaces the object in a specified position in a queue.
  * 
  * @param q   Target queue.
  * @param idx Target index.
  * @param obj Target object.
+ *
+ * @returns The replaced object.
  */
 void *queue_change_elem(struct queue *q, int idx, void *obj)
 {
 	void *return_obj;
-	struct qnode *node;
+	int slot;
 
 	/* Sanity check. */
 	assert(q != NULL);
 	assert(obj != NULL);
 	assert(idx >= 0);
-	
+	assert(idx < q->size);
 
-	/* Get object. */
-	node = q->head.next;
-	for ( int i = 0; i < idx; i++ )
-	{
-		node = node->next;
-	}
+	slot = queue_slot(q, idx);
+	return_obj = q->objs[slot];
+	q->objs[slot] = obj;
 
-	return_obj = node->obj;
-	node->obj = obj;
 	return (return_obj);
 }
 
@@ -205,26 +220,16 @@ void *queue_change_elem(struct queue *q, int idx, void *obj)
  */
 void *queue_remove(struct queue *q)
 {
-	void *obj;          /* Object in the first node. */
-	struct qnode *node; /* First node.               */
+	void *obj; /* Object in the front. */
 	
 	/* Sanity check. */
 	assert(q != NULL);
 	assert(q->size != 0);
 	
-	/* Unlink node. */
-	node = q->head.next;
-	q->head.next = node->next;
+	obj = q->objs[q->head];
+	q->head = queue_slot(q, 1);
 	q->size--;
 	
-	/* Update tail node. */
-	if (q->size == 0)
-		q->tail = &q->head;
-	
-	/* Get object. */
-	obj = node->obj;
-	qnode_destroy(node);
-	
 	return (obj);
 }
 
@@ -238,24 +243,10 @@ void *queue_remove(struct queue *q)
  */
 void *queue_peek(struct queue *q, int n)
 {
-	void *obj;          /* Object in the first node. */
-	struct qnode *node; /* First node.               */
-
 	/* Sanity check. */
 	assert(q != NULL);
 	assert(n >= 0);
-	assert(n <= q->size);
-
-	/* Get object. */
-	node = q->head.next;
-	for ( int i = 0; i < n; i++ )
-	{
-		node = node->next;
-	}
-	obj = node->obj;
-	node = NULL;
-	qnode_destroy(node);
+	assert(n < q->size);
 
-
-	return (obj);
+	return (q->objs[queue_slot(q, n)]);
 }
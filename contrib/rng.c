@@ -0,0 +1,88 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <mylib/rng.h>
+
+/**
+ * @brief Seeds a random number generator.
+ *
+ * @details The state is filled with a Lehmer sequence and the first
+ *          10*RNG_DEGREE numbers are dropped, as srand() does.
+ *
+ * @param r    Target generator.
+ * @param seed Seed (zero seeds as one).
+ */
+void rng_seed(struct rng *r, unsigned int seed)
+{
+	int32_t word;
+
+	/* Sanity check. */
+	assert(r != NULL);
+
+	if (seed == 0)
+		seed = 1;
+
+	/* state[i] = (16807*state[i - 1])%RNG_MAX, without overflow. */
+	r->state[0] = word = seed;
+	for (int i = 1; i < RNG_DEGREE; i++)
+	{
+		long int hi = word/127773;
+		long int lo = word%127773;
+
+		word = 16807*lo - 2836*hi;
+		if (word < 0)
+			word += RNG_MAX;
+		r->state[i] = word;
+	}
+
+	r->front = RNG_SEPARATION;
+	r->rear = 0;
+
+	for (int i = 0; i < 10*RNG_DEGREE; i++)
+		rng_next(r);
+}
+
+/**
+ * @brief Draws the next number of a random number generator.
+ *
+ * @param r Target generator.
+ *
+ * @returns A number in [0, RNG_MAX].
+ */
+int rng_next(struct rng *r)
+{
+	uint32_t val;
+
+	/* Sanity check. */
+	assert(r != NULL);
+
+	val = (uint32_t) r->state[r->front] + (uint32_t) r->state[r->rear];
+	r->state[r->front] = val;
+
+	r->front = (r->front + 1)%RNG_DEGREE;
+	r->rear = (r->rear + 1)%RNG_DEGREE;
+
+	/* Least random bit is dropped. */
+	return (val >> 1);
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include <mylib/util.h>
+#include <mylib/sketch.h>
+
+/**
+ * @brief Initial number of buckets of a sketch.
+ */
+#define SKETCH_INITIAL_BUCKETS 64
+
+/**
+ * @brief Quantile sketch.
+ *
+ * @details Counts non-negative values in buckets whose bounds grow
+ *          geometrically, so that any quantile is estimated within a
+ *          fixed relative error in memory logarithmic in the range of
+ *          values, no matter how many values are inserted. Bucket i
+ *          counts values in (gamma^(i-1), gamma^i], and zero and
+ *          negative values have a bucket of their own.
+ */
+struct sketch
+{
+	double gamma;               /**< Ratio between bucket bounds.    */
+	double lngamma;             /**< Natural logarithm of gamma.     */
+	unsigned long int count;    /**< Number of values.               */
+	unsigned long int nzeros;   /**< Number of non-positive values.  */
+	int offset;                 /**< Index of the first bucket.      */
+	int nbuckets;               /**< Number of buckets.              */
+	unsigned long int *buckets; /**< Buckets.                        */
+};
+
+/**
+ * @brief Makes room for a bucket in a sketch.
+ *
+ * @param s   Target sketch.
+ * @param idx Index of the bucket.
+ */
+static void sketch_reserve(struct sketch *s, int idx)
+{
+	int first, last, n;
+
+	first = (idx < s->offset) ? idx : s->offset;
+	last = (idx >= s->offset + s->nbuckets) ? idx : s->offset + s->nbuckets - 1;
+
+	if ((first == s->offset) && (last < s->offset + s->nbuckets))
+		return;
+
+	/* Grow geometrically, towards the missing bucket. */
+	n = s->nbuckets;
+	while (n < last - first + 1)
+		n *= 2;
+	if (first < s->offset)
+		first = last - n + 1;
+
+	s->buckets = srealloc(s->buckets, n*sizeof(unsigned long int));
+	memmove(&s->buckets[s->offset - first], s->buckets, s->nbuckets*sizeof(unsigned long int));
+	memset(s->buckets, 0, (s->offset - first)*sizeof(unsigned long int));
+	memset(&s->buckets[s->offset - first + s->nbuckets], 0, (n - s->nbuckets - (s->offset - first))*sizeof(unsigned long int));
+
+	s->offset = first;
+	s->nbuckets = n;
+}
+
+/**
+ * @brief Creates a quantile sketch.
+ *
+ * @param accuracy Relative accuracy of estimates, in (0, 1).
+ *
+ * @returns A quantile sketch.
+ */
+struct sketch *sketch_create(double accuracy)
+{
+	struct sketch *s;
+
+	/* Sanity check. */
+	assert((accuracy > 0.0) && (accuracy < 1.0));
+
+	s = smalloc(sizeof(struct sketch));
+
+	s->gamma = (1.0 + accuracy)/(1.0 - accuracy);
+	s->lngamma = log(s->gamma);
+	s->count = 0;
+	s->nzeros = 0;
+	s->offset = 0;
+	s->nbuckets = SKETCH_INITIAL_BUCKETS;
+	s->buckets = scalloc(SKETCH_INITIAL_BUCKETS, sizeof(unsigned long int));
+
+	return (s);
+}
+
+/**
+ * @brief Destroys a quantile sketch.
+ *
+ * @param s Target sketch.
+ */
+void sketch_destroy(struct sketch *s)
+{
+	/* Sanity check. */
+	assert(s != NULL);
+
+	sfree(s->buckets);
+	sfree(s);
+}
+
+/**
+ * @brief Inserts a value in a quantile sketch.
+ *
+ * @param s     Target sketch.
+ * @param value Target value.
+ */
+void sketch_insert(struct sketch *s, double value)
+{
+	int idx;
+
+	/* Sanity check. */
+	assert(s != NULL);
+
+	s->count++;
+
+	if (!(value > 0.0))
+	{
+		s->nzeros++;
+		return;
+	}
+
+	idx = (int) ceil(log(value)/s->lngamma);
+	sketch_reserve(s, idx);
+	s->buckets[idx - s->offset]++;
+}
+
+/**
+ * @brief Returns the number of values in a quantile sketch.
+ *
+ * @param s Target sketch.
+ *
+ * @returns The number of values in the target sketch.
+ */
+unsigned long int sketch_count(const struct sketch *s)
+{
+	/* Sanity check. */
+	assert(s != NULL);
+
+	return (s->count);
+}
+
+/**
+ * @brief Estimates the value of some rank in a sketch.
+ *
+ * @param s    Target sketch.
+ * @param rank Target rank, zero for the smallest value.
+ *
+ * @returns The value of the target rank, within the accuracy of the
+ *          sketch. Zero if the sketch is empty.
+ */
+double sketch_rank(const struct sketch *s, unsigned long int rank)
+{
+	unsigned long int seen;
+
+	/* Sanity check. */
+	assert(s != NULL);
+
+	if (s->count == 0)
+		return (0.0);
+
+	if (rank > s->count - 1)
+		rank = s->count - 1;
+
+	if (rank < s->nzeros)
+		return (0.0);
+
+	seen = s->nzeros;
+	for (int i = 0; i < s->nbuckets; i++)
+	{
+		seen += s->buckets[i];
+		if (rank < seen)
+			return (2.0*pow(s->gamma, i + s->offset)/(s->gamma + 1.0));
+	}
+
+	/* Never gets here. */
+	return (0.0);
+}
+
+/**
+ * @brief Estimates a quantile of the values in a sketch.
+ *
+ * @param s Target sketch.
+ * @param q Target quantile, in [0, 1].
+ *
+ * @returns The value of rank q*(n - 1), where n is the number of
+ *          values, within the accuracy of the sketch. Zero if the
+ *          sketch is empty.
+ */
+double sketch_quantile(const struct sketch *s, double q)
+{
+	/* Sanity check. */
+	assert(s != NULL);
+	assert((q >= 0.0) && (q <= 1.0));
+
+	if (s->count == 0)
+		return (0.0);
+
+	return (sketch_rank(s, (unsigned long int) (q*(s->count - 1))));
+}
@@ -23,6 +23,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <mylib/util.h>
+
 /**
  * @brief Safe malloc().
  *
@@ -40,6 +42,53 @@ void *smalloc(size_t size)
 	return (p);
 }
 
+/**
+ * @brief Safe calloc().
+ *
+ * @param n    Number of elements to allocate.
+ * @param size Size of each element.
+ *
+ * @returns Allocated and zero-filled block of memory.
+ */
+void *scalloc(size_t n, size_t size)
+{
+	void *p;
+
+	p = calloc(n, size);
+	assert(p != NULL);
+
+	return (p);
+}
+
+/**
+ * @brief Safe realloc().
+ *
+ * @param ptr  Block of memory to resize, NULL for a new one.
+ * @param size Number of bytes to allocate.
+ *
+ * @returns Resized block of memory.
+ */
+void *srealloc(void *ptr, size_t size)
+{
+	void *p;
+
+	p = realloc(ptr, size);
+	if (p == NULL)
+		error("cannot realloc()");
+
+	return (p);
+}
+
+/**
+ * @brief Safe free().
+ *
+ * @param ptr Block of memory to release.
+ */
+void sfree(void *ptr)
+{
+	free(ptr);
+}
+
 /**
  * @brief Prints an error message and terminates.
  *
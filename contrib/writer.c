@@ -0,0 +1,189 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <mylib/util.h>
+#include <mylib/writer.h>
+
+/**
+ * @brief Writer.
+ *
+ * @details Formats text into a buffer and hands it to the underlying
+ *          stream in large chunks, so that writing many short records
+ *          costs few calls into the C library. Text that does not fit
+ *          in an empty buffer goes straight to the stream.
+ */
+struct writer
+{
+	FILE *stream;  /**< Underlying stream. */
+	char *buf;     /**< Buffer.            */
+	size_t size;   /**< Buffer size.       */
+	size_t used;   /**< Bytes buffered.    */
+};
+
+/**
+ * @brief Creates a writer.
+ *
+ * @param stream  Underlying stream.
+ * @param bufsize Buffer size (in bytes).
+ *
+ * @returns A writer.
+ */
+struct writer *writer_create(FILE *stream, size_t bufsize)
+{
+	struct writer *w;
+
+	/* Sanity check. */
+	assert(stream != NULL);
+	assert(bufsize > 0);
+
+	w = smalloc(sizeof(struct writer));
+
+	w->stream = stream;
+	w->buf = smalloc(bufsize);
+	w->size = bufsize;
+	w->used = 0;
+
+	return (w);
+}
+
+/**
+ * @brief Flushes and destroys a writer.
+ *
+ * @param w Target writer.
+ *
+ * @note The underlying stream is not closed.
+ */
+void writer_destroy(struct writer *w)
+{
+	/* Sanity check. */
+	assert(w != NULL);
+
+	writer_flush(w);
+
+	/* House keeping. */
+	sfree(w->buf);
+	sfree(w);
+}
+
+/**
+ * @brief Hands buffered text to the underlying stream.
+ *
+ * @param w Target writer.
+ */
+void writer_flush(struct writer *w)
+{
+	/* Sanity check. */
+	assert(w != NULL);
+
+	if (w->used == 0)
+		return;
+
+	if (fwrite(w->buf, 1, w->used, w->stream) != w->used)
+		error("cannot write output");
+	w->used = 0;
+	fflush(w->stream);
+}
+
+/**
+ * @brief Writes formatted text.
+ *
+ * @param w      Target writer.
+ * @param format Format string, as in printf().
+ */
+void writer_printf(struct writer *w, const char *format, ...)
+{
+	va_list ap;
+	int n;
+
+	/* Sanity check. */
+	assert(w != NULL);
+	assert(format != NULL);
+
+	va_start(ap, format);
+	n = vsnprintf(w->buf + w->used, w->size - w->used, format, ap);
+	va_end(ap);
+
+	if (n < 0)
+		error("cannot format output");
+
+	/* Fits. */
+	if ((size_t) n < w->size - w->used)
+	{
+		w->used += n;
+		return;
+	}
+
+	/* Make room, and try once more. */
+	writer_flush(w);
+	va_start(ap, format);
+	if ((size_t) n < w->size)
+		w->used = vsnprintf(w->buf, w->size, format, ap);
+	else
+		vfprintf(w->stream, format, ap);
+	va_end(ap);
+}
+
+/**
+ * @brief Writes a string.
+ *
+ * @param w Target writer.
+ * @param s Target string.
+ */
+void writer_puts(struct writer *w, const char *s)
+{
+	/* Sanity check. */
+	assert(s != NULL);
+
+	writer_write(w, s, strlen(s));
+}
+
+/**
+ * @brief Writes raw bytes.
+ *
+ * @param w Target writer.
+ * @param p Target bytes.
+ * @param n Number of bytes.
+ */
+void writer_write(struct writer *w, const void *p, size_t n)
+{
+	/* Sanity check. */
+	assert(w != NULL);
+	assert(p != NULL);
+
+	if (n > w->size - w->used)
+	{
+		writer_flush(w);
+		if (n > w->size)
+		{
+			if (fwrite(p, 1, n, w->stream) != n)
+				error("cannot write output");
+			return;
+		}
+	}
+
+	memcpy(w->buf + w->used, p, n);
+	w->used += n;
+}
@@ -0,0 +1,37 @@
+#ifndef ARCH_H_
+#define ARCH_H_
+
+    #include <stdbool.h>
+    #include <mylib/array.h>
+    #include <mylib/queue.h>
+
+    #include "cache.h"
+    #include "tlb.h"
+
+    /**
+     * @brief Opaque pointer to an architecture description.
+     */
+    typedef struct arch * arch_tt;
+
+    /**
+     * @brief Constant opaque pointer to an architecture description.
+     */
+    typedef const struct arch * const_arch_tt;
+
+    /**
+     * @name Operations on Architecture
+     */
+    /**@{*/
+    extern arch_tt  arch_create(int);
+    extern void     arch_destroy(arch_tt);
+    extern void     arch_set_core(arch_tt, int, int, int, int, int, const struct cache_policy *);
+    extern void     arch_add_level(arch_tt, int, int, int, int, bool, enum cache_inclusion, const struct cache_policy *);
+    extern void     arch_set_tlb(arch_tt, int, int, int, enum tlb_mode);
+    extern bool     arch_has_tlb(const_arch_tt);
+    extern void     arch_set_memory(arch_tt, unsigned long int, unsigned long int);
+    extern int      arch_ncores(const_arch_tt);
+    extern void     arch_memory(const_arch_tt, struct mem_geometry *);
+    extern array_tt arch_cores(const_arch_tt, int, queue_tt, arena_tt);
+    /**@}*/
+
+#endif /* ARCH_H_ */
@@ -1,10 +1,59 @@
 #ifndef CACHE_H_
 #define CACHE_H_
 
-	#include <mylib/map.h>
+	#include <mylib/counter.h>
     #include <stdbool.h>
+    #include <stdint.h>
     #include "mem.h"
 
+    /**
+     * @brief Cache replacement policy.
+     *
+     * @details Each cache set owns a single 64-bit word of replacement
+     * metadata, whose layout is private to the policy.
+     */
+    struct cache_policy
+    {
+        const char *name;                                /**< Policy name.                    */
+        bool fill_invalid;                               /**< Fill invalid ways first?        */
+        bool (*supports)(int);                           /**< Supports a number of ways?      */
+        uint64_t (*init)(int);                           /**< Initial set metadata.           */
+        void (*hit)(uint64_t *, int, int);               /**< Updates metadata on a way hit.  */
+        void (*fill)(uint64_t *, int, int, uint64_t *);  /**< Updates metadata on a way fill. */
+        int  (*victim)(uint64_t *, int, uint64_t *);     /**< Chooses a way to be replaced.   */
+    };
+
+    /**
+     * @brief Supported cache replacement policies.
+     */
+    /**@{*/
+    extern const struct cache_policy *cache_policy_fifo;
+    extern const struct cache_policy *cache_policy_lru;
+    extern const struct cache_policy *cache_policy_plru;
+    extern const struct cache_policy *cache_policy_srrip;
+    extern const struct cache_policy *cache_policy_brrip;
+    extern const struct cache_policy *cache_policy_random;
+    /**@}*/
+
+    /**
+     * @brief Inclusion policy of a cache towards its inner caches.
+     */
+    enum cache_inclusion
+    {
+        CACHE_INCLUSIVE, /**< Holds everything inner caches hold. */
+        CACHE_EXCLUSIVE  /**< Holds nothing inner caches hold.    */
+    };
+
+    /**
+     * @brief Way evicted from a cache.
+     */
+    struct cache_victim
+    {
+        bool valid;            /**< Was a way evicted?                 */
+        unsigned long int tag; /**< Evicted way's tag.                 */
+        int line;              /**< Line of evicted way's first block. */
+    };
+
     /**
 	 * @brief Opaque pointer to a cache.
 	 */
@@ -19,15 +68,20 @@
 	 * @name Operations on cache
 	 */
 	/**@{*/
-    extern cache_tt cache_create(int, int, int);
+    extern cache_tt cache_create(int, int, int, const struct cache_policy *, const struct mem_geometry *, arena_tt);
     extern void     cache_destroy(cache_tt);
     
-    extern bool cache_check_addr(const_cache_tt, mem_tt);
-    extern void cache_replace(cache_tt, mem_tt);
+    extern bool cache_check_addr(cache_tt, const_mem_tt, unsigned long int);
+    extern void cache_replace(cache_tt, const_mem_tt, unsigned long int, struct cache_victim *);
+    extern void cache_insert(cache_tt, const struct cache_victim *, struct cache_victim *);
+    extern void cache_extract(cache_tt, const_mem_tt, unsigned long int);
+    extern void cache_attach(cache_tt, cache_tt);
+    extern void cache_set_inclusion(cache_tt, enum cache_inclusion);
+    extern enum cache_inclusion cache_inclusion(const_cache_tt);
     extern int cache_num_sets(const_cache_tt);
-	extern map_tt cache_set_accesses(const_cache_tt);
+	extern counter_tt cache_set_accesses(const_cache_tt);
 	extern void cache_set_accesses_update(cache_tt, int);
-	extern map_tt cache_set_conflicts(const_cache_tt);
+	extern counter_tt cache_set_conflicts(const_cache_tt);
 	extern void cache_set_conflicts_update(cache_tt, int);
     /**@}*/
 
@@ -0,0 +1,40 @@
+#ifndef CONFIG_H_
+#define CONFIG_H_
+
+    #include <stdio.h>
+    #include <mylib/array.h>
+    #include <mylib/queue.h>
+
+    #include "arch.h"
+    #include "cache.h"
+    #include "core.h"
+    #include "mem.h"
+    #include "process.h"
+    #include "ram.h"
+    #include "scheduler.h"
+    #include "tlb.h"
+    #include "workload.h"
+
+    /**
+     * @name Simulation Configuration
+     *
+     * @details Parse command line names and input files into the
+     *          objects a simulation runs on. Unsupported names yield
+     *          NULL, malformed files are fatal errors, except for
+     *          config_arch_read(), which yields NULL instead.
+     */
+    /**@{*/
+    extern enum workload_format       config_format(const char *);
+    extern enum simsched_output       config_output(const char *);
+    extern enum trace_format          config_trace_format(const char *);
+    extern workload_tt                config_workload(const char *, enum workload_format, int, arena_tt);
+    extern const struct cache_policy *config_cache_policy(const char *);
+    extern const struct page_policy  *config_page_policy(const char *);
+    extern arch_tt                    config_arch(const char *);
+    extern arch_tt                    config_arch_read(const char *, const char **);
+    extern void                     (*config_kernel(const char *))(workload_tt);
+    extern const struct processer    *config_processer(const char *);
+    extern const struct scheduler    *config_scheduler(const char *);
+    /**@}*/
+
+#endif /* CONFIG_H_ */
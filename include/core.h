@@ -25,7 +25,7 @@
 	 * @name Operations on Core
 	 */
 	/**@{*/
-	extern core_tt core_create(int, int, int, int);
+	extern core_tt core_create(int, int, int, int, int, const struct cache_policy *, const struct mem_geometry *, arena_tt);
 	extern void core_populate(core_tt, task_tt);
 	extern int core_capacity(const_core_tt);
 	extern void core_vacate(core_tt);
@@ -42,13 +42,24 @@
 	extern unsigned long int core_hit(const_core_tt);
 	extern unsigned long int core_miss(const_core_tt);
 
-	extern bool core_mmu_translate(core_tt, task_tt, mem_tt, RAM_tt);
-	extern bool core_cache_checkaddr(const_core_tt, mem_tt);
-	extern void core_cache_replace(core_tt, mem_tt);
+	extern bool core_mmu_translate(core_tt, task_tt, mem_tt, unsigned long int, RAM_tt);
+	extern void core_set_tlb(core_tt, tlb_tt);
+	extern bool core_has_tlb(const_core_tt);
+	extern unsigned long int core_tlb_hit(const_core_tt);
+	extern unsigned long int core_tlb_miss(const_core_tt);
+	extern unsigned long int core_tlb_flushes(const_core_tt);
+	extern int core_tlb_penalty(const_core_tt);
+	extern bool core_cache_checkaddr(core_tt, const_mem_tt, unsigned long int);
+	extern void core_cache_add_level(core_tt, cache_tt, int, bool);
+	extern int core_cache_fetch(core_tt, const_mem_tt, unsigned long int, int);
+	extern int core_cache_nlevels(const_core_tt);
+	extern bool core_cache_shared(const_core_tt);
+	extern unsigned long int core_cache_level_hit(const_core_tt, int);
+	extern unsigned long int core_cache_level_miss(const_core_tt, int);
 	extern int core_cache_num_sets(const_core_tt);
-	extern map_tt core_cache_sets_accesses(const_core_tt);
+	extern counter_tt core_cache_sets_accesses(const_core_tt);
 	extern void core_cache_sets_accesses_update(core_tt, int);
-	extern map_tt core_cache_sets_conflicts(const_core_tt);
+	extern counter_tt core_cache_sets_conflicts(const_core_tt);
 	extern void core_cache_sets_conflicts_update(core_tt, int);
 	extern double core_cache_sets_variance(const_core_tt);
 
@@ -4,6 +4,7 @@
     #include <stdbool.h>
 	#include <mylib/array.h>
 	#include <mylib/queue.h>
+	#include <mylib/rng.h>
 
 	/**
 	 * @brief Opaque pointer to a KMeans Function.
@@ -19,7 +20,7 @@
 	 * @name Kmeans' operations.
 	 */
 	/**@{*/
-	extern kmeans_tt kmeans_create(int, int, int);
+	extern kmeans_tt kmeans_create(int, int, int, struct rng *);
 	extern void      kmeans_destroy(kmeans_tt);
 
     extern void kmeans_start(kmeans_tt, array_tt, queue_tt, int**, int);
@@ -1,37 +1,57 @@
 #ifndef MEM_H_
 #define MEM_H_
 
+	#include <stdbool.h>
+	#include <mylib/arena.h>
+
 	/**
 	 * @brief Memory definitions.
 	 */
 	/**@{*/
-	#define WORD_SIZE          4 /**<  4B */
-	#define BLOCK_SIZE        64 /**< 64B */
-	#define PAGE_SIZE       4096 /**< 4KB */
-	#define RAM_SIZE  4294967296 /**< 4GB */
+	#define WORD_SIZE                  4 /**<  4B                   */
+	#define BLOCK_SIZE                64 /**< 64B                   */
+	#define DEFAULT_PAGE_SIZE       4096 /**< 4KB (default)         */
+	#define DEFAULT_RAM_SIZE  4294967296 /**< 4GB (default)         */
+	#define HUGE_PAGE_SIZE       2097152 /**< 2MB (huge page)       */
 	/**@}*/
 
     /**
-	 * @brief Opaque pointer to a memory address.
+	 * @brief Opaque pointer to a sequence of memory addresses.
 	 */
 	typedef struct mem * mem_tt;
 
 	/**
-	 * @brief Constant opaque pointer to a memory address.
+	 * @brief Constant opaque pointer to a sequence of memory addresses.
 	 */
 	typedef const struct mem * const_mem_tt;
 
+	/**
+	 * @brief Memory geometry.
+	 */
+	struct mem_geometry
+	{
+		unsigned long int ram_size;  /**< Physical memory size (bytes). */
+		unsigned long int page_size; /**< Page size (bytes).            */
+		int page_shift;              /**< log2(page_size).              */
+	};
+
+	extern void mem_geometry_init(struct mem_geometry *, unsigned long int, unsigned long int);
+
 	/**
 	 * @name Operations on mem
 	 */
 	/**@{*/
-	extern mem_tt mem_create(unsigned long int);
+	extern mem_tt mem_create(unsigned long int, arena_tt);
+	extern mem_tt mem_wrap(const unsigned long int *, unsigned long int, arena_tt);
 	extern void   mem_destroy(mem_tt);
 
-    extern unsigned long int mem_virtual_addr(const_mem_tt);
-	extern void              mem_set_physical_addr(mem_tt, unsigned long int);
-    extern unsigned long int mem_physical_addr(const_mem_tt);
-    extern int               mem_addr_offset(const_mem_tt);
+	extern unsigned long int mem_size(const_mem_tt);
+	extern void              mem_set_addr(mem_tt, unsigned long int, unsigned long int);
+	extern unsigned long int mem_addr(const_mem_tt, unsigned long int);
+    extern unsigned long int mem_virtual_addr(const_mem_tt, unsigned long int, const struct mem_geometry *);
+	extern void              mem_set_physical_addr(mem_tt, unsigned long int, unsigned long int);
+    extern unsigned long int mem_physical_addr(const_mem_tt, unsigned long int);
+    extern int               mem_addr_offset(const_mem_tt, unsigned long int, const struct mem_geometry *);
     /**@}*/
 
-#endif /* MEM_H_ */
\ No newline at end of file
+#endif /* MEM_H_ */
@@ -6,6 +6,7 @@
     #include "task.h"
     #include "mem.h"
     #include "ram.h"
+    #include "tlb.h"
 
     /**
      * @brief Opaque pointer to a memory management unit (MMU)
@@ -22,7 +23,10 @@
      */
     /**@{*/
     extern mmu_tt mmu_create(int);
-    extern bool   mmu_translate(const_mmu_tt, task_tt, mem_tt, RAM_tt);
+    extern bool   mmu_translate(mmu_tt, task_tt, mem_tt, unsigned long int, RAM_tt);
+    extern void   mmu_set_tlb(mmu_tt, tlb_tt);
+    extern tlb_tt mmu_tlb(const_mmu_tt);
+    extern int    mmu_penalty(const_mmu_tt);
 
     extern void   mmu_destroy(mmu_tt);
     /**@}*/
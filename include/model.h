@@ -3,6 +3,7 @@
 
     #include <mylib/array.h>
     #include <mylib/queue.h>
+    #include <mylib/rng.h>
 
     /**
 	 * @brief Model definitions.
@@ -26,7 +27,7 @@
      * @name Operations on Model
      */
     /**@{*/
-    extern model_tt model_create(int, int, int);
+    extern model_tt model_create(int, int, int, struct rng *);
     extern void model_train(model_tt, array_tt, array_tt, queue_tt);
     extern void model_sched(model_tt, array_tt, queue_tt);
     extern void model_update_num_tasks(model_tt, int);
@@ -0,0 +1,55 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+	#include <stddef.h>
+
+	/**
+	 * @brief Opaque pointer to an arena.
+	 */
+	typedef struct arena * arena_tt;
+
+	/**
+	 * @brief Constant opaque pointer to an arena.
+	 */
+	typedef const struct arena * const_arena_tt;
+
+	/**
+	 * @name Operations on Arenas
+	 */
+	/**@{*/
+	extern arena_tt arena_create(size_t);
+	extern void arena_destroy(arena_tt);
+	extern void *arena_alloc(arena_tt, size_t);
+	extern void *arena_realloc(arena_tt, void *, size_t);
+	extern void *arena_smalloc(arena_tt, size_t);
+	extern void *arena_scalloc(arena_tt, size_t, size_t);
+	extern void *arena_srealloc(arena_tt, void *, size_t);
+	extern void arena_sfree(arena_tt, void *);
+	extern size_t arena_used(const_arena_tt);
+	extern size_t arena_size(const_arena_tt);
+	extern int arena_nslabs(const_arena_tt);
+	extern unsigned long int arena_nallocs(const_arena_tt);
+	/**@}*/
+
+#endif /* ARENA_H_ */
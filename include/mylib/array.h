@@ -22,6 +22,9 @@
 #ifndef ARRAY_H_
 #define ARRAY_H_
 
+	#include <mylib/arena.h>
+	#include <mylib/rng.h>
+
 	/**
 	 * @brief Opaque pointer to an array.
 	 */
@@ -37,11 +40,12 @@
 	 */
 	/**@{*/
 	extern array_tt array_create(unsigned long int);
+	extern array_tt array_create_arena(unsigned long int, arena_tt);
 	extern void array_destroy(array_tt);
 	extern unsigned long int array_size(const_array_tt);
 	extern void array_set(array_tt, unsigned long int, void *);
 	extern void *array_get(const_array_tt, unsigned long int);
-	extern void array_shuffle(array_tt);
+	extern void array_shuffle(array_tt, struct rng *);
 	/**@}*/
 
 #endif /* ARRAY_H_ */
@@ -0,0 +1,49 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#ifndef COUNTER_H_
+#define COUNTER_H_
+
+	/**
+	 * @brief Opaque pointer to a counter.
+	 */
+	typedef struct counter * counter_tt;
+
+	/**
+	 * @brief Constant pointer to a counter.
+	 */
+	typedef const struct counter * const_counter_tt;
+
+	/**
+	 * @name Operations on Counters
+	 */
+	/**@{*/
+	extern counter_tt counter_create(int);
+	extern void counter_destroy(counter_tt);
+	extern void counter_clear(counter_tt);
+	extern void counter_increment(counter_tt, int);
+	extern int counter_get(const_counter_tt, int);
+	extern int counter_size(const_counter_tt);
+	extern int counter_key(const_counter_tt, int);
+	extern int counter_total(const_counter_tt);
+	/**@}*/
+
+#endif /* COUNTER_H_ */
@@ -0,0 +1,53 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#ifndef HEAP_H_
+#define HEAP_H_
+
+	#include <stdbool.h>
+
+	/**
+	 * @brief Opaque pointer to a heap.
+	 */
+	typedef struct heap * heap_tt;
+
+	/**
+	 * @brief Constant opaque pointer to a heap.
+	 */
+	typedef const struct heap * const_heap_tt;
+
+	/**
+	 * @name Operations on Heaps
+	 */
+	/**@{*/
+	extern heap_tt heap_create(void);
+	extern void heap_destroy(heap_tt);
+	extern int heap_size(const_heap_tt);
+	extern bool heap_empty(const_heap_tt);
+	extern int heap_insert(heap_tt, void *, long int);
+	extern void *heap_remove(heap_tt);
+	extern void *heap_peek(const_heap_tt);
+	extern long int heap_next_key(const_heap_tt);
+	extern long int heap_key(const_heap_tt, int);
+	extern void heap_decrease_key(heap_tt, int, long int);
+	/**@}*/
+
+#endif /* HEAP_H_ */
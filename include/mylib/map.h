@@ -2,9 +2,15 @@
 #define MAP_H_
 
     #include <stdbool.h>
+    #include <stddef.h>
+
+    #include <mylib/arena.h>
 
     /**
      * @brief Map's return struct.
+     *
+     * @details Returned structs belong to the map and stay valid until
+     *          the next insertion into it.
      */
     struct map_return
     {
@@ -25,16 +31,15 @@
     /**
      * @name Operations on Map
      */
-    extern map_tt map_create(int(*compare)(void*,void*));
+    extern map_tt map_create(size_t);
+    extern map_tt map_create_arena(size_t, arena_tt);
     extern void map_destroy(map_tt);
+    extern void map_clear(map_tt);
     extern int map_size(const_map_tt);
     extern bool map_empty(const_map_tt);
 
-    extern void map_insert(map_tt, void*);
+    extern void map_insert(map_tt, const void*);
     extern struct map_return *map_remove(map_tt);
     extern struct map_return *map_peek(map_tt, int);
 
-    extern int map_compare_int(void*, void*);
-    extern int map_compare_ulong_int(void*, void*);
-
-#endif /* MAP_H_ */
\ No newline at end of file
+#endif /* MAP_H_ */
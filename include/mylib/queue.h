@@ -24,6 +24,8 @@
 
 	#include <stdbool.h>
 
+	#include <mylib/arena.h>
+
 	/**
 	 * @brief Opaque pointer to a queue.
 	 */
@@ -39,6 +41,7 @@
 	 */
 	/**@{*/
 	extern queue_tt queue_create(void);
+	extern queue_tt queue_create_arena(arena_tt);
 	extern void queue_destroy(queue_tt);
 	extern int queue_size(const_queue_tt);
 	extern bool queue_empty(const_queue_tt);
@@ -0,0 +1,65 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#ifndef RNG_H_
+#define RNG_H_
+
+	#include <stdint.h>
+
+	/**
+	 * @brief Degree of the additive feedback generator.
+	 */
+	#define RNG_DEGREE 31
+
+	/**
+	 * @brief Separation between the front and rear taps.
+	 */
+	#define RNG_SEPARATION 3
+
+	/**
+	 * @brief Largest number a generator draws.
+	 */
+	#define RNG_MAX 2147483647
+
+	/**
+	 * @brief Random number generator.
+	 *
+	 * @details Draws the same sequence as the GNU C library's srand() and
+	 *          rand(), from state of its own, so that callers may own
+	 *          independent sequences. It is kept in the open so that it
+	 *          may be embedded into other structures.
+	 */
+	struct rng
+	{
+		int32_t state[RNG_DEGREE]; /**< Additive feedback state. */
+		int front;                 /**< Front tap.               */
+		int rear;                  /**< Rear tap.                */
+	};
+
+	/**
+	 * @name Operations on Random Number Generators
+	 */
+	/**@{*/
+	extern void rng_seed(struct rng *, unsigned int);
+	extern int rng_next(struct rng *);
+	/**@}*/
+
+#endif /* RNG_H_ */
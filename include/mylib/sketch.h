@@ -0,0 +1,47 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#ifndef SKETCH_H_
+#define SKETCH_H_
+
+	/**
+	 * @brief Opaque pointer to a quantile sketch.
+	 */
+	typedef struct sketch * sketch_tt;
+
+	/**
+	 * @brief Constant opaque pointer to a quantile sketch.
+	 */
+	typedef const struct sketch * const_sketch_tt;
+
+	/**
+	 * @name Operations on Quantile Sketches
+	 */
+	/**@{*/
+	extern sketch_tt sketch_create(double);
+	extern void sketch_destroy(sketch_tt);
+	extern void sketch_insert(sketch_tt, double);
+	extern unsigned long int sketch_count(const_sketch_tt);
+	extern double sketch_rank(const_sketch_tt, unsigned long int);
+	extern double sketch_quantile(const_sketch_tt, double);
+	/**@}*/
+
+#endif /* SKETCH_H_ */
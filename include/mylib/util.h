@@ -26,5 +26,8 @@
 
 	/* Forward definitions. */
 	extern void *smalloc(size_t);
+	extern void *scalloc(size_t, size_t);
+	extern void *srealloc(void *, size_t);
+	extern void sfree(void *);
 	extern void error(const char *);
 #endif /* UTIL_H_ */
@@ -0,0 +1,44 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of MyLib.
+ *
+ * MyLib is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * MyLib is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with MyLib; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#ifndef WRITER_H_
+#define WRITER_H_
+
+	#include <stdio.h>
+
+	/**
+	 * @brief Opaque pointer to a writer.
+	 */
+	typedef struct writer * writer_tt;
+
+	/**
+	 * @name Operations on Writers
+	 */
+	/**@{*/
+	extern writer_tt writer_create(FILE *, size_t);
+	extern void writer_destroy(writer_tt);
+	extern void writer_printf(writer_tt, const char *, ...);
+	extern void writer_puts(writer_tt, const char *);
+	extern void writer_write(writer_tt, const void *, size_t);
+	extern void writer_flush(writer_tt);
+	/**@}*/
+
+#endif /* WRITER_H_ */
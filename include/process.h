@@ -6,6 +6,7 @@
 
     #include "core.h"
     #include "ram.h"
+    #include "simulation.h"
     #include "workload.h"
 
     /**
@@ -13,7 +14,7 @@
 	 */
 	/**@{*/
     #define QUANTUM              10000 /**< Round-Robin Quantum (cycles). */
-	#define MISS_PENALTY           500 /**< Cache miss penalty (cycles).  */
+	#define MISS_PENALTY           500 /**< LLC miss penalty (cycles).    */
     #define PAGE_FAULT_PENALTY    5000 /**< Page fault penalty (cycles).  */
 	/**@}*/
 
@@ -22,9 +23,9 @@
     */
     struct processer
     {
-        void (*init)(workload_tt, array_tt, int*, RAM_tt); /**< Initialize processer. */
-        void (*process)(void);                             /**< Process.              */
-        void (*end)(void);                                 /**< End processer.        */
+        void (*init)(struct simulation *);    /**< Initialize processer. */
+        void (*process)(struct simulation *); /**< Process.              */
+        void (*end)(struct simulation *);     /**< End processer.        */
     };
 
 
@@ -35,6 +36,8 @@
     extern const struct processer *non_preemptive;
     extern const struct processer *random_preemptive;
     extern const struct processer *rr_preemptive;
+    extern const struct processer *exp_preemptive;
+    extern const struct processer *adaptive_preemptive;
     /**@}*/
 
 #endif /* PROCESS_H_ */
\ No newline at end of file
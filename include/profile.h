@@ -0,0 +1,79 @@
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+    #include <stdint.h>
+    #include <stdio.h>
+
+    /**
+     * @file
+     *
+     * @brief Self-profiling of the simulator.
+     *
+     * @details Timers are only compiled in when PROFILE is defined
+     *          (make PROFILE=1). Otherwise, the macros below expand to
+     *          nothing and cost nothing.
+     */
+
+    /**
+     * @brief Profiled phases of a simulation.
+     */
+    enum profile_phase
+    {
+        PROFILE_SIMULATION, /**< Whole simulation.                     */
+        PROFILE_ARRIVAL,    /**< Checking task arrivals.               */
+        PROFILE_GROUPING,   /**< Grouping tasks into queues.           */
+        PROFILE_MODEL,      /**< Q-learning model.                     */
+        PROFILE_SCHEDULE,   /**< Scheduling tasks to cores.            */
+        PROFILE_PROCESS,    /**< Processing tasks on cores.            */
+        PROFILE_MMU,        /**< Translating addresses, of all cores.  */
+        PROFILE_CACHE,      /**< Checking caches, of all cores.        */
+        PROFILE_REPORT,     /**< Reporting statistics.                 */
+        PROFILE_NPHASES     /**< Number of phases.                     */
+    };
+
+    /**
+     * @brief Time accumulated by a timer.
+     */
+    struct profile_timer
+    {
+        uint64_t ns;             /**< Elapsed time (in nanoseconds). */
+        unsigned long int calls; /**< Number of timed calls.         */
+    };
+
+    /**
+     * @name Profiling
+     */
+    /**@{*/
+    extern uint64_t profile_now(void);
+    extern void     profile_merge(struct profile_timer *, enum profile_phase, const struct profile_timer *);
+    extern void     profile_print(const struct profile_timer *, FILE *);
+    /**@}*/
+
+    #ifdef PROFILE
+
+        /**
+         * @brief Starts a scoped timer named t0.
+         */
+        #define PROFILE_START(t0) uint64_t t0 = profile_now()
+
+        /**
+         * @brief Stops timer t0 into a local profile timer.
+         */
+        #define PROFILE_STOP(t0, timer) \
+            ((timer).ns += profile_now() - (t0), (timer).calls++)
+
+        /**
+         * @brief Stops timer t0 into a phase of a table of phases.
+         */
+        #define PROFILE_PHASE(t0, phases, phase) \
+            profile_merge((phases), (phase), &(struct profile_timer) { profile_now() - (t0), 1 })
+
+    #else
+
+        #define PROFILE_START(t0) ((void) 0)
+        #define PROFILE_STOP(t0, timer) ((void) 0)
+        #define PROFILE_PHASE(t0, phases, phase) ((void) 0)
+
+    #endif
+
+#endif /* PROFILE_H_ */
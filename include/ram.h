@@ -16,14 +16,44 @@
      */
     typedef const struct RAM * const_RAM_tt;
 
+    /**
+     * @name Page replacement parameters
+     */
+    /**@{*/
+    #define RAM_LRU_SAMPLES    8 /**< Frames sampled by approximate LRU.          */
+    #define RAM_WS_WINDOW   1024 /**< Working-set window (references of a task). */
+    /**@}*/
+
+    /**
+     * @brief Page replacement policy.
+     */
+    struct page_policy;
+
+    /**
+     * @name Page replacement policies
+     */
+    /**@{*/
+    extern const struct page_policy *page_policy_fifo;
+    extern const struct page_policy *page_policy_clock;
+    extern const struct page_policy *page_policy_lru;
+    extern const struct page_policy *page_policy_ws;
+    extern const char *page_policy_name(const struct page_policy *);
+    /**@}*/
+
     /**
      * @name Operations on RAM
      */
     /**@{*/
-    extern RAM_tt            RAM_init(workload_tt);
-    extern unsigned long int RAM_num_frames(const_RAM_tt);
-    extern unsigned long int RAM_next_frame(RAM_tt, int);
-    extern void              RAM_destroy(RAM_tt);
+    extern RAM_tt                    RAM_init(workload_tt, const struct mem_geometry *, const struct page_policy *, arena_tt);
+    extern const struct mem_geometry *RAM_geometry(const_RAM_tt);
+    extern unsigned long int         RAM_num_frames(const_RAM_tt);
+    extern const struct page_policy *RAM_policy(const_RAM_tt);
+    extern bool                      RAM_ordered(const_RAM_tt);
+    extern unsigned long int         RAM_faults(const_RAM_tt);
+    extern unsigned long int         RAM_evictions(const_RAM_tt);
+    extern void                      RAM_reference(RAM_tt, int, unsigned long int);
+    extern unsigned long int         RAM_next_frame(RAM_tt, int, int);
+    extern void                      RAM_destroy(RAM_tt);
     /**@}*/
 
 
@@ -1,6 +1,8 @@
 #ifndef SCHED_ITR
 #define SCHED_ITR
 
+	#include <mylib/arena.h>
+
     /**
 	 * @brief Opaque pointer to a scheduler iteration.
 	 */
@@ -15,7 +17,7 @@
 	 * @name Operations on sched_itr
 	 */
 	/**@{*/
-	extern sched_itr_tt scheditr_create(unsigned long int, int);
+	extern sched_itr_tt scheditr_create(unsigned long int, int, arena_tt);
 	extern void scheditr_destroy(sched_itr_tt);
 	extern void scheditr_set_pmiss(sched_itr_tt, int);
 
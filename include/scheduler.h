@@ -7,16 +7,19 @@
 
     #include "workload.h"
     #include "process.h"
+    #include "profile.h"
+    #include "simulation.h"
+    #include "simsched.h"
 
     /**
      * @brief Task scheduling strategy.
     */
     struct scheduler
     {
-        bool pincores;                    /**< Pin Cores?            */
-        void (*init)(workload_tt, int);   /**< Initialize scheduler. */
-        int  (*sched)(core_tt, queue_tt); /**< Schedule.             */
-        void (*end)(void);                /**< End scheduler.        */
+        bool pincores;                                         /**< Pin Cores?            */
+        void (*init)(struct simulation *);                     /**< Initialize scheduler. */
+        int  (*sched)(struct simulation *, core_tt, queue_tt); /**< Schedule.             */
+        void (*end)(struct simulation *);                      /**< End scheduler.        */
     };
 
 
@@ -29,8 +32,35 @@
     extern const struct scheduler *sched_sca;
     /**@}*/
 
-    /* Forward definitions. */
-    extern int g_iterator;
+    /**
+     * @brief Formats of simulation statistics.
+     */
+    enum simsched_output
+    {
+        OUTPUT_TEXT, /**< Human-readable text (default).          */
+        OUTPUT_CSV,  /**< Comma-separated values, kind per record. */
+        OUTPUT_JSON  /**< A single JSON object.                    */
+    };
+
+    /**
+     * @brief Maximum number of reported percentiles.
+     */
+    #define REPORT_MAX_PERCENTILES 8
+
+    /**
+     * @brief How to report simulation statistics.
+     */
+    struct report
+    {
+        FILE *out;                                  /**< Where to print statistics.          */
+        enum simsched_output format;                /**< Format of printed statistics.       */
+        int npercentiles;                           /**< Number of reported percentiles.     */
+        double percentiles[REPORT_MAX_PERCENTILES]; /**< Reported percentiles, in (0, 100].  */
+        bool sketch;                                /**< Estimate percentiles with a sketch? */
+        FILE *trace;                                /**< Where to trace time slices, if any. */
+        enum trace_format traceformat;              /**< Trace file format.                  */
+        struct profile_timer *profile;              /**< Where to store phase times, if any. */
+    };
 
-    extern void simsched(workload_tt, array_tt, const struct scheduler*, const struct processer*, int, int, int);
+    extern void simsched(workload_tt, array_tt, const struct mem_geometry*, const struct scheduler*, const struct processer*, const struct page_policy*, int, int, int, int, int, arena_tt, const struct report*, struct simstats*);
 #endif /* SCHEDULER_H_ */
\ No newline at end of file
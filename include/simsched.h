@@ -0,0 +1,125 @@
+#ifndef SIMSCHED_H_
+#define SIMSCHED_H_
+
+    /**
+     * @file
+     *
+     * @brief libsimsched: runs loop scheduling simulations in-process.
+     *
+     * @details Workloads and architectures are described once, then any
+     *          number of simulations may be run on them. Each run builds
+     *          fresh tasks and cores from the descriptions, so these are
+     *          never modified. Nothing is printed.
+     *
+     *          Runs share no mutable state, so they may overlap in time,
+     *          e.g. on several threads, even on the same descriptions.
+     *          Each run draws random numbers from its own sequence, the
+     *          one srand() and rand() would draw from its seed, and may
+     *          itself simulate cores on several threads.
+     *
+     *          Functions that take names or files return NULL or -1 when
+     *          a name is not supported, or a file cannot be read or is
+     *          malformed. Only running out of memory is a fatal error.
+     */
+
+    /**
+     * @brief Version of this interface.
+     */
+    #define SIMSCHED_API_VERSION 1
+
+    /**
+     * @brief Summary statistics of a simulation.
+     */
+    struct simstats
+    {
+        unsigned long int waiting_sum;          /**< Sum of tasks' waiting times.      */
+        unsigned long int waiting_p99;          /**< 99th percentile waiting time.     */
+        double slowdown_p99;                    /**< 99th percentile task slowdown.    */
+        unsigned long int page_hits;            /**< Page hits.                        */
+        unsigned long int page_faults;          /**< Page faults.                      */
+        unsigned long int evictions;            /**< Page evictions.                   */
+        unsigned long int cache_hits;           /**< First level cache hits.           */
+        unsigned long int cache_misses;         /**< First level cache misses.         */
+        unsigned long int tlb_hits;             /**< TLB hits.                         */
+        unsigned long int tlb_misses;           /**< TLB misses.                       */
+        unsigned long int workload_unbalance;   /**< Workload unbalancement.           */
+        int ntasks_unbalance;                   /**< Number of tasks unbalancement.    */
+        int cachemiss_unbalance;                /**< Cache miss unbalancement.         */
+        unsigned long int time;                 /**< Makespan.                         */
+        unsigned long int cost;                 /**< Makespan times number of cores.   */
+        unsigned long int performance;          /**< Total work over makespan.         */
+        unsigned long int total;                /**< Total work.                       */
+        double cov;                             /**< Coefficient of variation of load. */
+        double slowdown;                        /**< Max over min core load.           */
+    };
+
+    /**
+     * @brief Simulation parameters.
+     */
+    struct simsched_params
+    {
+        const char *scheduler; /**< Loop scheduling strategy (fcfs, srtf or sca).  */
+        const char *processer; /**< Core processing strategy (e.g. rr-preemptive). */
+        const char *paging;    /**< Page replacement policy (e.g. fifo).           */
+        const char *kernel;    /**< Kernel complexity (e.g. linear).               */
+        int ncores;            /**< Working cores, the first ones of the arch.     */
+        int batchsize;         /**< Scheduling batch size.                         */
+        int winsize;           /**< Memory accesses window size.                   */
+        int optimize;          /**< Scheduling optimization (0 to 3).              */
+        int seed;              /**< Seed.                                          */
+        int nthreads;          /**< Threads simulating cores.                      */
+    };
+
+    /**
+     * @brief Opaque pointer to a workload description.
+     */
+    typedef struct simsched_workload * simsched_workload_tt;
+
+    /**
+     * @brief Constant opaque pointer to a workload description.
+     */
+    typedef const struct simsched_workload * const_simsched_workload_tt;
+
+    /**
+     * @brief Opaque pointer to an architecture description.
+     */
+    typedef struct simsched_arch * simsched_arch_tt;
+
+    /**
+     * @brief Constant opaque pointer to an architecture description.
+     */
+    typedef const struct simsched_arch * const_simsched_arch_tt;
+
+    /**
+     * @name Workloads
+     */
+    /**@{*/
+    extern simsched_workload_tt simsched_workload_create(int);
+    extern int                  simsched_workload_set_task(simsched_workload_tt, int, int, int, unsigned long int, const unsigned long int *);
+    extern simsched_workload_tt simsched_workload_load(const char *);
+    extern int                  simsched_workload_ntasks(const_simsched_workload_tt);
+    extern void                 simsched_workload_destroy(simsched_workload_tt);
+    /**@}*/
+
+    /**
+     * @name Architectures
+     */
+    /**@{*/
+    extern simsched_arch_tt simsched_arch_create(int, int, int, int, int, const char *);
+    extern int              simsched_arch_add_cache(simsched_arch_tt, int, int, int, int, int, int, const char *);
+    extern int              simsched_arch_set_tlb(simsched_arch_tt, int, int, int, int);
+    extern int              simsched_arch_set_memory(simsched_arch_tt, unsigned long int, unsigned long int);
+    extern simsched_arch_tt simsched_arch_load(const char *);
+    extern int              simsched_arch_ncores(const_simsched_arch_tt);
+    extern void             simsched_arch_destroy(simsched_arch_tt);
+    /**@}*/
+
+    /**
+     * @name Simulations
+     */
+    /**@{*/
+    extern void simsched_params_init(struct simsched_params *);
+    extern int  simsched_run(const_simsched_workload_tt, const_simsched_arch_tt, const struct simsched_params *, struct simstats *);
+    /**@}*/
+
+#endif /* SIMSCHED_H_ */
@@ -0,0 +1,42 @@
+#ifndef SIMULATION_H_
+#define SIMULATION_H_
+
+    #include <mylib/arena.h>
+    #include <mylib/array.h>
+    #include <mylib/queue.h>
+    #include <mylib/rng.h>
+    #include <mylib/sketch.h>
+
+    #include "profile.h"
+    #include "ram.h"
+    #include "trace.h"
+    #include "workload.h"
+
+    /**
+     * @brief State of a simulation.
+     *
+     * @details Everything a simulation mutates lives here, so that several
+     *          simulations may run, one after another or at once, in the
+     *          same process.
+     */
+    struct simulation
+    {
+        int clock;                                     /**< Global iterator, i.e. simulated time.          */
+        workload_tt workload;                          /**< Workload.                                      */
+        array_tt cores;                                /**< Working cores.                                 */
+        RAM_tt RAM;                                    /**< Simulation's RAM.                              */
+        int batchsize;                                 /**< Scheduling batch size.                         */
+        int nthreads;                                  /**< Threads simulating cores.                      */
+        queue_tt ready;                                /**< Ready cores.                                   */
+        queue_tt processing;                           /**< Processing cores.                              */
+        void *processdata;                             /**< Processing strategy's private data.            */
+        trace_tt trace;                                /**< Trace of time slices (may be NULL).            */
+        struct rng rng;                                /**< Random sequence, as srand()/rand() draw it.    */
+        arena_tt arena;                                /**< Arena of run objects (may be NULL).            */
+        unsigned long int waiting_sum;                 /**< Waiting time of finished tasks.                */
+        sketch_tt waiting;                             /**< Waiting times of finished tasks (may be NULL). */
+        sketch_tt slowdown;                            /**< Slowdowns of finished tasks (may be NULL).     */
+        struct profile_timer profile[PROFILE_NPHASES]; /**< Time spent in each phase.                      */
+    };
+
+#endif /* SIMULATION_H_ */
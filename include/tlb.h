@@ -0,0 +1,41 @@
+#ifndef TLB_H_
+#define TLB_H_
+
+    #include <stdbool.h>
+
+    /**
+     * @brief How a TLB copes with address space switches.
+     */
+    enum tlb_mode
+    {
+        TLB_ASID, /**< Entries are tagged with the task's ASID.          */
+        TLB_FLUSH /**< Every entry is dropped when another task runs.    */
+    };
+
+    /**
+     * @brief Opaque pointer to a translation lookaside buffer (TLB).
+     */
+    typedef struct tlb * tlb_tt;
+
+    /**
+     * @brief Constant opaque pointer to a translation lookaside buffer (TLB).
+     */
+    typedef const struct tlb * const_tlb_tt;
+
+    /**
+     * @name Operations on TLB
+     */
+    /**@{*/
+    extern tlb_tt            tlb_create(int, int, int, enum tlb_mode);
+    extern bool              tlb_access(tlb_tt, int, unsigned long int, unsigned long int);
+    extern void              tlb_invalidate(tlb_tt, int, unsigned long int);
+    extern void              tlb_flush(tlb_tt);
+    extern int               tlb_latency(const_tlb_tt);
+    extern enum tlb_mode     tlb_mode(const_tlb_tt);
+    extern unsigned long int tlb_hits(const_tlb_tt);
+    extern unsigned long int tlb_misses(const_tlb_tt);
+    extern unsigned long int tlb_flushes(const_tlb_tt);
+    extern void              tlb_destroy(tlb_tt);
+    /**@}*/
+
+#endif /* TLB_H_ */
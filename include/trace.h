@@ -0,0 +1,49 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+    #include <stdio.h>
+    #include <mylib/array.h>
+
+    /**
+     * @brief Trace file formats.
+     */
+    enum trace_format
+    {
+        TRACE_JSON,  /**< Chrome trace events, also read by Perfetto. */
+        TRACE_BINARY /**< Fixed-size binary records.                  */
+    };
+
+    /**
+     * @brief Version of the binary trace format.
+     */
+    #define TRACE_VERSION 1
+
+    /**
+     * @brief Time slice of a task on a core.
+     */
+    struct slice
+    {
+        int id;                   /**< Task's real ID.       */
+        int tsid;                 /**< Task ID.              */
+        long int start;           /**< Start time (cycles).  */
+        long int end;             /**< End time (cycles).    */
+        unsigned long int hits;   /**< Cache hits.           */
+        unsigned long int misses; /**< Cache misses.         */
+        unsigned long int faults; /**< Page faults.          */
+    };
+
+    /**
+     * @brief Opaque pointer to a trace.
+     */
+    typedef struct trace * trace_tt;
+
+    /**
+     * @name Operations on Traces
+     */
+    /**@{*/
+    extern trace_tt trace_create(FILE *, enum trace_format, array_tt);
+    extern void     trace_destroy(trace_tt);
+    extern void     trace_slice(trace_tt, int, const struct slice *);
+    /**@}*/
+
+#endif /* TRACE_H_ */
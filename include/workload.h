@@ -51,6 +51,16 @@
 		WORKLOAD_REMAINING_WORK /**< Remaining workload order. */
 	};
 
+	/**
+	 * @brief Workload file formats.
+	 */
+	enum workload_format
+	{
+		WORKLOAD_TEXT,   /**< Plain text, one task per line.  */
+		WORKLOAD_BINARY, /**< Memory-mappable binary.         */
+		WORKLOAD_AUTO    /**< Detected from the file (input). */
+	};
+
 	/**
 	 * @brief Workload skewness types.
 	 */
@@ -65,12 +75,16 @@
 	 */
 	/**@{*/
 	extern workload_tt workload_create(histogram_tt, histogram_tt, int, int, int);
+	extern workload_tt workload_alloc(int, int, arena_tt);
 	extern void workload_destroy(workload_tt);
 	extern int workload_ntasks(const_workload_tt);
 	extern void workload_sort(workload_tt, enum workload_sorting);
 	extern int *workload_sortmap(workload_tt);
 	extern void workload_write(FILE *, workload_tt);
-	extern workload_tt workload_read(FILE *, int);
+	extern workload_tt workload_read(FILE *, int, arena_tt, const char **);
+	extern void workload_write_binary(FILE *, workload_tt);
+	extern workload_tt workload_read_binary(FILE *, int, arena_tt, const char **);
+	extern enum workload_format workload_detect_format(FILE *);
 	
 	extern void workload_set_task(workload_tt, int, task_tt);
 	extern queue_tt workload_tasks(const_workload_tt);
@@ -79,6 +93,7 @@
 	extern void workload_set_arrtask(workload_tt, task_tt, int);
 	extern array_tt workload_arrtasks(const_workload_tt);
 	extern void workload_checktasks(workload_tt, int);
+	extern int workload_next_arrival(const_workload_tt);
 
 	extern void workload_set_fintask(workload_tt, task_tt);
 	extern queue_tt workload_fintasks (const_workload_tt);
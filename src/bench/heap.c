@@ -0,0 +1,132 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Scheduler.
+ *
+ * Scheduler is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * Scheduler is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Scheduler; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <mylib/util.h>
+#include <mylib/dqueue.h>
+#include <mylib/heap.h>
+
+/**
+ * @brief Number of benchmarked queue sizes.
+ */
+#define NSIZES 5
+
+/**
+ * @brief Smallest benchmarked queue size.
+ */
+#define MIN_SIZE 256
+
+/**
+ * @brief Number of hold operations on each size.
+ */
+#define NHOLDS (256*1024)
+
+/**
+ * @brief Largest distance to a newly scheduled event.
+ */
+#define MAX_DELAY 1000
+
+/**
+ * @brief Returns the seconds elapsed since a given moment.
+ *
+ * @param start Starting moment.
+ *
+ * @returns Elapsed seconds.
+ */
+static double elapsed(clock_t start)
+{
+	return (((double) (clock() - start)) / CLOCKS_PER_SEC);
+}
+
+/**
+ * @brief Benchmarks the delta queue against MyLib's heap.
+ *
+ * @details Uses the classic hold model of event-driven simulation: a
+ *          queue holding a given number of events repeatedly releases
+ *          its next event and schedules a new one at a random distance
+ *          from it. Both queues see the same distances.
+ */
+int main(void)
+{
+	static char obj;
+	int *delays;
+	unsigned long int checksum = 0;
+
+	srand(0);
+	delays = smalloc((MIN_SIZE << (NSIZES - 1))*sizeof(int) + NHOLDS*sizeof(int));
+	for (int i = 0; i < (MIN_SIZE << (NSIZES - 1)) + NHOLDS; i++)
+		delays[i] = rand() % MAX_DELAY;
+
+	printf("%8s %16s %16s\n", "size", "dqueue ns/hold", "heap ns/hold");
+	for (int i = 0; i < NSIZES; i++)
+	{
+		int size = MIN_SIZE << i;
+		double tdqueue, theap;
+		dqueue_tt dq;
+		heap_tt h;
+		clock_t start;
+		long int now;
+
+		dq = dqueue_create();
+		h = heap_create();
+		for (int j = 0; j < size; j++)
+		{
+			dqueue_insert(dq, &obj, delays[j]);
+			heap_insert(h, &obj, delays[j]);
+		}
+
+		/* Delta queue counters are relative to the front. */
+		start = clock();
+		for (int j = 0; j < NHOLDS; j++)
+		{
+			checksum += dqueue_next_counter(dq);
+			dqueue_remove(dq);
+			dqueue_insert(dq, &obj, delays[size + j]);
+		}
+		tdqueue = elapsed(start);
+
+		/* Heap keys are absolute. */
+		start = clock();
+		for (int j = 0; j < NHOLDS; j++)
+		{
+			now = heap_next_key(h);
+			checksum += now;
+			heap_remove(h);
+			heap_insert(h, &obj, now + delays[size + j]);
+		}
+		theap = elapsed(start);
+
+		printf("%8d %16.1f %16.1f\n", size, tdqueue*1e9/NHOLDS, theap*1e9/NHOLDS);
+
+		dqueue_destroy(dq);
+		heap_destroy(h);
+	}
+
+	/* Keep results from being optimized away. */
+	fprintf(stderr, "checksum: %lu\n", checksum);
+
+	sfree(delays);
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Scheduler.
+ *
+ * Scheduler is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * Scheduler is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Scheduler; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <mylib/util.h>
+#include <mylib/queue.h>
+
+/**
+ * @brief Number of benchmarked queue sizes.
+ */
+#define NSIZES 5
+
+/**
+ * @brief Smallest benchmarked queue size.
+ */
+#define MIN_SIZE 1024
+
+/**
+ * @brief Number of objects pushed through the queue on each size.
+ */
+#define NOPERATIONS (4*1024*1024)
+
+/*============================================================================*
+ * LINKED LIST                                                                *
+ *============================================================================*/
+
+/**
+ * @brief List node, as in the former linked-list queue.
+ */
+struct lnode
+{
+	void *obj;          /**< Underlying object. */
+	struct lnode *next; /**< Next node.         */
+};
+
+/**
+ * @brief Linked-list queue, as MyLib's queue used to be.
+ */
+struct list
+{
+	int size;           /**< Current size.    */
+	struct lnode head;  /**< Dummy head node. */
+	struct lnode *tail; /**< Tail node.       */
+};
+
+/**
+ * @brief Initializes a list.
+ *
+ * @param l Target list.
+ */
+static void list_init(struct list *l)
+{
+	l->size = 0;
+	l->head.next = NULL;
+	l->tail = &l->head;
+}
+
+/**
+ * @brief Appends an object to a list.
+ *
+ * @param l   Target list.
+ * @param obj Target object.
+ */
+static void list_insert(struct list *l, void *obj)
+{
+	struct lnode *node;
+
+	node = smalloc(sizeof(struct lnode));
+	node->obj = obj;
+	node->next = NULL;
+	l->tail->next = node;
+	l->tail = node;
+	l->size++;
+}
+
+/**
+ * @brief Removes the first object of a list.
+ *
+ * @param l Target list.
+ *
+ * @returns The first object.
+ */
+static void *list_remove(struct list *l)
+{
+	struct lnode *node;
+	void *obj;
+
+	/* Sanity check. */
+	assert(l->size > 0);
+
+	node = l->head.next;
+	l->head.next = node->next;
+	if (--l->size == 0)
+		l->tail = &l->head;
+	obj = node->obj;
+	sfree(node);
+
+	return (obj);
+}
+
+/**
+ * @brief Returns the nth object of a list.
+ *
+ * @param l Target list.
+ * @param n Object index.
+ *
+ * @returns The nth object.
+ */
+static void *list_peek(const struct list *l, int n)
+{
+	const struct lnode *node = l->head.next;
+
+	for (int i = 0; i < n; i++)
+		node = node->next;
+
+	return (node->obj);
+}
+
+/*============================================================================*
+ * BENCHMARK                                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Returns the seconds elapsed since a given moment.
+ *
+ * @param start Starting moment.
+ *
+ * @returns Elapsed seconds.
+ */
+static double elapsed(clock_t start)
+{
+	return (((double) (clock() - start)) / CLOCKS_PER_SEC);
+}
+
+/**
+ * @brief Benchmarks the linked-list queue against MyLib's ring buffer.
+ *
+ * @details For each size, a queue holding that many objects serves
+ *          NOPERATIONS removals, each followed by an insertion, and then
+ *          a scan of all objects by index, as the simulator does when it
+ *          walks task queues with queue_peek().
+ */
+int main(void)
+{
+	static char objs[MIN_SIZE << (NSIZES - 1)];
+	unsigned long int checksum = 0;
+
+	printf("%8s %14s %14s %14s %14s\n", "size", "list ns/op", "ring ns/op", "list ns/peek", "ring ns/peek");
+	for (int i = 0; i < NSIZES; i++)
+	{
+		int size = MIN_SIZE << i;
+		double tlist, tring, plist, pring;
+		struct list l;
+		queue_tt q;
+		clock_t start;
+
+		list_init(&l);
+		q = queue_create();
+		for (int j = 0; j < size; j++)
+		{
+			list_insert(&l, &objs[j]);
+			queue_insert(q, &objs[j]);
+		}
+
+		/* Round trips. */
+		start = clock();
+		for (int j = 0; j < NOPERATIONS; j++)
+			list_insert(&l, list_remove(&l));
+		tlist = elapsed(start);
+		start = clock();
+		for (int j = 0; j < NOPERATIONS; j++)
+			queue_insert(q, queue_remove(q));
+		tring = elapsed(start);
+
+		/* Indexed scans. */
+		start = clock();
+		for (int j = 0; j < size; j++)
+			checksum += (char *) list_peek(&l, j) - objs;
+		plist = elapsed(start);
+		start = clock();
+		for (int j = 0; j < size; j++)
+			checksum += (char *) queue_peek(q, j) - objs;
+		pring = elapsed(start);
+
+		printf("%8d %14.2f %14.2f %14.2f %14.2f\n", size,
+			tlist*1e9/NOPERATIONS, tring*1e9/NOPERATIONS,
+			plist*1e9/size, pring*1e9/size);
+
+		while (l.size > 0)
+			list_remove(&l);
+		queue_destroy(q);
+	}
+
+	/* Keep scans from being optimized away. */
+	fprintf(stderr, "checksum: %lu\n", checksum);
+
+	return (EXIT_SUCCESS);
+}
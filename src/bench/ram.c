@@ -0,0 +1,129 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Scheduler.
+ *
+ * Scheduler is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * Scheduler is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Scheduler; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <mylib/util.h>
+
+#include <mem.h>
+#include <mmu.h>
+#include <ram.h>
+#include <task.h>
+#include <workload.h>
+
+/**
+ * @brief Number of benchmarked tasks.
+ */
+#define NTASKS 5
+
+/**
+ * @brief Number of memory accesses of the smallest task.
+ */
+#define MIN_ACCESSES (128*1024)
+
+/**
+ * @brief Builds a page-fault-heavy workload.
+ *
+ * @details Task i performs (MIN_ACCESSES << i) accesses that sweep its
+ * pages round-robin, so the number of pages grows with the number of
+ * accesses. Handing each task a RAM with half as many frames as it has
+ * pages turns every access into a page fault that evicts a frame of the
+ * same task.
+ *
+ * @returns A workload.
+ */
+static workload_tt bench_workload(void)
+{
+	FILE *file;
+	workload_tt w;
+
+	if ((file = tmpfile()) == NULL)
+		error("cannot create temporary file");
+
+	fprintf(file, "%d\n", NTASKS);
+	for (int i = 0; i < NTASKS; i++)
+	{
+		unsigned long int naccesses = (unsigned long int) MIN_ACCESSES << i;
+		unsigned long int npages = naccesses / DEFAULT_PAGE_SIZE;
+
+		fprintf(file, "%d %lu %d\n", i, naccesses, 0);
+		for (unsigned long int j = 0; j < naccesses; j++)
+			fprintf(file, "%lu\n", (j % npages) * DEFAULT_PAGE_SIZE + (j / npages) % DEFAULT_PAGE_SIZE);
+	}
+
+	rewind(file);
+	w = workload_read(file, 1, NULL, NULL);
+	fclose(file);
+
+	return (w);
+}
+
+/**
+ * @brief Benchmarks page faults on RAM's frames eviction.
+ */
+int main(void)
+{
+	workload_tt w;
+	mmu_tt mmu;
+
+	w = bench_workload();
+	mmu = mmu_create(0);
+
+	printf("%10s %8s %8s %10s %10s %12s\n", "accesses", "pages", "frames", "faults", "seconds", "ns/access");
+	for (int i = 0; i < NTASKS; i++)
+	{
+		task_tt ts = workload_find_task(w, i);
+		mem_tt m = task_memacc(ts);
+		unsigned long int naccesses = mem_size(m);
+		unsigned long int npages = naccesses / DEFAULT_PAGE_SIZE;
+		unsigned long int nfaults = 0;
+		struct mem_geometry g;
+		RAM_tt ram;
+		clock_t start, end;
+		double seconds;
+
+		mem_geometry_init(&g, (npages / 2) * DEFAULT_PAGE_SIZE, DEFAULT_PAGE_SIZE);
+		task_map(ts, &g);
+		ram = RAM_init(w, &g, page_policy_fifo, NULL);
+
+		start = clock();
+		for (unsigned long int j = 0; j < naccesses; j++)
+		{
+			if (!mmu_translate(mmu, ts, m, j, ram))
+				nfaults++;
+		}
+		end = clock();
+
+		seconds = ((double) (end - start)) / CLOCKS_PER_SEC;
+		printf("%10lu %8lu %8lu %10lu %10.3f %12.1f\n",
+			naccesses, npages, npages / 2, nfaults, seconds, seconds*1e9/naccesses);
+
+		RAM_destroy(ram);
+	}
+
+	mmu_destroy(mmu);
+	workload_destroy(w);
+
+	return (EXIT_SUCCESS);
+}
@@ -1,106 +1,253 @@
 #include <assert.h>
 #include <stdlib.h>
 
+#include <mylib/arena.h>
 #include <mylib/util.h>
 #include <mem.h>
 
+/**
+ * @brief Initializes a memory geometry.
+ *
+ * @param g         Target memory geometry.
+ * @param ram_size  Physical memory size (bytes).
+ * @param page_size Page size (bytes), a power of two.
+ */
+void mem_geometry_init(struct mem_geometry *g, unsigned long int ram_size, unsigned long int page_size)
+{
+	/* Sanity check. */
+	assert(g != NULL);
+	assert(page_size >= BLOCK_SIZE);
+	assert((page_size & (page_size - 1)) == 0);
+	assert(ram_size >= page_size);
+	assert(ram_size % page_size == 0);
+
+	g->ram_size = ram_size;
+	g->page_size = page_size;
+	g->page_shift = 0;
+	while ( (1UL << g->page_shift) < page_size )
+		g->page_shift++;
+}
+
+/**
+ * @brief Sequence of memory addresses.
+ *
+ * Addresses are kept in contiguous arrays, one entry per access, instead
+ * of one object per access. Virtual page and offset are not stored, but
+ * computed from the virtual address on demand.
+ */
 struct mem
 {
-	unsigned long int virtual_address;  /**< Virtual address.  */
-	unsigned long int physical_address; /**< Physical address. */
-	int offset;                         /**< Memory offset.    */
+	unsigned long int size;           /**< Number of addresses.                      */
+	bool owned;                       /**< Are virtual addresses owned by us?        */
+	unsigned long int *virtual;       /**< Virtual addresses.                        */
+	int *physical;                    /**< Physical frames (-1 if not translated).   */
+	arena_tt arena;                   /**< Arena of the sequence (may be NULL).      */
 };
 
 /**
- * @brief Instantiate a new memory space.
+ * @brief Allocates the physical frames of a sequence of memory addresses.
+ *
+ * @param size  Number of addresses.
+ * @param arena Arena to allocate from (NULL for the C library).
+ *
+ * @returns New sequence of memory addresses, with no virtual addresses.
+ */
+static struct mem *mem_alloc(unsigned long int size, arena_tt arena)
+{
+	struct mem *mem;
+
+	mem = arena_smalloc(arena, sizeof(struct mem));
+	mem->size = size;
+	mem->owned = false;
+	mem->virtual = NULL;
+	mem->arena = arena;
+	mem->physical = arena_smalloc(arena, size*sizeof(int));
+	for ( unsigned long int i = 0; i < size; i++ )
+		mem->physical[i] = -1;
+
+	return (mem);
+}
+
+/**
+ * @brief Instantiate a new sequence of memory addresses.
  * 
- * @param addr Target virtual address.
+ * @param size  Number of addresses.
+ * @param arena Arena to allocate from (NULL for the C library).
  * 
- * @returns New memory space instance.
+ * @returns New sequence of memory addresses, all of them set to zero.
 */
-mem_tt mem_create(unsigned long int addr)
+mem_tt mem_create(unsigned long int size, arena_tt arena)
 {
 	struct mem *mem;
 
-	mem = smalloc(sizeof(struct mem));
+	mem = mem_alloc(size, arena);
+	mem->virtual = arena_smalloc(arena, size*sizeof(unsigned long int));
+	for ( unsigned long int i = 0; i < size; i++ )
+		mem->virtual[i] = 0;
+	mem->owned = true;
+
+	return (mem);
+}
+
+/**
+ * @brief Instantiate a new sequence of memory addresses on top of an
+ * existing array of virtual addresses. The array is not copied, so it
+ * must outlive the returned instance.
+ * 
+ * @param addrs Virtual addresses.
+ * @param size  Number of addresses.
+ * @param arena Arena to allocate from (NULL for the C library).
+ * 
+ * @returns New sequence of memory addresses.
+*/
+mem_tt mem_wrap(const unsigned long int *addrs, unsigned long int size, arena_tt arena)
+{
+	struct mem *mem;
+
+	/* Sanity check. */
+	assert((addrs != NULL) || (size == 0));
+
+	mem = mem_alloc(size, arena);
+	mem->virtual = (unsigned long int *) addrs;
 
-	mem->virtual_address = (unsigned long int) (addr / PAGE_SIZE);
-	mem->physical_address = -1;
-	mem->offset = (addr - (mem->virtual_address * PAGE_SIZE));
 	return (mem);
 }
 
+/**
+ * @brief Returns the number of addresses in a sequence.
+ * 
+ * @param m Target memory.
+ * 
+ * @returns Number of addresses.
+*/
+unsigned long int mem_size(const struct mem *m)
+{
+    /* Sanity check. */
+    assert(m != NULL);
+
+    return (m->size);
+}
+
+/**
+ * @brief Sets the ith virtual address.
+ * 
+ * @param m    Target memory.
+ * @param idx  Address index.
+ * @param addr Virtual address.
+*/
+void mem_set_addr(struct mem *m, unsigned long int idx, unsigned long int addr)
+{
+    /* Sanity check. */
+    assert(m != NULL);
+    assert(m->owned);
+    assert(idx < m->size);
+
+    m->virtual[idx] = addr;
+}
+
+/**
+ * @brief Returns the ith virtual address, i.e. virtual page times PAGE_SIZE plus offset.
+ * 
+ * @param m   Target memory.
+ * @param idx Address index.
+ * 
+ * @returns The ith virtual address.
+*/
+unsigned long int mem_addr(const struct mem *m, unsigned long int idx)
+{
+    /* Sanity check. */
+    assert(m != NULL);
+    assert(idx < m->size);
+
+    return (m->virtual[idx]);
+}
+
 /**
  * @brief Returns memory's virtual address. IMPORTANT this value is NOT multiplied by PAGE_SIZE,
  * If you want to use it you MUST multiply it.
  * 
- * @param m Target memory. 
+ * @param m   Target memory. 
+ * @param idx Address index.
+ * @param g   Memory geometry.
  * 
  * @returns Memory's virtual address.
 */
-unsigned long int mem_virtual_addr(const struct mem *m)
+unsigned long int mem_virtual_addr(const struct mem *m, unsigned long int idx, const struct mem_geometry *g)
 {
     /* Sanity check. */
     assert(m != NULL);
-    return (m->virtual_address);
+    assert(idx < m->size);
+    assert(g != NULL);
+
+    return (m->virtual[idx] >> g->page_shift);
 }
 
 /**
  * @brief Returns memory's physical address. IMPORTANT this value is NOT multiplied by PAGE_SIZE,
  * If you want to use it you MUST multiply it.
  * 
- * @param m Target memory. 
+ * @param m   Target memory. 
+ * @param idx Address index.
  * 
  * @returns Memory's physical address.
 */
-unsigned long int mem_physical_addr(const struct mem *m)
+unsigned long int mem_physical_addr(const struct mem *m, unsigned long int idx)
 {
     /* Sanity check. */
     assert(m != NULL);
+    assert(idx < m->size);
 
-    return (m->physical_address);
+    return (m->physical[idx]);
 }
 
 /**
  * @brief Sets the physical address (based in a frame).
  * 
- * @param m   Target memory.
- * @param idx Frame's initial address.
+ * @param m     Target memory.
+ * @param idx   Address index.
+ * @param frame Frame's initial address.
  */
-void mem_set_physical_addr(struct mem *m, unsigned long int idx)
+void mem_set_physical_addr(struct mem *m, unsigned long int idx, unsigned long int frame)
 {
 	/* Sanity check. */
     assert(m != NULL);
+    assert(idx < m->size);
 
-	m->physical_address = idx;
+	m->physical[idx] = frame;
 }
 
 /**
  * @brief Returns memory offset.
  * 
- * @param m Target memory. 
+ * @param m   Target memory. 
+ * @param idx Address index.
+ * @param g   Memory geometry.
  * 
  * @returns Memory offset.
 */
-int mem_addr_offset(const struct mem *m)
+int mem_addr_offset(const struct mem *m, unsigned long int idx, const struct mem_geometry *g)
 {
     /* Sanity check. */
     assert(m != NULL);
+    assert(idx < m->size);
+    assert(g != NULL);
 
-    return (m->offset);
+    return (m->virtual[idx] & (g->page_size - 1));
 }
 
 
 /**
- * @brief Destroys a memory space.
+ * @brief Destroys a sequence of memory addresses.
  *
- * @param m Target memory space.
+ * @param m Target memory.
  */
 void mem_destroy(struct mem *m)
 {
 	/* Sanity check. */
     assert(m != NULL);
 
-    free(m);
+	if (m->owned)
+		arena_sfree(m->arena, m->virtual);
+	arena_sfree(m->arena, m->physical);
+    arena_sfree(m->arena, m);
 }
-
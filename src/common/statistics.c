@@ -74,8 +74,8 @@ void histogram_destroy(struct histogram *h)
 	/* Sanity check, */
 	assert(h != NULL);
 
-	free((void *) h->classes);
-	free((void *) h);
+	sfree((void *) h->classes);
+	sfree((void *) h);
 }
 
 /**
@@ -129,7 +129,7 @@ struct distribution
  */
 void distribution_destroy(struct distribution *dist)
 {
-	free(dist);
+	sfree(dist);
 }
 
 /**
@@ -24,173 +24,134 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <math.h>
 
 #include <task.h>
 #include <math.h>
 #include <mem.h>
+#include <mylib/arena.h>
 #include <mylib/util.h>
 #include <mylib/map.h>
 
 /*====================================================================*
- * PAGE TABLE LINE                                                    *
+ * PAGE TABLE                                                         *
  *====================================================================*/
 
 /**
- * @brief Page Table's line.
- */
-struct page_table_line
-{
-	bool valid;    /**< Valid bit.                            */
-	int  frame_id; /**< Which frame this line is assigned to. */
-};
-
-/**
- * @brief Creates a new instance of a page_table_line.
- *  
- * @returns New instance of page_table_line.
- */
-static inline struct page_table_line* page_table_line_create()
-{
-	struct page_table_line *pl = smalloc(sizeof(struct page_table_line));
-	pl->valid = false;
-	pl->frame_id = -1;
-	return (pl);
-}
-
-/**
- * @brief Checks if a page_table_line is valid.
- * 
- * @param pl Target page_table_line.
- * 
- * @returns True if valid. False otherwise.
- */
-static inline bool page_check_table_line_valid(const struct page_table_line *pl)
-{
-	/* Sanity check. */
-	assert(pl != NULL);
-	return (pl->valid);
-}
-
-/**
- * @brief Sets page_table_line's valid bit to true.
- * 
- * @param pl Target page_table_line.
- */
-static inline void page_valid_table_line(struct page_table_line *pl)
-{
-	/* Sanity check. */
-	assert(pl != NULL);
-	pl->valid = true;
-}
-
-/**
- * @brief Sets page_table_line's valid bit to false.
- * 
- * @param pl Target page_table_line.
- */
-static inline void page_invalid_table_line(struct page_table_line *pl)
-{
-	/* Sanity check. */
-	assert(pl != NULL);
-	pl->valid = false;
-}
-
-
-/**
- * @brief Returns the frame id of a page_table_line. If page is invalid, assert will break execution.
- * 
- * @param pl Target page_table_line.
- * 
- * @returns Frame id stored at page_table_line. 
- */
-static inline int page_table_line_frameid(const struct page_table_line *pl)
-{
-	/* Sanity check. */
-	assert(pl != NULL);
-	assert(pl->valid);
-	return (pl->frame_id);
-}
-
-/**
- * @brief Sets the frame id of a page_table_line.
- * 
- * @param pl       Target page_table_line.
- * @param frame_id Desired frame_id.
+ * @name Page table entries.
+ *
+ * @details A page table entry is packed in 32 bits: the valid bit and
+ * the id of the frame the line is assigned to.
  */
-static inline void page_set_table_line_frameid(struct page_table_line *pl, int frame_id)
-{
-	/* Sanity check. */
-	assert(pl != NULL);
-	assert(frame_id >= 0);
-	pl->frame_id = frame_id;
-}
+/**@{*/
+#define PTE_VALID      0x80000000u /**< Valid bit.     */
+#define PTE_FRAME_MASK 0x7fffffffu /**< Frame id mask. */
+/**@}*/
 
 /**
- * @brief Destroys a page_table_line instance
- * 
- * @param pl Target page_table_line.
+ * @name Two-level page tables.
+ *
+ * @details Page tables that have up to PT_FLAT_MAX_LINES lines are a
+ * single flat array of entries. Larger ones are a directory of leaves of
+ * PT_LEAF_LINES entries each, and leaves are only allocated when one of
+ * their lines is first assigned a frame, so sparse address spaces do not
+ * pay for their holes.
  */
-static inline void page_table_line_destroy(struct page_table_line *pl)
-{
-	/* Sanity check. */
-	assert(pl != NULL);
-	free(pl);
-}
-
-/*====================================================================*
- * PAGE TABLE                                                         *
- *====================================================================*/
+/**@{*/
+#define PT_FLAT_MAX_LINES (1 << 16)                /**< Largest flat page table.  */
+#define PT_LEAF_SHIFT     10                       /**< Lines per leaf (log2).    */
+#define PT_LEAF_LINES     (1 << PT_LEAF_SHIFT)     /**< Lines per leaf.           */
+#define PT_LEAF_MASK      (PT_LEAF_LINES - 1)      /**< Line offset within leaf.  */
+/**@}*/
 
 /**
  * @brief Page Table.
  */
 struct page_table
 {
-	int task_id;                         /**< Which task is this page table. */
-	int num_lines;                       /**< Number of lines.               */
-	struct page_table_line** page_lines; /**< Page lines.                    */
+	int task_id;        /**< Which task is this page table.              */
+	int num_lines;      /**< Number of lines.                            */
+	uint32_t *entries;  /**< Page lines of a flat table (NULL if radix). */
+	uint32_t **leaves;  /**< Leaves of a radix table (NULL if flat).     */
+	arena_tt arena;     /**< Arena of the table (may be NULL).           */
 };
 
 /**
  * @brief Creates a new instance of a page_table.
  * 
- * @param task_id  Task's id of target task.
- * @param mem_size Number of task's memory accesses.
+ * @param task_id   Task's id of target task.
+ * @param mem_size  Number of task's memory accesses.
+ * @param page_size Page size (bytes).
+ * @param arena     Arena to allocate from (NULL for the C library).
  * 
  * @returns New instance of page_table.
  */
-static inline struct page_table *page_table_create(int task_id, unsigned long int mem_size)
+static inline struct page_table *page_table_create(int task_id, unsigned long int mem_size, unsigned long int page_size, arena_tt arena)
 {
 	struct page_table *pt;
 	/* Sanity check. */
 	assert(task_id >= 0);
-	int num_lines = (int) (ceil(mem_size / PAGE_SIZE) + 1);
-	pt = smalloc(sizeof(struct page_table));
+	assert(page_size > 0);
+	int num_lines = (int) (ceil(mem_size / page_size) + 1);
+	pt = arena_smalloc(arena, sizeof(struct page_table));
 	pt->task_id = task_id;
 	pt->num_lines = num_lines;
-
-	pt->page_lines = smalloc(sizeof(struct page_table_line*) * num_lines);
-	for ( int i = 0; i < num_lines; i++ )
-		pt->page_lines[i] = page_table_line_create();
+	pt->entries = NULL;
+	pt->leaves = NULL;
+	pt->arena = arena;
+
+	/* All lines start invalid. */
+	if ( num_lines <= PT_FLAT_MAX_LINES )
+		pt->entries = arena_scalloc(arena, num_lines, sizeof(uint32_t));
+	else
+		pt->leaves = arena_scalloc(arena, (num_lines + PT_LEAF_MASK) >> PT_LEAF_SHIFT, sizeof(uint32_t *));
 	
 	return (pt);
 }
 
 /**
- * @brief Returns page_table_line at specified line.
+ * @brief Returns page_table's entry at specified line.
+ * 
+ * @param pt  Target page table
+ * @param idx Desired line.
+ * 
+ * @returns Page_table entry.
+ */
+static inline uint32_t page_table_entry(const struct page_table *pt, int idx)
+{
+	/* Sanity check. */
+	assert(pt != NULL);
+	assert(idx < pt->num_lines);
+
+	if ( pt->entries != NULL )
+		return (pt->entries[idx]);
+
+	const uint32_t *leaf = pt->leaves[idx >> PT_LEAF_SHIFT];
+	return ( (leaf != NULL) ? leaf[idx & PT_LEAF_MASK] : 0 );
+}
+
+/**
+ * @brief Returns a pointer to page_table's entry at specified line, allocating its leaf if needed.
  * 
  * @param pt  Target page table
  * @param idx Desired line.
  * 
- * @returns Page_table line.
+ * @returns Pointer to page_table entry.
  */
-static inline struct page_table_line* page_table_line_at(const struct page_table *pt, int idx)
+static inline uint32_t *page_table_entry_at(struct page_table *pt, int idx)
 {
 	/* Sanity check. */
 	assert(pt != NULL);
-	assert(idx <= pt->num_lines);
-	return (pt->page_lines[idx]);
+	assert(idx < pt->num_lines);
+
+	if ( pt->entries != NULL )
+		return (&pt->entries[idx]);
+
+	uint32_t **leaf = &pt->leaves[idx >> PT_LEAF_SHIFT];
+	if ( *leaf == NULL )
+		*leaf = arena_scalloc(pt->arena, PT_LEAF_LINES, sizeof(uint32_t));
+	return (&(*leaf)[idx & PT_LEAF_MASK]);
 }
 
 /**
@@ -216,9 +177,13 @@ static inline void page_table_destroy(struct page_table *pt)
 {
 	/* Sanity check. */
 	assert(pt != NULL);
-	for ( int i = 0; i < pt->num_lines; i++ ) page_table_line_destroy(pt->page_lines[i]);
-	free(pt->page_lines);
-	free(pt);
+	if ( pt->leaves != NULL )
+	{
+		for ( int i = 0; i < (pt->num_lines + PT_LEAF_MASK) >> PT_LEAF_SHIFT; i++ ) arena_sfree(pt->arena, pt->leaves[i]);
+		arena_sfree(pt->arena, pt->leaves);
+	}
+	arena_sfree(pt->arena, pt->entries);
+	arena_sfree(pt->arena, pt);
 }
 
 /*====================================================================*
@@ -243,6 +208,8 @@ struct task
 	unsigned long int page_faults;     /**< Number of page faults.                  */
 	unsigned long int hits;			   /**< Number of hits.                         */
 	unsigned long int misses;          /**< Number of misses.                       */
+	unsigned long int tlb_hits;        /**< Number of TLB hits.                     */
+	unsigned long int tlb_misses;      /**< Number of TLB misses.                   */
 
 	int* all_sets_accessed;            /**< All cache sets accessed p/ task.        */
 	int* all_pages_accessed;           /**< All page lines accessed p/ task.        */
@@ -254,38 +221,38 @@ struct task
 	int lineptr;                       /**< Points to the last line accessed.       */
 
 	struct page_table* p_table;        /**< Task's page table.                      */
-	array_tt memacc;                   /**< Tasks' memory accesses.                 */
+	mem_tt memacc;                     /**< Tasks' memory accesses.                 */
+	arena_tt arena;                    /**< Arena of the task (may be NULL).        */
 	unsigned long int memptr;          /**< Points to the last memory accessed.     */
  
 	int e_moment;                      /**< Moment when task (r)entered in a core.  */
 	int l_moment;                      /**< Moment when task left from a core.      */
 };
 
-/**
- * @brief Next available task identification number.
- */
-static int next_tsid = 0;
-
 /**
  * @brief Creates a task.
  *
+ * @param tsid    Task identification number, unique within its workload.
  * @param real_id Initial ID assigned when workload created.
  * @param work    Workload of a task.
  * @param arrival Arrival moment of a task.
+ * @param arena   Arena to allocate from (NULL for the C library).
  *
  * @returns A task.
  */
-struct task *task_create(int real_id, unsigned long int work, int arrival)
+struct task *task_create(int tsid, int real_id, unsigned long int work, int arrival, arena_tt arena)
 {
 	struct task *task;
 
 	/* Sanity check. */
+	assert(tsid >= 0);
 	assert(arrival >= 0);
 
-	task = smalloc(sizeof(struct task));
+	task = arena_smalloc(arena, sizeof(struct task));
+	task->arena = arena;
 
 	task->real_id = real_id;
-	task->tsid = next_tsid++;
+	task->tsid = tsid;
 	task->arrival_time = arrival;
 	task->waiting_time = 0;
 	task->work = work;
@@ -297,23 +264,43 @@ struct task *task_create(int real_id, unsigned long int work, int arrival)
 	task->page_faults = 0;
 	task->hits = 0;
 	task->misses = 0;
+	task->tlb_hits = 0;
+	task->tlb_misses = 0;
 
-	task->all_sets_accessed = smalloc(sizeof(int) * task->work);
-	task->all_pages_accessed = smalloc(sizeof(int) * task->work);
-	task->sets_accessed = map_create(map_compare_int);
-	task->pages_accessed = map_create(map_compare_int);
-	task->mem_accessed = map_create(map_compare_ulong_int);
+	task->all_sets_accessed = arena_smalloc(arena, sizeof(int) * task->work);
+	task->all_pages_accessed = arena_smalloc(arena, sizeof(int) * task->work);
+	task->sets_accessed = map_create_arena(sizeof(int), arena);
+	task->pages_accessed = map_create_arena(sizeof(int), arena);
+	task->mem_accessed = map_create_arena(sizeof(int), arena);
 
-	task->p_table = page_table_create(task->tsid, work);
+	task->p_table = NULL;
 	// Initializing. 
 	for ( unsigned long int i = 0; i < work; i++ ) task->all_sets_accessed[i] = -1;
 
-	task->memacc = array_create(work);
+	task->memacc = NULL;
 	task->memptr = 0;
 
 	return (task);
 }
 
+/**
+ * @brief Maps a task into a memory, i.e. (re)creates its page table
+ * after the task's work and the memory's page size.
+ * 
+ * @param ts Target task.
+ * @param g  Memory geometry.
+ */
+void task_map(struct task *ts, const struct mem_geometry *g)
+{
+	/* Sanity check. */
+	assert(ts != NULL);
+	assert(g != NULL);
+
+	if ( ts->p_table != NULL )
+		page_table_destroy(ts->p_table);
+	ts->p_table = page_table_create(ts->tsid, ts->work, g->page_size, ts->arena);
+}
+
 /**
  * @brief Sets the id assigned when workload created.
  * 
@@ -466,6 +453,8 @@ void task_create_memacc(struct task *ts, histogram_tt hist)
         			  k = 0;
 
 
+	task_set_memacc(ts, mem_create(ts->work, ts->arena));
+
 	/* Storing randomly-generated task's memory acesses. Will contain size(task_workload) following gaussian distribuition */
 	for ( l = 0; l < histogram_nclasses(hist); l++ )
 	{
@@ -473,16 +462,14 @@ void task_create_memacc(struct task *ts, histogram_tt hist)
 		for ( j = 0; j < n; j++ )
 		{
 			/* Generating the memory accesses. */
-			struct mem *m = mem_create(l);
-			array_set(ts->memacc, k++, m);
+			mem_set_addr(ts->memacc, k++, l);
 		}
 	}
 	i = k;
 	for ( /* */; i < ts->work; i++ )
 	{
 		j = rand()%histogram_nclasses(hist);
-		struct mem *m = mem_create((i));
-		array_set(ts->memacc, k++, m);
+		mem_set_addr(ts->memacc, k++, i);
 	}
 }
 
@@ -490,15 +477,18 @@ void task_create_memacc(struct task *ts, histogram_tt hist)
  * @brief Sets task's memory address that will be accessed.
  * 
  * @param ts Target task. 
- * @param a  Array of memory addresses.
+ * @param m  Memory addresses.
 */
-void task_set_memacc(struct task *ts, array_tt a)
+void task_set_memacc(struct task *ts, mem_tt m)
 {
 	/* Sanity check. */
 	assert(ts != NULL);
-	assert(a != NULL);
+	assert(m != NULL);
+	assert(mem_size(m) == ts->work);
 
-	ts->memacc = a;
+	if (ts->memacc != NULL)
+		mem_destroy(ts->memacc);
+	ts->memacc = m;
 }
 
 /**
@@ -547,6 +537,21 @@ int task_waiting_time(const struct task *ts)
 	return(ts->waiting_time);
 }
 
+/**
+ * @brief Returns the slowdown of a task, i.e. its turnaround time over its workload.
+ * 
+ * @param ts Target task.
+ * 
+ * @returns Slowdown of a task.
+ */
+float task_slowdown(const struct task *ts)
+{
+	/* Sanity check. */
+	assert(ts != NULL);
+
+	return (((float) ts->waiting_time + (float) ts->work) / ((float) ts->work));
+}
+
 /**
  * @brief Returns the workload of given task.
  * 
@@ -619,7 +624,7 @@ bool task_check_pt_line_valid(const struct task *ts, int idx)
 	/* Sanity check. */
 	assert(ts != NULL);
 	assert(idx >= 0);
-	return page_check_table_line_valid(page_table_line_at(ts->p_table, idx));
+	return (page_table_entry(ts->p_table, idx) & PTE_VALID);
 }
 
 /**
@@ -633,7 +638,7 @@ void task_invalid_pt_line(struct task *ts, int idx)
 	/* Sanity check. */
 	assert(ts != NULL);
 	assert(idx >= 0);
-	page_invalid_table_line(page_table_line_at(ts->p_table, idx));
+	*page_table_entry_at(ts->p_table, idx) &= ~PTE_VALID;
 }
 
 /**
@@ -647,51 +652,7 @@ void task_valid_pt_line(struct task *ts, int idx)
 	/* Sanity check. */
 	assert(ts != NULL);
 	assert(idx >= 0);
-	page_valid_table_line(page_table_line_at(ts->p_table, idx));
-}
-
-/**
- * @brief Searchs for a page_table_line that is valid and is assigned with frame_idx.
- * Returns page_table_line's id if found.
- * 
- * @param ts        Target task.
- * @param frame_idx Desired frame id.
- * 
- * @returns Page_table_line's id if found. -1, otherwise.
- */
-int task_find_pt_line_frame_id(const struct task *ts, int frame_idx)
-{
-	/* Sanity check. */
-	assert(ts != NULL);
-	assert(frame_idx >= 0);
-
-	int num_lines = page_table_num_lines(ts->p_table);
-	for ( int i = 0; i < num_lines; i++ )
-	{
-		struct page_table_line *pl = page_table_line_at(ts->p_table, i);
-		if ( page_check_table_line_valid(pl) )
-		{
-			if ( page_table_line_frameid(pl) == frame_idx ) return i;
-		}
-
-	}
-	return -1;
-}
-
-/**
- * @brief Returns the page_table_line of current task's mem_addr.
- * 
- * @param ts Target task.
- * 
- * @returns Page_table_line of current task's mem_addr.
- */
-int task_find_pt_line_memptr(const struct task *ts)
-{
-	/* Sanity check. */
-	assert(ts != NULL);
-
-	struct mem *mem = array_get(ts->memacc, ts->memptr);
-	return (mem_virtual_addr(mem));
+	*page_table_entry_at(ts->p_table, idx) |= PTE_VALID;
 }
 
 /**
@@ -707,8 +668,10 @@ int task_get_pt_line_frameid(const struct task *ts, int id)
 	/* Sanity check. */
 	assert(ts != NULL);
 	assert(id >= 0);
-	struct page_table_line *pl = page_table_line_at(ts->p_table, id);
-	return page_table_line_frameid(pl);		
+	uint32_t entry = page_table_entry(ts->p_table, id);
+	/* Frame id is only meaningful for valid lines. */
+	assert(entry & PTE_VALID);
+	return (entry & PTE_FRAME_MASK);
 }
 
 /**
@@ -723,8 +686,9 @@ void task_set_pt_line_frameid(struct task *ts, int id, int frame_id)
 	/* Sanity check. */
 	assert(ts != NULL);
 	assert(id >= 0);
-	struct page_table_line *pl = page_table_line_at(ts->p_table, id);
-	page_set_table_line_frameid(pl, frame_id);		
+	assert(frame_id >= 0 && (uint32_t) frame_id <= PTE_FRAME_MASK);
+	uint32_t *entry = page_table_entry_at(ts->p_table, id);
+	*entry = (*entry & PTE_VALID) | (uint32_t) frame_id;
 }
 
 
@@ -750,7 +714,7 @@ int task_pt_num_lines(const struct task *ts)
  * 
  * @return Task's memory addresses.
 */
-array_tt task_memacc(const struct task *ts)
+mem_tt task_memacc(const struct task *ts)
 {
 	/* Sanity check. */
 	assert(ts != NULL);
@@ -788,18 +752,6 @@ int* task_pageacc(const struct task *ts)
 	return (ts->all_pages_accessed);
 }
 
-int map_compare_mem(void* addr1, void* addr2)
-{
-	/* Sanity check. */
-	assert(addr1 != NULL);
-	assert(addr2 != NULL);
-    
-	unsigned long int addr1_phy = mem_physical_addr((mem_tt) addr1) * PAGE_SIZE + mem_addr_offset((mem_tt) addr1);
-	unsigned long int addr2_phy = mem_physical_addr((mem_tt) addr2) * PAGE_SIZE + mem_addr_offset((mem_tt) addr2);
-
-	return (addr1_phy == addr2_phy);
-}
-
 /**
  * @brief Returns the total percentage of repeated sets in last WINSIZE.
  * 
@@ -818,8 +770,7 @@ double task_hotness(struct task *ts, int winsize)
 
 		/* Cleaning old values. */
 
-		map_destroy(ts->sets_accessed);
-		ts->sets_accessed = map_create(map_compare_int);
+		map_clear(ts->sets_accessed);
 
 		// Saving last WINSIZE accesses into map
 		for ( int i = 0; i < winsize; i++ )
@@ -945,6 +896,56 @@ unsigned long int task_page_fault(const struct task *ts)
 }
 
 
+/**
+ * @brief Sets the number of TLB hits that happened while processing.
+ * 
+ * @param ts  Target task.
+ * @param hit Number of TLB hits.
+*/
+void task_set_tlb_hit(struct task *ts, unsigned long int hit)
+{
+	/* Sanity check. */
+	assert(ts != NULL);
+	ts->tlb_hits = hit;
+}
+
+/**
+ * @brief Sets the number of TLB misses that happened while processing.
+ * 
+ * @param ts   Target task.
+ * @param miss Number of TLB misses.
+*/
+void task_set_tlb_miss(struct task *ts, unsigned long int miss)
+{
+	/* Sanity check. */
+	assert(ts != NULL);
+	ts->tlb_misses = miss;
+}
+
+/**
+ * @brief Gets the number of TLB hits that happened while processing.
+ * 
+ * @param ts Target task.
+*/
+unsigned long int task_tlb_hit(const struct task *ts)
+{
+	/* Sanity check. */
+	assert(ts != NULL);
+	return (ts->tlb_hits);
+}
+
+/**
+ * @brief Gets the number of TLB misses that happened while processing.
+ * 
+ * @param ts Target task.
+*/
+unsigned long int task_tlb_miss(const struct task *ts)
+{
+	/* Sanity check. */
+	assert(ts != NULL);
+	return (ts->tlb_misses);
+}
+
 /**
  * @brief Sets the number of cache hits that task had while processing.
  * 
@@ -1039,16 +1040,16 @@ void task_destroy(struct task *ts)
 	assert(ts != NULL);
 
 
-	page_table_destroy(ts->p_table);
-	for ( unsigned long int i = 0; i < ts->work; i++ )
-		mem_destroy(array_get(ts->memacc, i));
+	if (ts->p_table != NULL)
+		page_table_destroy(ts->p_table);
+	if (ts->memacc != NULL)
+		mem_destroy(ts->memacc);
 
 	map_destroy(ts->mem_accessed);
 	map_destroy(ts->sets_accessed);
 	map_destroy(ts->pages_accessed);
 
-	array_destroy(ts->memacc);
-	free(ts->all_sets_accessed);
-	free(ts->all_pages_accessed);
-	free(ts);
+	arena_sfree(ts->arena, ts->all_sets_accessed);
+	arena_sfree(ts->arena, ts->all_pages_accessed);
+	arena_sfree(ts->arena, ts);
 }
\ No newline at end of file
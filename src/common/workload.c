@@ -20,10 +20,14 @@
  */
 
 #include <assert.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <math.h>
 #include <time.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include <mylib/util.h>
 
@@ -43,6 +47,9 @@ struct workload
 	queue_tt tasks;             /**< All initial tasks.                                                                                                                                                                                                                  */
 	array_tt all_arrived_tasks; /**< All queues of tasks that will be assigned to cores. There are ncores + 2 arrays. 0 to ncores are the queues for each core. Second from last has the tasks (not yet grouped) but processed. Last position has the not grouped cores. */
 	queue_tt finished_tasks;    /**< All tasks that have finished.                                                                                                                                                                                                       */
+	void *mapping;              /**< Mapped binary workload file, if any. Tasks' memory accesses point straight into it.                                                                                                                                                 */
+	size_t mapping_size;        /**< Size of the mapped binary workload file.                                                                                                                                                                                            */
+	arena_tt arena;             /**< Arena of the workload (may be NULL).                                                                                                                                                                                                */
 };
 
 /**
@@ -99,6 +106,9 @@ struct workload *workload_create(histogram_tt h, histogram_tt a, int skewness, i
 	w->tasks = queue_create();
 	w->all_arrived_tasks = array_create(0);
 	w->finished_tasks = queue_create();
+	w->mapping = NULL;
+	w->mapping_size = 0;
+	w->arena = NULL;
 
 	/* Create workload. */
 	k = 0;
@@ -108,8 +118,8 @@ struct workload *workload_create(histogram_tt h, histogram_tt a, int skewness, i
 
 		n = floor(histogram_class(h, i)*ntasks);
 
-		for (int j = 0; j < n; j++){
-			queue_insert(w->tasks, task_create(k++, workload_skewness(i, histogram_nclasses(h), skewness), 0));
+		for (int j = 0; j < n; j++, k++){
+			queue_insert(w->tasks, task_create(k, k, workload_skewness(i, histogram_nclasses(h), skewness), 0, NULL));
 		}
 	}
 
@@ -124,7 +134,8 @@ struct workload *workload_create(histogram_tt h, histogram_tt a, int skewness, i
 	for (int i = k; i < ntasks; i++)
 	{
 		int j = rand()%histogram_nclasses(h);
-		queue_insert(w->tasks, task_create(k++, workload_skewness(j, histogram_nclasses(h), skewness), 0));
+		queue_insert(w->tasks, task_create(k, k, workload_skewness(j, histogram_nclasses(h), skewness), 0, NULL));
+		k++;
 	}
 
 	/* ARRIVAL TIME. */
@@ -183,7 +194,10 @@ void workload_destroy(struct workload *w)
 		queue_destroy(array_get(w->all_arrived_tasks, i));
 	array_destroy(w->all_arrived_tasks);
 	array_destroy(w->all_tasks);
-	free(w);
+	queue_destroy(w->finished_tasks);
+	if (w->mapping != NULL)
+		munmap(w->mapping, w->mapping_size);
+	arena_sfree(w->arena, w);
 }
 
 /**
@@ -494,6 +508,75 @@ int *workload_sortmap(struct workload *w)
 	return (map);
 } 
 
+/*====================================================================*
+ * BINARY FORMAT                                                      *
+ *====================================================================*/
+
+/**
+ * @brief Binary workload format definitions.
+ */
+/**@{*/
+#define WORKLOAD_MAGIC   0x4c575353 /**< "SSWL" in little endian. */
+#define WORKLOAD_VERSION 1          /**< Current format version.  */
+/**@}*/
+
+/**
+ * @brief Binary workload file header.
+ *
+ * A binary workload file is laid out as a header, followed by one
+ * record per task, followed by the packed memory accesses of all
+ * tasks. Every field is stored in host byte order, so files are not
+ * portable across machines with different endianness.
+ */
+struct workload_header
+{
+	uint32_t magic;   /**< Magic number.    */
+	uint32_t version; /**< Format version.  */
+	uint64_t ntasks;  /**< Number of tasks. */
+};
+
+/**
+ * @brief Binary workload task record.
+ */
+struct workload_record
+{
+	int32_t real_id; /**< Real id assigned when workload created.          */
+	int32_t arrival; /**< Arrival moment of the task.                      */
+	uint64_t work;   /**< Number of memory accesses.                       */
+	uint64_t addrs;  /**< File offset of the task's packed memory accesses. */
+};
+
+/**
+ * @brief Allocates an empty workload, ready to be populated with
+ * workload_set_task().
+ *
+ * @param ntasks Number of tasks.
+ * @param ncores Total number of working cores in Simulation.
+ * @param arena  Arena to allocate from (NULL for the C library).
+ *
+ * @returns An empty workload.
+ */
+struct workload *workload_alloc(int ntasks, int ncores, arena_tt arena)
+{
+	struct workload *w;
+
+	w = arena_smalloc(arena, sizeof(struct workload));
+	w->all_tasks = array_create_arena(ntasks, arena);
+	w->tasks = queue_create_arena(arena);
+	w->all_arrived_tasks = array_create_arena(ncores + 2, arena);
+
+	// Adding a queue into all_arrived_tasks
+	for ( unsigned long int i = 0; i < array_size(w->all_arrived_tasks); i++ )
+		array_set(w->all_arrived_tasks, i, queue_create_arena(arena));
+	w->finished_tasks = queue_create_arena(arena);
+	w->ntasks = ntasks;
+	w->mapping = NULL;
+	w->mapping_size = 0;
+	w->arena = arena;
+
+	return (w);
+}
+
 /**
  * @brief Writes a workload to a file.
  *
@@ -511,27 +594,107 @@ void workload_write(FILE *outfile, struct workload *w)
 	for (int i = 0; i < w->ntasks; i++)
 	{
 		task_tt ts = queue_peek(workload_tasks(w), i);
-		array_tt memacc = task_memacc(ts);
+		mem_tt memacc = task_memacc(ts);
 		fprintf(outfile, "%d %lu %d ", task_realid(ts), task_workload(ts), task_arrivaltime(ts));
 		for ( unsigned long int j = 0; j < task_workload(ts); j++ )
-		{
-			unsigned long int elem = (mem_virtual_addr(array_get(memacc, j)) * PAGE_SIZE) + mem_addr_offset(array_get(memacc, j));
-			fprintf(outfile, "%lu ", elem);
-		}
+			fprintf(outfile, "%lu ", mem_addr(memacc, j));
 		fprintf(outfile, "\n");
-		free(memacc);
 	}
 }
 
+/**
+ * @brief Writes a workload to a file, in binary format.
+ *
+ * @param outfile Output file.
+ * @param w       Target workload.
+ */
+void workload_write_binary(FILE *outfile, struct workload *w)
+{
+	uint64_t offset;                 /* Offset of next address array. */
+	struct workload_header header;   /* File header.                  */
+	struct workload_record *records; /* Task records.                 */
+
+	/* Sanity check. */
+	assert(outfile != NULL);
+	assert(w != NULL);
+
+	header.magic = WORKLOAD_MAGIC;
+	header.version = WORKLOAD_VERSION;
+	header.ntasks = w->ntasks;
+
+	/* Build task table. */
+	records = smalloc(w->ntasks*sizeof(struct workload_record));
+	offset = sizeof(struct workload_header) + w->ntasks*sizeof(struct workload_record);
+	for (int i = 0; i < w->ntasks; i++)
+	{
+		task_tt ts = queue_peek(workload_tasks(w), i);
+
+		records[i].real_id = task_realid(ts);
+		records[i].arrival = task_arrivaltime(ts);
+		records[i].work = task_workload(ts);
+		records[i].addrs = offset;
+		offset += task_workload(ts)*sizeof(uint64_t);
+	}
+
+	if (fwrite(&header, sizeof(struct workload_header), 1, outfile) != 1)
+		error("cannot write workload header");
+	if (fwrite(records, sizeof(struct workload_record), w->ntasks, outfile) != (size_t) w->ntasks)
+		error("cannot write workload tasks");
+
+	/* Write memory accesses, one task at a time. */
+	for (int i = 0; i < w->ntasks; i++)
+	{
+		uint64_t *addrs;
+		task_tt ts = queue_peek(workload_tasks(w), i);
+		mem_tt memacc = task_memacc(ts);
+
+		if (records[i].work == 0)
+			continue;
+
+		addrs = smalloc(records[i].work*sizeof(uint64_t));
+		for ( unsigned long int j = 0; j < records[i].work; j++ )
+			addrs[j] = mem_addr(memacc, j);
+
+		if (fwrite(addrs, sizeof(uint64_t), records[i].work, outfile) != records[i].work)
+			error("cannot write workload memory accesses");
+		sfree(addrs);
+	}
+
+	sfree(records);
+}
+
+/**
+ * @brief Gives up reading a workload, releasing the tasks read so far.
+ *
+ * @param w      Target workload.
+ * @param errmsg Store location for what is wrong (may be NULL).
+ * @param msg    What is wrong.
+ *
+ * @returns NULL.
+ */
+static struct workload *workload_read_fail(struct workload *w, const char **errmsg, const char *msg)
+{
+	while (!queue_empty(w->tasks))
+		task_destroy(queue_remove(w->tasks));
+	workload_destroy(w);
+
+	if (errmsg != NULL)
+		*errmsg = msg;
+
+	return (NULL);
+}
+
 /**
  * @brief Reads a workload from a file.
  *
  * @param infile Input file.
  * @param ncores Total number of working cores in Simulation. 
+ * @param arena  Arena of tasks (NULL for the C library).
+ * @param errmsg Store location for what is wrong, on failure (may be NULL).
  *
- * @returns A workload.
+ * @returns A workload, NULL if the file is malformed.
  */
-struct workload *workload_read(FILE *infile, int ncores)
+struct workload *workload_read(FILE *infile, int ncores, arena_tt arena, const char **errmsg)
 {
 	int ntasks;         /**< Number of tasks. */
 	struct workload *w; /**< Workload.        */
@@ -539,18 +702,14 @@ struct workload *workload_read(FILE *infile, int ncores)
 	/* Sanity check. */
 	assert(infile != NULL);
 
-	assert(fscanf(infile, "%d\n", &ntasks) == 1);
+	if ((fscanf(infile, "%d\n", &ntasks) != 1) || (ntasks < 0))
+	{
+		if (errmsg != NULL)
+			*errmsg = "bad workload file";
+		return (NULL);
+	}
 
-	w = smalloc(sizeof(struct workload));
-	w->all_tasks = array_create(ntasks);
-	w->tasks = queue_create();
-	w->all_arrived_tasks = array_create(ncores + 2);
-
-	// Adding a queue into all_arrived_tasks
-	for ( unsigned long int i = 0; i < array_size(w->all_arrived_tasks); i++ )
-		array_set(w->all_arrived_tasks, i, queue_create());
-	w->finished_tasks = queue_create();
-	w->ntasks = ntasks;
+	w = workload_alloc(ntasks, ncores, arena);
 
 	/* Write workload to file. */
 	int real_id   = 0,
@@ -558,20 +717,24 @@ struct workload *workload_read(FILE *infile, int ncores)
 	unsigned long int addr      = 0,
 	                  workload  = 0;
 	for (int i = 0; i < ntasks; i++) {
-		assert(fscanf(infile, "%d", &real_id) == 1);
-		assert(fscanf(infile, "%lu", &workload) == 1);
-		assert(fscanf(infile, "%d\n", &arrivtime) == 1);
+		if ((fscanf(infile, "%d", &real_id) != 1) ||
+			(fscanf(infile, "%lu", &workload) != 1) ||
+			(fscanf(infile, "%d\n", &arrivtime) != 1) ||
+			(arrivtime < 0))
+			return (workload_read_fail(w, errmsg, "bad task in workload file"));
 
-		array_tt t_addr = array_create(workload);
+		mem_tt t_addr = mem_create(workload, arena);
 
 		for ( unsigned long int j = 0; j < workload; j++ )
 		{
-			assert(fscanf(infile, "%lu\n", &addr) == 1);
-			struct mem *m = mem_create(addr);
-			array_set(t_addr, j, m);
-
+			if (fscanf(infile, "%lu\n", &addr) != 1)
+			{
+				mem_destroy(t_addr);
+				return (workload_read_fail(w, errmsg, "truncated workload file"));
+			}
+			mem_set_addr(t_addr, j, addr);
 		}
-		task_tt ts = task_create(real_id, workload, arrivtime);
+		task_tt ts = task_create(i, real_id, workload, arrivtime, arena);
 		task_set_memacc(ts, t_addr);
 
 		workload_set_task(w, i, ts);
@@ -580,6 +743,111 @@ struct workload *workload_read(FILE *infile, int ncores)
 	return (w);
 }
 
+/**
+ * @brief Reads a workload from a file, in binary format.
+ *
+ * The file is mapped into memory and tasks' memory accesses point
+ * straight into the mapping, so no parsing nor copying takes place.
+ * The mapping lives as long as the workload does.
+ *
+ * @param infile Input file.
+ * @param ncores Total number of working cores in Simulation.
+ * @param arena  Arena of tasks (NULL for the C library).
+ * @param errmsg Store location for what is wrong, on failure (may be NULL).
+ *
+ * @returns A workload, NULL if the file cannot be mapped or is malformed.
+ */
+struct workload *workload_read_binary(FILE *infile, int ncores, arena_tt arena, const char **errmsg)
+{
+	struct stat st;                        /* File status.     */
+	char *base;                            /* File mapping.    */
+	const struct workload_header *header;  /* File header.     */
+	const struct workload_record *records; /* Task records.    */
+	struct workload *w;                    /* Workload.        */
+	const char *failure = NULL;            /* What is wrong.   */
+
+	/* Sanity check. */
+	assert(infile != NULL);
+	assert(sizeof(unsigned long int) == sizeof(uint64_t));
+
+	if (fstat(fileno(infile), &st) < 0)
+		failure = "cannot stat workload file";
+	else if ((size_t) st.st_size < sizeof(struct workload_header))
+		failure = "bad workload file";
+	else if ((base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fileno(infile), 0)) == MAP_FAILED)
+		failure = "cannot map workload file";
+	if (failure != NULL)
+	{
+		if (errmsg != NULL)
+			*errmsg = failure;
+		return (NULL);
+	}
+
+	/* Check header. */
+	header = (const struct workload_header *) base;
+	if (header->magic != WORKLOAD_MAGIC)
+		failure = "bad workload file";
+	else if (header->version != WORKLOAD_VERSION)
+		failure = "unsupported workload file version";
+	else if (header->ntasks > (st.st_size - sizeof(struct workload_header))/sizeof(struct workload_record))
+		failure = "truncated workload file";
+	if (failure != NULL)
+	{
+		munmap(base, st.st_size);
+		if (errmsg != NULL)
+			*errmsg = failure;
+		return (NULL);
+	}
+
+	records = (const struct workload_record *) (base + sizeof(struct workload_header));
+
+	w = workload_alloc(header->ntasks, ncores, arena);
+	w->mapping = base;
+	w->mapping_size = st.st_size;
+
+	for (int i = 0; i < w->ntasks; i++)
+	{
+		const uint64_t *addrs;
+
+		if ((records[i].addrs % sizeof(uint64_t)) ||
+			(records[i].addrs > (uint64_t) st.st_size) ||
+			(records[i].work > (st.st_size - records[i].addrs)/sizeof(uint64_t)))
+			return (workload_read_fail(w, errmsg, "truncated workload file"));
+		if (records[i].arrival < 0)
+			return (workload_read_fail(w, errmsg, "bad task in workload file"));
+
+		addrs = (const uint64_t *) (base + records[i].addrs);
+
+		task_tt ts = task_create(i, records[i].real_id, records[i].work, records[i].arrival, arena);
+		task_set_memacc(ts, mem_wrap((const unsigned long int *) addrs, records[i].work, arena));
+
+		workload_set_task(w, i, ts);
+	}
+
+	return (w);
+}
+
+/**
+ * @brief Detects the format of a workload file.
+ *
+ * @param infile Input file.
+ *
+ * @returns The format of the input file.
+ */
+enum workload_format workload_detect_format(FILE *infile)
+{
+	uint32_t magic;
+
+	/* Sanity check. */
+	assert(infile != NULL);
+
+	if (fread(&magic, sizeof(uint32_t), 1, infile) != 1)
+		magic = 0;
+	rewind(infile);
+
+	return ((magic == WORKLOAD_MAGIC) ? WORKLOAD_BINARY : WORKLOAD_TEXT);
+}
+
 /**
  * @brief Returns the total number of tasks in a workload.
  *
@@ -736,6 +1004,25 @@ void workload_checktasks(struct workload *w, int g_i)
 	}
 }
 
+/**
+ * @brief Returns the arrival time of the next task that has not arrived yet.
+ * 
+ * @param w Target workload.
+ * 
+ * @returns Arrival time of the next task, INT_MAX if all tasks arrived.
+ */
+int workload_next_arrival(const struct workload *w)
+{
+	/* Sanity check. */
+	assert(w != NULL);
+
+	/* Tasks are sorted in arrival time. */
+	if ( queue_size(w->tasks) == 0 )
+		return (INT_MAX);
+
+	return (task_arrivaltime(queue_peek(w->tasks, 0)));
+}
+
 /**
  * @brief Returns the current total number of tasks left in our simulation.
  * 
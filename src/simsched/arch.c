@@ -0,0 +1,316 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include <mylib/util.h>
+
+#include <arch.h>
+#include <core.h>
+#include <mem.h>
+
+/**
+ * @brief Description of a core and its first level cache.
+ */
+struct arch_core
+{
+    int capacity;                      /**< Max number of tasks.      */
+    int cache_sets;                    /**< Number of cache sets.     */
+    int cache_ways;                    /**< Number of cache ways.     */
+    int num_blocks;                    /**< Number of blocks per way. */
+    const struct cache_policy *policy; /**< Cache replacement policy. */
+};
+
+/**
+ * @brief Description of an outer cache level.
+ */
+struct arch_level
+{
+    int cache_sets;                    /**< Number of cache sets.             */
+    int cache_ways;                    /**< Number of cache ways.             */
+    int num_blocks;                    /**< Number of blocks per way.         */
+    int latency;                       /**< Level's latency.                  */
+    bool shared;                       /**< Shared by all cores?              */
+    enum cache_inclusion inclusion;    /**< Inclusion w.r.t. the level above. */
+    const struct cache_policy *policy; /**< Cache replacement policy.         */
+};
+
+/**
+ * @brief Architecture description.
+ *
+ * @details Holds what an architecture file says, so that fresh cores
+ *          can be built from it for every simulation.
+ */
+struct arch
+{
+    int ncores;                  /**< Number of cores.              */
+    struct arch_core *cores;     /**< Cores.                        */
+    int nlevels;                 /**< Number of outer cache levels. */
+    struct arch_level *levels;   /**< Outer cache levels.           */
+    int tlb_entries;             /**< TLB entries (0 if no TLB).    */
+    int tlb_ways;                /**< TLB ways.                     */
+    int tlb_latency;             /**< TLB miss latency.             */
+    enum tlb_mode tlb_mode;      /**< TLB address space handling.   */
+    unsigned long int ram_size;  /**< RAM size (bytes).             */
+    unsigned long int page_size; /**< Page size (bytes).            */
+};
+
+/**
+ * @brief Creates an architecture description.
+ *
+ * @param ncores Number of cores. Each must be set with arch_set_core().
+ *
+ * @returns An architecture description, with default memory geometry,
+ *          no outer cache levels and no TLB.
+ */
+struct arch *arch_create(int ncores)
+{
+    struct arch *a;
+
+    /* Sanity check. */
+    assert(ncores > 0);
+
+    a = smalloc(sizeof(struct arch));
+    a->ncores = ncores;
+    a->cores = scalloc(ncores, sizeof(struct arch_core));
+    a->nlevels = 0;
+    a->levels = NULL;
+    a->tlb_entries = 0;
+    a->tlb_ways = 0;
+    a->tlb_latency = 0;
+    a->tlb_mode = TLB_ASID;
+    a->ram_size = DEFAULT_RAM_SIZE;
+    a->page_size = DEFAULT_PAGE_SIZE;
+
+    return (a);
+}
+
+/**
+ * @brief Destroys an architecture description.
+ *
+ * @param a Target architecture.
+ */
+void arch_destroy(struct arch *a)
+{
+    /* Sanity check. */
+    assert(a != NULL);
+
+    sfree(a->levels);
+    sfree(a->cores);
+    sfree(a);
+}
+
+/**
+ * @brief Describes a core.
+ *
+ * @param a          Target architecture.
+ * @param i          Core index.
+ * @param capacity   Max number of tasks.
+ * @param cache_sets Total number of cache sets.
+ * @param cache_ways Total number of cache ways.
+ * @param num_blocks Total number of blocks per cache way.
+ * @param policy     Cache replacement policy.
+ */
+void arch_set_core(struct arch *a, int i, int capacity, int cache_sets, int cache_ways, int num_blocks, const struct cache_policy *policy)
+{
+    /* Sanity check. */
+    assert(a != NULL);
+    assert((i >= 0) && (i < a->ncores));
+    assert(capacity > 0);
+    assert(cache_sets > 0);
+    assert(cache_ways > 0);
+    assert(num_blocks > 0);
+    assert(policy != NULL);
+
+    a->cores[i].capacity = capacity;
+    a->cores[i].cache_sets = cache_sets;
+    a->cores[i].cache_ways = cache_ways;
+    a->cores[i].num_blocks = num_blocks;
+    a->cores[i].policy = policy;
+}
+
+/**
+ * @brief Appends an outer cache level, below the existing ones.
+ *
+ * @param a          Target architecture.
+ * @param cache_sets Total number of cache sets.
+ * @param cache_ways Total number of cache ways.
+ * @param num_blocks Total number of blocks per cache way.
+ * @param latency    Level's latency.
+ * @param shared     Shared by all cores? Otherwise replicated for each one.
+ * @param inclusion  Inclusion relative to the level right above.
+ * @param policy     Cache replacement policy.
+ */
+void arch_add_level(struct arch *a, int cache_sets, int cache_ways, int num_blocks, int latency, bool shared, enum cache_inclusion inclusion, const struct cache_policy *policy)
+{
+    struct arch_level *l;
+
+    /* Sanity check. */
+    assert(a != NULL);
+    assert(cache_sets > 0);
+    assert(cache_ways > 0);
+    assert(num_blocks > 0);
+    assert(latency >= 0);
+    assert(policy != NULL);
+
+    a->levels = srealloc(a->levels, (a->nlevels + 1)*sizeof(struct arch_level));
+
+    l = &a->levels[a->nlevels++];
+    l->cache_sets = cache_sets;
+    l->cache_ways = cache_ways;
+    l->num_blocks = num_blocks;
+    l->latency = latency;
+    l->shared = shared;
+    l->inclusion = inclusion;
+    l->policy = policy;
+}
+
+/**
+ * @brief Gives every core's MMU a TLB.
+ *
+ * @param a       Target architecture.
+ * @param entries Number of entries.
+ * @param ways    Number of ways.
+ * @param latency Miss latency.
+ * @param mode    Address space handling.
+ */
+void arch_set_tlb(struct arch *a, int entries, int ways, int latency, enum tlb_mode mode)
+{
+    /* Sanity check. */
+    assert(a != NULL);
+    assert(entries > 0);
+    assert((ways > 0) && ((entries % ways) == 0));
+    assert(latency >= 0);
+
+    a->tlb_entries = entries;
+    a->tlb_ways = ways;
+    a->tlb_latency = latency;
+    a->tlb_mode = mode;
+}
+
+/**
+ * @brief Checks if cores have a TLB.
+ *
+ * @param a Target architecture.
+ *
+ * @returns True if cores have a TLB. False otherwise.
+ */
+bool arch_has_tlb(const struct arch *a)
+{
+    /* Sanity check. */
+    assert(a != NULL);
+
+    return (a->tlb_entries > 0);
+}
+
+/**
+ * @brief Sets the memory geometry.
+ *
+ * @param a         Target architecture.
+ * @param ram_size  RAM size (bytes).
+ * @param page_size Page size (bytes).
+ */
+void arch_set_memory(struct arch *a, unsigned long int ram_size, unsigned long int page_size)
+{
+    /* Sanity check. */
+    assert(a != NULL);
+    assert(page_size > 0);
+    assert(ram_size >= page_size);
+
+    a->ram_size = ram_size;
+    a->page_size = page_size;
+}
+
+/**
+ * @brief Returns the number of cores of an architecture.
+ *
+ * @param a Target architecture.
+ *
+ * @returns Number of cores.
+ */
+int arch_ncores(const struct arch *a)
+{
+    /* Sanity check. */
+    assert(a != NULL);
+
+    return (a->ncores);
+}
+
+/**
+ * @brief Returns the memory geometry of an architecture.
+ *
+ * @param a Target architecture.
+ * @param g Store location for the memory geometry.
+ */
+void arch_memory(const struct arch *a, struct mem_geometry *g)
+{
+    /* Sanity check. */
+    assert(a != NULL);
+    assert(g != NULL);
+
+    mem_geometry_init(g, a->ram_size, a->page_size);
+}
+
+/**
+ * @brief Builds the cores of an architecture.
+ *
+ * @param a      Target architecture.
+ * @param ncores Number of working cores, the first ones of the architecture.
+ * @param caches Store location for the caches shared by cores.
+ * @param arena  Arena of cores and caches (NULL for the C library).
+ *
+ * @returns Working cores.
+ */
+array_tt arch_cores(const struct arch *a, int ncores, queue_tt caches, arena_tt arena)
+{
+    array_tt cores;
+    struct mem_geometry g;
+
+    /* Sanity check. */
+    assert(a != NULL);
+    assert((ncores > 0) && (ncores <= a->ncores));
+    assert(caches != NULL);
+
+    arch_memory(a, &g);
+    cores = array_create_arena(ncores, arena);
+
+    for (int i = 0; i < ncores; i++)
+    {
+        const struct arch_core *ac = &a->cores[i];
+
+        /* Sanity check. */
+        assert(ac->policy != NULL);
+
+        array_set(cores, i, core_create(i, ac->capacity, ac->cache_sets, ac->cache_ways, ac->num_blocks, ac->policy, &g, arena));
+    }
+
+    /* Outer cache levels. */
+    for (int l = 0; l < a->nlevels; l++)
+    {
+        const struct arch_level *al = &a->levels[l];
+        cache_tt ce = NULL;
+
+        if (al->shared)
+        {
+            ce = cache_create(al->cache_sets, al->cache_ways, al->num_blocks, al->policy, &g, arena);
+            cache_set_inclusion(ce, al->inclusion);
+            queue_insert(caches, ce);
+        }
+        for (int i = 0; i < ncores; i++)
+        {
+            if (!al->shared)
+            {
+                ce = cache_create(al->cache_sets, al->cache_ways, al->num_blocks, al->policy, &g, arena);
+                cache_set_inclusion(ce, al->inclusion);
+            }
+            core_cache_add_level(array_get(cores, i), ce, al->latency, al->shared);
+        }
+    }
+
+    /* TLBs. */
+    if (a->tlb_entries > 0)
+    {
+        for (int i = 0; i < ncores; i++)
+            core_set_tlb(array_get(cores, i), tlb_create(a->tlb_entries, a->tlb_ways, a->tlb_latency, a->tlb_mode));
+    }
+
+    return (cores);
+}
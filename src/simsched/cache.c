@@ -1,482 +1,442 @@
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include <cache.h>
+#include <mylib/arena.h>
 #include <mylib/util.h>
-#include <mylib/map.h>
-
-/*====================================================================*
- * BLOCK                                                              *
- *====================================================================*/
+#include <mylib/counter.h>
 
 /**
- * @brief Cache way's block.
+ * @brief Size of a host cache line, in bytes.
  */
-struct block
-{
-    bool populated;   /**< Block populated atleast once? */
-    int num_of_words; /**< Number of words in block.     */
-    int initial_addr; /**< Block's initial word address. */
-    int final_addr;   /**< Block's final word address.   */
-
-};
+#define CACHE_LINE_SIZE 64
 
 /**
- * @brief Creates a new instace of cache_ways's block.
- * 
- * @returns Instace of cache_way's block.
+ * @brief Rounds a size up to a multiple of the host cache line size.
  */
-static inline struct block* block_create()
-{
-    struct block *b = smalloc(sizeof(struct block));
-    b->num_of_words = BLOCK_SIZE / WORD_SIZE;
-    b->initial_addr = -1;
-    b->final_addr = -1;
-    b->populated = false;
-
-    return b;
-}
+#define CACHE_LINE_ALIGN(x) \
+    (((x) + CACHE_LINE_SIZE - 1) & ~((size_t) CACHE_LINE_SIZE - 1))
 
 /**
- * @brief Returns if a cache_way's block was already popoulated, atleast once. 
- * 
- * @param b Target cache_way's block.
- * 
- * @returns True if cache_way's block was already popoulated. False otherwise.
+ * @brief Marks a block that was never populated.
  */
-static inline bool block_was_populated(const struct block *b)
-{
-    /* Sanity check. */
-    assert(b != NULL);
-    return (b->populated);
-}
+#define BLOCK_INVALID -1
 
 /**
- * @brief Populates a cache_way's block with an offset. Each cache_way's block has [num_of_words = (BLOCK_SIZE / WORD_SIZE)] words.
- * Initial address is calculated as: (offset/num_of_words) * num_of_words. Final address is: initial + (num_of_words).
- * 
- * @param b      Target cache_way's block.
- * @param offset Memory address's offset.
+ * @brief Core's cache.
+ *
+ * @details The backing store is kept in flat arrays indexed by
+ * (set * num_ways + way), all carved from a single cache-line-aligned
+ * allocation. A block is identified by its line, that is, its initial
+ * word address divided by the number of words in a block.
  */
-static inline void block_set_limits(struct block *b, int offset)
+struct cache
 {
-    /* Sanity check. */
-    assert(b != NULL);
-    b->populated = true;
-
-    b->initial_addr = ( (int) (offset/b->num_of_words) ) * b->num_of_words;
-    b->final_addr = b->initial_addr + b->num_of_words;
-}
+    int  num_sets;                      /**< Total number of cache sets.            */
+    int  num_ways;                      /**< Total number of cache ways.            */
+    int  num_blocks;                    /**< Total number of blocks in cache_way.   */
+    void *storage;                      /**< Backing allocation of all arrays.      */
+    unsigned long int *tags;            /**< Ways' tags.                            */
+    bool *valid;                        /**< Ways populated atleast once?           */
+    int *next_block;                    /**< Next block to be replaced in each way. */
+    uint64_t *meta;                     /**< Replacement metadata of each set.      */
+    int *blocks;                        /**< Lines held by each way's blocks.       */
+    const struct cache_policy *policy;  /**< Replacement policy of cache ways.      */
+    uint64_t seed;                      /**< Random state of replacement policy.    */
+    struct mem_geometry geometry;       /**< Geometry of the memory cached.         */
+    arena_tt arena;                     /**< Arena of the cache (may be NULL).      */
+    enum cache_inclusion inclusion;     /**< Inclusion policy towards inner caches. */
+    struct cache **inners;              /**< Inner caches.                          */
+    int ninners;                        /**< Number of inner caches.                */
+    counter_tt sets_accesses;           /**< Number of tasks that acessed each set. */ 
+    counter_tt sets_conflicts;          /**< Total number of conflicts in each set. */
+};
 
 /**
- * @brief Checks if specified offset is in block's limits.
- * 
- * @param b      Target cache_way's block.
- * @param offset Memory address's offset.
+ * @brief Creates a new instance of cache.
  * 
- * @returns True if offset is in block's limits. False otherwise.
- */
-static inline bool block_check_offset(const struct block *b, int offset)
-{
-    /* Sanity check. */
-    assert(b != NULL);
-    if ( !b->populated ) return false;
-    return (b->initial_addr <= offset && offset < b->final_addr);
-}
-
-/**
- * @brief Destroys a instace of cache_ways's block.
+ * @param num_sets   Total number of sets in cache   
+ * @param num_ways   Total number of ways in cache_set
+ * @param num_blocks Total number of blocks in cache_way
+ * @param policy     Replacement policy of cache ways.
+ * @param geometry   Geometry of the memory cached.
+ * @param arena      Arena to allocate from (NULL for the C library).
  * 
- * @param b Target block.
+ * @returns Cache instance.
  */
-static inline void block_destroy(struct block *b)
+cache_tt cache_create(int num_sets, int num_ways, int num_blocks, const struct cache_policy *policy, const struct mem_geometry *geometry, arena_tt arena)
 {
     /* Sanity check. */
-    assert(b != NULL);
-    free(b);
-}
-
-
-
-/*====================================================================*
- * CACHE WAY                                                          *
- *====================================================================*/
+    assert(num_sets > 0);
+    assert(num_ways > 0);
+    assert(num_blocks > 0);
+    assert(policy != NULL);
+    assert(policy->supports(num_ways));
+    assert(geometry != NULL);
 
-/**
- * @brief Cache way
- */
-struct cache_way
-{
-    bool populated;        /**< Way populated atleas once? */
-    unsigned long int tag; /**< Way's tag.                 */
-    int num_blocks;        /**< Way's number of blocks.    */
-    struct block **blocks; /**< Way's blocks.              */
-    int next_block;        /**< Next block to be replaced. */
-};
+    struct cache *ce = arena_smalloc(arena, sizeof(struct cache));
+    ce->num_sets = num_sets;
+    ce->num_ways = num_ways;
+    ce->num_blocks = num_blocks;
+    ce->policy = policy;
+    ce->seed = 0x9e3779b97f4a7c15ULL;
+    ce->geometry = *geometry;
+    ce->arena = arena;
+    ce->inclusion = CACHE_INCLUSIVE;
+    ce->inners = NULL;
+    ce->ninners = 0;
+    ce->sets_accesses = counter_create(num_sets);
+    ce->sets_conflicts = counter_create(num_sets);
+
+    size_t nways = (size_t) num_sets * num_ways;
+    size_t tags_size = CACHE_LINE_ALIGN(sizeof(unsigned long int) * nways);
+    size_t valid_size = CACHE_LINE_ALIGN(sizeof(bool) * nways);
+    size_t next_block_size = CACHE_LINE_ALIGN(sizeof(int) * nways);
+    size_t meta_size = CACHE_LINE_ALIGN(sizeof(uint64_t) * num_sets);
+    size_t blocks_size = CACHE_LINE_ALIGN(sizeof(int) * nways * num_blocks);
+
+    /* Over-allocate so that the first array starts on a cache line. */
+    ce->storage = arena_smalloc(ce->arena, CACHE_LINE_SIZE + tags_size + valid_size + next_block_size + meta_size + blocks_size);
+    char *p = (char *) CACHE_LINE_ALIGN((uintptr_t) ce->storage);
+
+    ce->tags = (unsigned long int *) p;  p += tags_size;
+    ce->valid = (bool *) p;              p += valid_size;
+    ce->next_block = (int *) p;          p += next_block_size;
+    ce->meta = (uint64_t *) p;           p += meta_size;
+    ce->blocks = (int *) p;
+
+    for ( size_t i = 0; i < nways; i++ )
+    {
+        ce->tags[i] = 0;
+        ce->valid[i] = false;
+        ce->next_block[i] = 0;
+    }
+    for ( int i = 0; i < num_sets; i++ )
+        ce->meta[i] = policy->init(num_ways);
+    for ( size_t i = 0; i < nways * num_blocks; i++ )
+        ce->blocks[i] = BLOCK_INVALID;
 
-/**
- * @brief Creates a new instance of a cache_way.
- * 
- * @param num_blocks Way's number of blocks.
- * 
- * @returns New instance of cache_way
- */
-static inline struct cache_way* cache_way_create(int num_blocks)
-{
-    /* Sanity check. */
-    assert(num_blocks > 0); 
-    struct cache_way *cw = smalloc(sizeof(struct cache_way));
-    cw->tag = 0;
-    cw->num_blocks = num_blocks;
-    cw->populated = false;
-    cw->next_block = 0;
-    cw->blocks = smalloc(sizeof(struct block*) * cw->num_blocks);
-    
-    for ( int i = 0; i < cw->num_blocks; i++ )
-        cw->blocks[i] = block_create();
-    
-    return cw;
+    return ce;
 }
 
 /**
- * @brief Returns cache_way's tag.
+ * @brief Searchs a cache set for a way that has the same tag as "tag".
  * 
- * @param cw Target cache_way.
+ * @param ce  Target cache.
+ * @param set Target set.
+ * @param tag Desired tag.
  * 
- * @returns Cache_way's tag.
+ * @returns If found, returns the flat index (set * num_ways + way) of the way. -1, otherwise.
  */
-static inline unsigned long int cache_way_tag(const struct cache_way *cw)
+static inline int cache_find_way(const struct cache *ce, int set, unsigned long int tag)
 {
-    /* Sanity check. */
-    assert(cw != NULL);
-    return (cw->tag);
+    int first = set * ce->num_ways;
+    int last = first + ce->num_ways;
+
+    for ( int i = first; i < last; i++ )
+    {
+        if ( ce->valid[i] && ce->tags[i] == tag ) return i;
+    }
+    return -1;
 }
 
 /**
- * @brief Returns cache_way's total number of blocks.
+ * @brief Searchs a cache set for a way that was never populated.
  * 
- * @param cw Target cache_way.
+ * @param ce  Target cache.
+ * @param set Target set.
  * 
- * @returns Cache_way's total number of blocks.
+ * @returns If found, returns the way index within the set. -1, otherwise.
  */
-static inline int cache_way_num_blocks(const struct cache_way *cw)
+static inline int cache_find_invalid(const struct cache *ce, int set)
 {
-    /* Sanity check. */
-    assert(cw != NULL);
-    return (cw->num_blocks);
+    const bool *valid = &ce->valid[set * ce->num_ways];
+
+    for ( int i = 0; i < ce->num_ways; i++ )
+    {
+        if ( !valid[i] ) return i;
+    }
+    return -1;
 }
 
 /**
- * @brief Sets cache_way's tag.
+ * @brief Replaces the next "count" blocks of a way, in round-robin order, with a line.
  * 
- * @param cw  Target cache_way.
- * @param tag Desired tag.
+ * @param ce    Target cache.
+ * @param way   Flat index of target way.
+ * @param line  New line.
+ * @param count Number of consecutive block replacements.
  */
-static inline void cache_way_set_tag(struct cache_way *cw, unsigned long int tag)
+static inline void cache_replace_blocks(struct cache *ce, int way, int line, int count)
 {
-    /* Sanity check. */
-    assert(cw != NULL);
-    cw->tag = tag;
+    int *blocks = &ce->blocks[way * ce->num_blocks];
+    int next = ce->next_block[way];
+
+    /* Replacing a block more than once per round is the same as replacing it once. */
+    for ( int i = 0; i < count && i < ce->num_blocks; i++ )
+        blocks[(next + i) % ce->num_blocks] = line;
+
+    ce->valid[way] = true;
+    ce->next_block[way] = (next + count) % ce->num_blocks;
 }
 
 /**
- * @brief Returns if a cache_way was already popoulated, atleast once. 
- * 
- * @param cw Target cache_way.
+ * @brief Invalidates a way and all of its blocks.
  * 
- * @returns True if cache_way was already popoulated. False otherwise.
+ * @param ce  Target cache.
+ * @param way Flat index of target way.
  */
-static inline bool cache_way_was_populated(const struct cache_way *cw)
+static inline void cache_invalidate_way(struct cache *ce, int way)
 {
-    /* Sanity check. */
-    assert(cw != NULL);
-    return (cw->populated);
+    ce->valid[way] = false;
+    for ( int i = 0; i < ce->num_blocks; i++ )
+        ce->blocks[way * ce->num_blocks + i] = BLOCK_INVALID;
 }
 
 /**
- * @brief Replace an old block with a new one. The new one is populated with the new offset.
+ * @brief Invalidates the way that holds a tag, if any, in a cache and in
+ * all of its inner caches.
  * 
- * @param cw     Target cache_way.
- * @param index  Block's index to be replaced.
- * @param offset Memory address's offset. 
+ * @param ce  Target cache.
+ * @param tag Target tag.
  */
-static inline void cache_way_replace_block(struct cache_way *cw, int index, int offset)
+static void cache_invalidate(struct cache *ce, unsigned long int tag)
 {
-    /* Sanity check. */
-    assert(cw != NULL);
-    assert(index < cw->num_blocks);
-    assert(offset >= 0);
+    int way = cache_find_way(ce, tag % ce->num_sets, tag);
 
-    cw->populated = true;
-    block_set_limits(cw->blocks[index], offset);
-    cw->next_block = (cw->next_block + 1) % cw->num_blocks;
+    if ( way != -1 )
+        cache_invalidate_way(ce, way);
+
+    for ( int i = 0; i < ce->ninners; i++ )
+        cache_invalidate(ce->inners[i], tag);
 }
 
-/** 
- * @brief Checks if a specified offset access a valid word in any way's block.
+/**
+ * @brief Fills a way of a cache set with a new tag. The way is chosen by the
+ * replacement policy and all of its blocks are populated with consecutive lines.
  * 
- * @param cw     Target cache_way.
- * @param offset Memory address's offset.
+ * @param ce     Target cache.
+ * @param set    Target set.
+ * @param tag    New tag.
+ * @param line   Line of the first block.
+ * @param victim Store location for the evicted way (may be NULL).
  * 
- * @returns True if offset is valid. False otherwise.
+ * @returns Flat index of filled way.
  */
-static inline bool cache_way_block_has_word(const struct cache_way *cw, int offset)
-{   
-    /* Sanity check. */
-    assert(cw != NULL);
-    assert(offset >= 0);
+static int cache_fill(struct cache *ce, int set, unsigned long int tag, int line, struct cache_victim *victim)
+{
+    const struct cache_policy *policy = ce->policy;
 
-    if ( !cw->populated ) return false;
+    int index = (policy->fill_invalid) ? cache_find_invalid(ce, set) : -1;
+    if ( index == -1 )
+        index = policy->victim(&ce->meta[set], ce->num_ways, &ce->seed);
+    cache_set_conflicts_update(ce, set);
 
-    for ( int i = 0; i < cw->num_blocks; i++ )
-    {
-        if ( !block_was_populated(cw->blocks[i]) ) continue;
-        if ( block_check_offset(cw->blocks[i], offset) ) return true;
-    }
-    return false;
-}
+    int way = set * ce->num_ways + index;
 
-/**
- * @brief Destroys a instance of cache_way.
- * 
- * @param cw Target cache_way.
- */
-static inline void cache_way_destroy(struct cache_way *cw)
-{   
-    /* Sanity check. */
-    assert(cw != NULL);
-    for ( int i = 0; i < cw->num_blocks; i++ )
-        block_destroy(cw->blocks[i]);
-    free(cw);
-}
+    if ( ce->valid[way] )
+    {
+        if ( victim != NULL )
+        {
+            victim->valid = true;
+            victim->tag = ce->tags[way];
+            victim->line = ce->blocks[way * ce->num_blocks];
+        }
 
+        /* Inner caches may not keep what is no longer here. */
+        if ( ce->inclusion == CACHE_INCLUSIVE )
+        {
+            for ( int i = 0; i < ce->ninners; i++ )
+                cache_invalidate(ce->inners[i], ce->tags[way]);
+        }
+    }
 
-/*====================================================================*
- * CACHE SET                                                          *
- *====================================================================*/
+    ce->tags[way] = tag;
+    for ( int i = 0; i < ce->num_blocks; i++ )
+        ce->blocks[way * ce->num_blocks + i] = line + i;
+    ce->valid[way] = true;
+    if ( policy->fill != NULL )
+        policy->fill(&ce->meta[set], ce->num_ways, index, &ce->seed);
 
-struct cache_set
-{
-    int index;               /**< Set's index.              */
-    int num_ways;            /**< Set's number of ways.     */
-    struct cache_way **ways; /**< Set's ways.               */
-    int next_way;            /**< Next wayt to be replaced. */
-};
+    return (way);
+}
 
 /**
- * @brief Creates a new instance of a cache_set.
+ * @brief Checks a specified address's index (cache set). 
+ * Then, check if any way has the same address' tag.
+ * If found, check if any block has the desired word.
+ * On a hit, the replacement policy is notified.
  * 
- * @param index      Set index.
- * @param num_ways   Number of ways in a cache set.
- * @param num_blocks Number of blocks in a cache way.
+ * @param ce  Target cache instance.
+ * @param mem Target memory addresses.
+ * @param idx Index of target memory address.
  * 
- * @returns New instance of a cache_set.
+ * @returns True if cache hit. False otherwise.
  */
-static inline struct cache_set* cache_set_create(int index, int num_ways, int num_blocks)
+bool cache_check_addr(struct cache *ce, const struct mem *mem, unsigned long int idx)
 {
     /* Sanity check. */
-    assert(index >= 0);
-    assert(num_ways > 0);
+    assert(ce != NULL);
+    assert(mem != NULL);
 
-    struct cache_set *cs = smalloc(sizeof(struct cache_set));
-    cs->index = index;
-    cs->num_ways = num_ways;
-    cs->next_way = 0;
-    cs->ways = smalloc(sizeof(struct cache_way*) * num_ways);
+    /* Which set it was mapped to. */
+    unsigned long int tag = mem_physical_addr(mem, idx) * ce->geometry.page_size;
+    int line = mem_addr_offset(mem, idx, &ce->geometry) / (BLOCK_SIZE / WORD_SIZE);
+    int cache_set = tag % ce->num_sets;
 
-    for ( int i = 0; i < cs->num_ways; i++ )
-        cs->ways[i] = cache_way_create(num_blocks);
+    int way = cache_find_way(ce, cache_set, tag);
+    if ( way == -1 ) return false;
 
-    return cs;
+    // Checking if cache_way's blocks has the desired word. If not, we will consider it as a cache miss aswell.
+    const int *blocks = &ce->blocks[way * ce->num_blocks];
+    for ( int i = 0; i < ce->num_blocks; i++ )
+    {
+        if ( blocks[i] == line )
+        {
+            if ( ce->policy->hit != NULL )
+                ce->policy->hit(&ce->meta[cache_set], ce->num_ways, way - cache_set * ce->num_ways);
+            return true;
+        }
+    }
+    return false;
 }
 
 /**
- * @brief Searchs for a way that has the same tag as "tag". 
+ * @brief Replacement is necessary only when a cache miss occurred. 
+ * We must identify if it ocurred because of "way" not found or because "block" not found, and replace the "guilty" one.
  * 
- * @param cs  Target cache_set.
- * @param tag Desired tag.
+ * @details The original model repeated the replacement once per way in
+ * the set. That behavior is preserved, in a single pass: when the way is
+ * missing, the victim chosen by the replacement policy is replaced and
+ * the remaining (num_ways - 1) rounds replace blocks in it; otherwise,
+ * all num_ways rounds replace blocks.
  * 
- * @returns If found, returns cache_way index. -1, otherwise.
+ * @param ce     Target cache instance.
+ * @param mem    Target memory addresses.
+ * @param idx    Index of target memory address to replace.
+ * @param victim Store location for the evicted way (may be NULL).
  */
-static inline int cache_set_find_way(const struct cache_set *cs, unsigned long int tag)
+void cache_replace(struct cache *ce, const struct mem *mem, unsigned long int idx, struct cache_victim *victim)
 {
     /* Sanity check. */
-    assert(cs != NULL);
+    assert(ce != NULL);
+    assert(mem != NULL);
+
+    /* Which set it was mapped to. */
+    unsigned long int tag = mem_physical_addr(mem, idx) * ce->geometry.page_size;
+    int line = mem_addr_offset(mem, idx, &ce->geometry) / (BLOCK_SIZE / WORD_SIZE);
+    int cache_set = tag % ce->num_sets;
+    int rounds = ce->num_ways;
 
-    for ( int i = 0; i < cs->num_ways; i++ )
+    if ( victim != NULL )
+        victim->valid = false;
+
+    /* 
+        First, check if "ways" were the guilties by comparing way's tags.
+        If way found, it means that the problem were the blocks. Otherwise, the problem were the ways.
+    */
+    int way = cache_find_way(ce, cache_set, tag);
+
+    // Way not found.
+    if ( way == -1 )
     {
-        if ( !cache_way_was_populated(cs->ways[i]) ) continue;
-        if ( tag == cache_way_tag(cs->ways[i]) ) return i;
+        way = cache_fill(ce, cache_set, tag, line, victim);
+        rounds--;
     }
-    return -1;
+    // Way found.
+    else if ( ce->policy->hit != NULL )
+        ce->policy->hit(&ce->meta[cache_set], ce->num_ways, way - cache_set * ce->num_ways);
+
+    cache_replace_blocks(ce, way, line, rounds);
 }
 
 /**
- * @brief Replace an old way with a new one. The new one is populated with
- * the new tag and all blocks are populated with different offsets.
+ * @brief Inserts a way evicted from an inner cache.
  * 
- * @param cw     Target cache_way.
- * @param index  Way's index to be replaced.
- * @param tag    New tag.
- * @param offset Memory address's offset. 
+ * @param ce      Target cache instance.
+ * @param evicted Way evicted from an inner cache.
+ * @param victim  Store location for the way evicted from this cache (may be NULL).
  */
-static inline void cache_set_replace_way(struct cache_set *cs, int index, unsigned long int tag, int offset)
+void cache_insert(struct cache *ce, const struct cache_victim *evicted, struct cache_victim *victim)
 {
     /* Sanity check. */
-    assert(cs != NULL);
-    assert(index < cs->num_ways);
-    assert(offset >= 0);
-
-    int num_blocks = cache_way_num_blocks(cs->ways[index]);
-    int num_of_words = BLOCK_SIZE / WORD_SIZE;
-    cache_way_set_tag(cs->ways[index], tag);
-    for ( int i = 0; i < num_blocks; i++ )
-        cache_way_replace_block(cs->ways[index], i, offset + (num_of_words * i) );
-    cs->next_way = (cs->next_way + 1) % cs->num_ways;
+    assert(ce != NULL);
+    assert(evicted != NULL);
+    assert(evicted->valid);
+
+    int cache_set = evicted->tag % ce->num_sets;
+
+    if ( victim != NULL )
+        victim->valid = false;
+
+    if ( cache_find_way(ce, cache_set, evicted->tag) == -1 )
+        cache_fill(ce, cache_set, evicted->tag, evicted->line, victim);
 }
 
 /**
- * @brief Destroys a cache_set instance.
+ * @brief Removes the way that holds a specified address from a cache,
+ * because it moved to an inner cache.
  * 
- * @param ce Target cache_set.
+ * @param ce  Target cache instance.
+ * @param mem Target memory addresses.
+ * @param idx Index of target memory address.
  */
-static inline void cache_set_destroy(struct cache_set *cs)
+void cache_extract(struct cache *ce, const struct mem *mem, unsigned long int idx)
 {
     /* Sanity check. */
-    assert(cs != NULL);
-    for ( int i = 0; i < cs->num_ways; i++ )
-        cache_way_destroy(cs->ways[i]);
-    free(cs);
-}
-
-
+    assert(ce != NULL);
+    assert(mem != NULL);
 
-/*====================================================================*
- * CACHE                                                              *
- *====================================================================*/
+    unsigned long int tag = mem_physical_addr(mem, idx) * ce->geometry.page_size;
+    int way = cache_find_way(ce, tag % ce->num_sets, tag);
 
-/**
- * @brief Core's cache.
- */
-struct cache
-{
-    int  num_sets;           /**< Total number of cache sets.            */
-    int  num_ways;           /**< Total number of cache ways.            */
-    int  num_blocks;         /**< Total number of blocks in cache_way.   */
-    struct cache_set **sets; /**< Cache sets.                            */
-    map_tt sets_accesses;    /**< Number of tasks that acessed each set. */ 
-    map_tt sets_conflicts;   /**< Total number of conflicts in each set. */
-};
+    if ( way != -1 )
+        cache_invalidate_way(ce, way);
+}
 
 /**
- * @brief Creates a new instance of cache.
- * 
- * @param num_sets   Total number of sets in cache   
- * @param num_ways   Total number of ways in cache_set
- * @param num_blocks Total number of blocks in cache_way
+ * @brief Attaches an inner cache to an outer one.
  * 
- * @returns Cache instance.
+ * @param outer Target outer cache.
+ * @param inner Target inner cache.
  */
-cache_tt cache_create(int num_sets, int num_ways, int num_blocks)
+void cache_attach(struct cache *outer, struct cache *inner)
 {
     /* Sanity check. */
-    assert(num_sets > 0);
-    assert(num_ways > 0);
-    assert(num_blocks > 0);
+    assert(outer != NULL);
+    assert(inner != NULL);
+    assert(outer != inner);
 
-    struct cache *ce = smalloc(sizeof(struct cache));
-    ce->num_sets = num_sets;
-    ce->num_ways = num_ways;
-    ce->num_blocks = num_blocks;
-    ce->sets = smalloc(sizeof(struct cache_set*) * ce->num_sets);
-    ce->sets_accesses = map_create(map_compare_int);
-    ce->sets_conflicts = map_create(map_compare_int);
-
-    for ( int i = 0; i < ce->num_sets; i++ )
-        ce->sets[i] = cache_set_create(i, ce->num_ways, ce->num_blocks);        
-    
-    return ce;
+    outer->inners = srealloc(outer->inners, sizeof(struct cache *) * (outer->ninners + 1));
+    outer->inners[outer->ninners++] = inner;
 }
 
 /**
- * @brief Checks a specified address's index (cache set). 
- * Then, check if any way has the same address' tag.
- * If found, check if any block has the desired word.
+ * @brief Sets the inclusion policy of a cache towards its inner caches.
  * 
- * @param ce  Target cache instance.
- * @param mem Target memory address.
- * 
- * @returns True if cache hit. False otherwise.
+ * @param ce        Target cache.
+ * @param inclusion Inclusion policy.
  */
-bool cache_check_addr(const struct cache *ce, struct mem *mem)
+void cache_set_inclusion(struct cache *ce, enum cache_inclusion inclusion)
 {
     /* Sanity check. */
     assert(ce != NULL);
-    assert(mem != NULL);
-    bool found = false;
-
-    /* Which set it was mapped to. */
-    unsigned long int tag = mem_physical_addr(mem) * PAGE_SIZE;
-    int mem_offset = mem_addr_offset(mem);
-    int cache_set = tag % ce->num_sets;
-    struct cache_set *cs = ce->sets[cache_set];
-
-    /* Searching */
-    for ( int i = 0; i < ce->num_ways; i++ )
-    {
-        int index = cache_set_find_way(cs, tag);
-        if ( index != -1 )
-        {
-            struct cache_way *cw = cs->ways[index]; 
-            // Checking if cache_way's blocks has the desired word. If not, we will consider it as a cache miss aswell.
-            if ( cache_way_block_has_word(cw, mem_offset) ) found = true;
-        } else found = false;
-    }
-
-    return found;
+    ce->inclusion = inclusion;
 }
 
 /**
- * @brief Replacement is necessary only when a cache miss occurred. 
- * We must identify if it ocurred because of "way" not found or because "block" not found, and replace the "guilty" one.
+ * @brief Returns the inclusion policy of a cache towards its inner caches.
  * 
- * @param ce  Target cache instance.
- * @param mem Target memory address to replace.
+ * @param ce Target cache.
+ * 
+ * @returns Cache's inclusion policy.
  */
-void cache_replace(struct cache *ce, struct mem *mem)
+enum cache_inclusion cache_inclusion(const struct cache *ce)
 {
     /* Sanity check. */
     assert(ce != NULL);
-    assert(mem != NULL);
-
-    /* Which set it was mapped to. */
-    unsigned long int tag = mem_physical_addr(mem) * PAGE_SIZE;
-    int mem_offset = mem_addr_offset(mem);
-    int cache_set = tag % ce->num_sets;
-    struct cache_set *cs = ce->sets[cache_set];
-
-    for ( int i = 0; i < ce->num_ways; i++ )
-    {
-        /* 
-            First, check if "ways" were the guilties by comparing way's tags.
-            If way found, it means that the problem were the blocks. Otherwise, the problem were the ways.
-        */
-       int index = cache_set_find_way(cs, tag);
-       // Way found.
-       if ( index != -1 )
-       {
-            struct cache_way *cw = cs->ways[index]; 
-            cache_way_replace_block(cw, cw->next_block, mem_offset);
-       }
-       // Way not found.
-       else
-       {
-            cs->next_way = (cs->next_way + 1) % cs->num_ways;
-            cache_set_conflicts_update(ce, cache_set);
-            cache_set_replace_way(cs, cs->next_way, tag, mem_offset);
-       }
-
-    }
+    return (ce->inclusion);
 }
 
 /**
@@ -495,13 +455,13 @@ int cache_num_sets(const struct cache *ce)
 }
 
 /**
- * @brief Returns the map that controls the number of tasks that has, in last iteration, acessed each cache's set.
+ * @brief Returns the counter of the number of tasks that has, in last iteration, acessed each cache's set.
  * 
  * @param ce Target cache.
  * 
- * @returns Cache's map of set's accesses.
+ * @returns Cache's counter of set's accesses.
  */
-map_tt cache_set_accesses(const struct cache *ce)
+counter_tt cache_set_accesses(const struct cache *ce)
 {
     /* Sanity check. */
     assert(ce != NULL);
@@ -509,13 +469,13 @@ map_tt cache_set_accesses(const struct cache *ce)
 }
 
 /**
- * @brief Returns the map that controls the number conflicts, in the last iteration, in each cache's set.
+ * @brief Returns the counter of the number conflicts, in the last iteration, in each cache's set.
  * 
  * @param ce Target cache.
  * 
- * @returns Cache's map of set's conflicts.
+ * @returns Cache's counter of set's conflicts.
  */
-map_tt cache_set_conflicts(const struct cache *ce)
+counter_tt cache_set_conflicts(const struct cache *ce)
 {
     /* Sanity check. */
     assert(ce != NULL);
@@ -533,14 +493,11 @@ void cache_set_accesses_update(struct cache *ce, int set)
     /* Sanity check. */
     assert(ce != NULL);
 
-    // If value is negative, we reset the map
+    // If value is negative, we reset the counter
     if ( set < 0 )
-    {
-        map_destroy(ce->sets_accesses);
-        ce->sets_accesses = map_create(map_compare_int);
-    }
+        counter_clear(ce->sets_accesses);
     else 
-        map_insert(ce->sets_accesses, &set);
+        counter_increment(ce->sets_accesses, set);
 }
 
 /**
@@ -555,12 +512,9 @@ void cache_set_conflicts_update(struct cache *ce, int set)
     assert(ce != NULL);
     
     if ( set < 0 )
-    {
-        map_destroy(ce->sets_conflicts);
-        ce->sets_conflicts = map_create(map_compare_int);
-    }
+        counter_clear(ce->sets_conflicts);
     else 
-        map_insert(ce->sets_conflicts, &set);
+        counter_increment(ce->sets_conflicts, set);
 }
 
 /**
@@ -572,11 +526,9 @@ void cache_destroy(struct cache *ce)
 {
     /* Sanity check. */
     assert(ce != NULL);
-    for ( int i = 0; i < ce->num_sets; i++ )
-    {
-        cache_set_destroy(ce->sets[i]);
-    }
-    map_destroy(ce->sets_accesses);
-    map_destroy(ce->sets_conflicts);
-    free(ce);
+    arena_sfree(ce->arena, ce->storage);
+    sfree(ce->inners);
+    counter_destroy(ce->sets_accesses);
+    counter_destroy(ce->sets_conflicts);
+    arena_sfree(ce->arena, ce);
 }
\ No newline at end of file
@@ -0,0 +1,421 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <cache.h>
+
+/**
+ * @brief Draws the next number of a xorshift64 sequence.
+ * 
+ * @param seed Target sequence state.
+ * 
+ * @returns Next number of the sequence.
+ */
+static inline uint64_t cache_policy_rand(uint64_t *seed)
+{
+    /* Sanity check. */
+    assert(seed != NULL);
+    assert(*seed != 0);
+
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 7;
+    *seed ^= *seed << 17;
+
+    return (*seed);
+}
+
+/**
+ * @brief Checks if a cache set of any size is supported.
+ * 
+ * @param num_ways Number of ways in a cache set.
+ * 
+ * @returns True if "num_ways" is positive. False otherwise.
+ */
+static bool cache_policy_supports_any(int num_ways)
+{
+    return (num_ways > 0);
+}
+
+/**
+ * @brief Initial metadata of policies without per-set state.
+ * 
+ * @param num_ways Number of ways in a cache set.
+ * 
+ * @returns Zero.
+ */
+static uint64_t cache_policy_init_zero(int num_ways)
+{
+    ((void) num_ways);
+    return (0);
+}
+
+/*====================================================================*
+ * FIFO                                                               *
+ *====================================================================*/
+
+/*
+ * Metadata holds the round-robin cursor of the set. The way right after
+ * the cursor is replaced and the cursor then moves past it, as the
+ * original cache model did.
+ */
+
+/**
+ * @brief Updates the FIFO cursor after a way fill.
+ */
+static void fifo_fill(uint64_t *meta, int num_ways, int way, uint64_t *seed)
+{
+    ((void) seed);
+    *meta = (way + 1) % num_ways;
+}
+
+/**
+ * @brief Chooses the FIFO victim way.
+ */
+static int fifo_victim(uint64_t *meta, int num_ways, uint64_t *seed)
+{
+    ((void) seed);
+    return ((*meta + 1) % num_ways);
+}
+
+/*====================================================================*
+ * LRU                                                                *
+ *====================================================================*/
+
+/*
+ * Metadata holds a 4-bit recency rank per way: 0 is the most recently
+ * used way and (num_ways - 1) is the least recently used one.
+ */
+
+#define LRU_BITS 4                          /**< Bits per way.      */
+#define LRU_MASK ((1u << LRU_BITS) - 1)     /**< Rank mask.         */
+#define LRU_RANK(m, w) (((m) >> ((w) * LRU_BITS)) & LRU_MASK) /**< Rank of a way. */
+
+/**
+ * @brief Checks if LRU supports a number of ways.
+ */
+static bool lru_supports(int num_ways)
+{
+    return (num_ways > 0 && num_ways <= (int) (64 / LRU_BITS));
+}
+
+/**
+ * @brief Initial LRU metadata: way i has rank i.
+ */
+static uint64_t lru_init(int num_ways)
+{
+    uint64_t meta = 0;
+
+    for ( int i = 0; i < num_ways; i++ )
+        meta |= (uint64_t) i << (i * LRU_BITS);
+
+    return (meta);
+}
+
+/**
+ * @brief Makes a way the most recently used one.
+ */
+static void lru_hit(uint64_t *meta, int num_ways, int way)
+{
+    uint64_t m = *meta;
+    uint64_t rank = LRU_RANK(m, way);
+
+    for ( int i = 0; i < num_ways; i++ )
+    {
+        if ( LRU_RANK(m, i) < rank )
+            m += (uint64_t) 1 << (i * LRU_BITS);
+    }
+    m &= ~((uint64_t) LRU_MASK << (way * LRU_BITS));
+
+    *meta = m;
+}
+
+/**
+ * @brief Makes a filled way the most recently used one.
+ */
+static void lru_fill(uint64_t *meta, int num_ways, int way, uint64_t *seed)
+{
+    ((void) seed);
+    lru_hit(meta, num_ways, way);
+}
+
+/**
+ * @brief Chooses the least recently used way.
+ */
+static int lru_victim(uint64_t *meta, int num_ways, uint64_t *seed)
+{
+    ((void) seed);
+
+    for ( int i = 0; i < num_ways; i++ )
+    {
+        if ( LRU_RANK(*meta, i) == (uint64_t) (num_ways - 1) )
+            return (i);
+    }
+
+    /* Never gets here. */
+    assert(0);
+    return (0);
+}
+
+/*====================================================================*
+ * TREE-PLRU                                                          *
+ *====================================================================*/
+
+/*
+ * Metadata holds the (num_ways - 1) nodes of a binary tree, in heap
+ * order: bit n is node n, starting at 1. A clear bit points to the left
+ * subtree and a set bit to the right one.
+ */
+
+/**
+ * @brief Checks if tree-PLRU supports a number of ways.
+ */
+static bool plru_supports(int num_ways)
+{
+    return (num_ways > 0 && num_ways <= 64 && (num_ways & (num_ways - 1)) == 0);
+}
+
+/**
+ * @brief Points all nodes on the path to a way away from it.
+ */
+static void plru_hit(uint64_t *meta, int num_ways, int way)
+{
+    for ( int n = way + num_ways; n > 1; n >>= 1 )
+    {
+        uint64_t bit = (uint64_t) 1 << (n >> 1);
+
+        /* Left child: point right. Right child: point left. */
+        if ( n & 1 )
+            *meta &= ~bit;
+        else
+            *meta |= bit;
+    }
+}
+
+/**
+ * @brief Points all nodes on the path to a filled way away from it.
+ */
+static void plru_fill(uint64_t *meta, int num_ways, int way, uint64_t *seed)
+{
+    ((void) seed);
+    plru_hit(meta, num_ways, way);
+}
+
+/**
+ * @brief Follows the tree nodes to the pseudo least recently used way.
+ */
+static int plru_victim(uint64_t *meta, int num_ways, uint64_t *seed)
+{
+    int n = 1;
+
+    ((void) seed);
+
+    while ( n < num_ways )
+        n = (n << 1) | (int) ((*meta >> n) & 1);
+
+    return (n - num_ways);
+}
+
+/*====================================================================*
+ * SRRIP / BRRIP                                                      *
+ *====================================================================*/
+
+/*
+ * Metadata holds a 2-bit re-reference prediction value (RRPV) per way.
+ * Hits predict a near re-reference (0). SRRIP fills predict a long
+ * re-reference (RRPV_MAX - 1), and BRRIP fills predict a distant one
+ * (RRPV_MAX) except once every BRRIP_EPSILON fills, on average.
+ */
+
+#define RRIP_BITS 2                          /**< Bits per way.            */
+#define RRPV_MAX  ((1u << RRIP_BITS) - 1)    /**< Distant re-reference.    */
+#define BRRIP_EPSILON 32                     /**< BRRIP long insertion 1/N. */
+
+/**
+ * @brief Checks if RRIP supports a number of ways.
+ */
+static bool rrip_supports(int num_ways)
+{
+    return (num_ways > 0 && num_ways <= (int) (64 / RRIP_BITS));
+}
+
+/**
+ * @brief Replicates a 2-bit value for each way.
+ */
+static inline uint64_t rrip_spread(int num_ways, uint64_t value)
+{
+    uint64_t m = 0;
+
+    for ( int i = 0; i < num_ways; i++ )
+        m |= value << (i * RRIP_BITS);
+
+    return (m);
+}
+
+/**
+ * @brief Sets the RRPV of a way.
+ */
+static inline void rrip_set(uint64_t *meta, int way, uint64_t rrpv)
+{
+    *meta &= ~((uint64_t) RRPV_MAX << (way * RRIP_BITS));
+    *meta |= rrpv << (way * RRIP_BITS);
+}
+
+/**
+ * @brief Initial RRIP metadata: all ways predict a distant re-reference.
+ */
+static uint64_t rrip_init(int num_ways)
+{
+    return (rrip_spread(num_ways, RRPV_MAX));
+}
+
+/**
+ * @brief Predicts a near re-reference for a way.
+ */
+static void rrip_hit(uint64_t *meta, int num_ways, int way)
+{
+    ((void) num_ways);
+    rrip_set(meta, way, 0);
+}
+
+/**
+ * @brief Predicts a long re-reference for a filled way.
+ */
+static void srrip_fill(uint64_t *meta, int num_ways, int way, uint64_t *seed)
+{
+    ((void) num_ways);
+    ((void) seed);
+    rrip_set(meta, way, RRPV_MAX - 1);
+}
+
+/**
+ * @brief Predicts a distant re-reference for a filled way, most of the times.
+ */
+static void brrip_fill(uint64_t *meta, int num_ways, int way, uint64_t *seed)
+{
+    ((void) num_ways);
+    rrip_set(meta, way, (cache_policy_rand(seed) % BRRIP_EPSILON) ? RRPV_MAX : RRPV_MAX - 1);
+}
+
+/**
+ * @brief Chooses the first way that predicts a distant re-reference,
+ * aging all ways until one is found.
+ */
+static int rrip_victim(uint64_t *meta, int num_ways, uint64_t *seed)
+{
+    ((void) seed);
+
+    while ( true )
+    {
+        for ( int i = 0; i < num_ways; i++ )
+        {
+            if ( ((*meta >> (i * RRIP_BITS)) & RRPV_MAX) == RRPV_MAX )
+                return (i);
+        }
+
+        /* No way is at RRPV_MAX, so no field overflows. */
+        *meta += rrip_spread(num_ways, 1);
+    }
+}
+
+/*====================================================================*
+ * RANDOM                                                             *
+ *====================================================================*/
+
+/**
+ * @brief Chooses a random way.
+ */
+static int random_victim(uint64_t *meta, int num_ways, uint64_t *seed)
+{
+    ((void) meta);
+    return ((int) (cache_policy_rand(seed) % num_ways));
+}
+
+/*====================================================================*
+ * POLICIES                                                           *
+ *====================================================================*/
+
+/**
+ * @brief FIFO (round-robin) replacement.
+ */
+static struct cache_policy _cache_policy_fifo = {
+    "fifo",
+    false,
+    cache_policy_supports_any,
+    cache_policy_init_zero,
+    NULL,
+    fifo_fill,
+    fifo_victim
+};
+
+/**
+ * @brief True LRU replacement.
+ */
+static struct cache_policy _cache_policy_lru = {
+    "lru",
+    true,
+    lru_supports,
+    lru_init,
+    lru_hit,
+    lru_fill,
+    lru_victim
+};
+
+/**
+ * @brief Tree pseudo-LRU replacement.
+ */
+static struct cache_policy _cache_policy_plru = {
+    "plru",
+    true,
+    plru_supports,
+    cache_policy_init_zero,
+    plru_hit,
+    plru_fill,
+    plru_victim
+};
+
+/**
+ * @brief Static re-reference interval prediction.
+ */
+static struct cache_policy _cache_policy_srrip = {
+    "srrip",
+    true,
+    rrip_supports,
+    rrip_init,
+    rrip_hit,
+    srrip_fill,
+    rrip_victim
+};
+
+/**
+ * @brief Bimodal re-reference interval prediction.
+ */
+static struct cache_policy _cache_policy_brrip = {
+    "brrip",
+    true,
+    rrip_supports,
+    rrip_init,
+    rrip_hit,
+    brrip_fill,
+    rrip_victim
+};
+
+/**
+ * @brief Random replacement.
+ */
+static struct cache_policy _cache_policy_random = {
+    "random",
+    true,
+    cache_policy_supports_any,
+    cache_policy_init_zero,
+    NULL,
+    NULL,
+    random_victim
+};
+
+const struct cache_policy *cache_policy_fifo = &_cache_policy_fifo;
+const struct cache_policy *cache_policy_lru = &_cache_policy_lru;
+const struct cache_policy *cache_policy_plru = &_cache_policy_plru;
+const struct cache_policy *cache_policy_srrip = &_cache_policy_srrip;
+const struct cache_policy *cache_policy_brrip = &_cache_policy_brrip;
+const struct cache_policy *cache_policy_random = &_cache_policy_random;
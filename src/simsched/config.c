@@ -0,0 +1,527 @@
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mylib/util.h>
+
+#include <config.h>
+
+/*============================================================================*
+ * KERNELS                                                                    *
+ *============================================================================*/
+
+/**
+ * @brief Applies a linear kernel in a workload
+ *
+ * @param w Target workload.
+ */
+static void kernel_linear(workload_tt w)
+{
+	for (int i = 0; i < workload_ntasks(w); i++)
+	{
+		task_tt task;
+		int load = 0;
+
+		task = queue_peek(workload_tasks(w),i);
+		load = task_workload(task);
+		task_set_workload(task, load);
+	}
+}
+
+/**
+ * @brief Applies a logarithmic kernel in a workload
+ *
+ * @param w Target workload.
+ */
+static void kernel_logarithmic(workload_tt w)
+{
+	for (int i = 0; i < workload_ntasks(w); i++)
+	{
+		task_tt task;
+		int load = 0;
+
+		task = queue_peek(workload_tasks(w), i);
+		load = task_workload(task);
+		load = floor(load*(log(load)/log(2.0)));
+		task_set_workload(task, load);
+	}
+}
+
+/**
+ * @brief Applies a quadratic kernel in a workload
+ *
+ * @param w Target workload.
+ */
+static void kernel_quadratic(workload_tt w)
+{
+	for (int i = 0; i < workload_ntasks(w); i++)
+	{
+		task_tt task;
+		int load = 0;
+
+		task = queue_peek(workload_tasks(w),i);
+		load = task_workload(task);
+		load = load*load;
+		task_set_workload(task, load);
+	}
+}
+
+/*============================================================================*
+ * CONFIGURATION                                                              *
+ *============================================================================*/
+
+/**
+ * @brief Gets workload file format.
+ *
+ * @param formatname File format name.
+ *
+ * @returns Workload file format.
+ */
+enum workload_format config_format(const char *formatname)
+{
+	if (!strcmp(formatname, "text"))
+		return (WORKLOAD_TEXT);
+	if (!strcmp(formatname, "binary"))
+		return (WORKLOAD_BINARY);
+
+	error("unsupported workload file format");
+
+	/* Never gets here. */
+	return (-1);
+}
+
+/**
+ * @brief Gets format of simulation statistics.
+ *
+ * @param outputname Output format name.
+ *
+ * @returns Format of simulation statistics.
+ */
+enum simsched_output config_output(const char *outputname)
+{
+	if (!strcmp(outputname, "text"))
+		return (OUTPUT_TEXT);
+	if (!strcmp(outputname, "csv"))
+		return (OUTPUT_CSV);
+	if (!strcmp(outputname, "json"))
+		return (OUTPUT_JSON);
+
+	error("unsupported output format");
+
+	/* Never gets here. */
+	return (-1);
+}
+
+/**
+ * @brief Gets trace file format.
+ *
+ * @param tracename Trace format name.
+ *
+ * @returns Trace file format.
+ */
+enum trace_format config_trace_format(const char *tracename)
+{
+	if (!strcmp(tracename, "json"))
+		return (TRACE_JSON);
+	if (!strcmp(tracename, "binary"))
+		return (TRACE_BINARY);
+
+	error("unsupported trace format");
+
+	/* Never gets here. */
+	return (-1);
+}
+
+/**
+ * @brief Gets workload.
+ *
+ * @param filename Input workload filename.
+ * @param format   Input workload file format (WORKLOAD_AUTO to detect it).
+ * @param ncores   Number of working cores.
+ * @param arena    Arena of tasks (NULL for the C library).
+ *
+ * @returns A workload.
+ */
+workload_tt config_workload(const char *filename, enum workload_format format, int ncores, arena_tt arena)
+{
+	FILE *input;        /* Input workload file. */
+	workload_tt w;      /* Workload.            */
+	const char *errmsg; /* What is wrong.       */
+
+	input = fopen(filename, "rb");
+	if (input == NULL)
+		error("cannot open input workload file");
+
+	if (format == WORKLOAD_AUTO)
+		format = workload_detect_format(input);
+	if (format == WORKLOAD_BINARY)
+		w = workload_read_binary(input, ncores, arena, &errmsg);
+	else
+		w = workload_read(input, ncores, arena, &errmsg);
+
+	fclose(input);
+	if (w == NULL)
+		error(errmsg);
+
+	return (w);
+}
+
+/**
+ * @brief Gets a cache replacement policy.
+ *
+ * @param policyname Replacement policy name.
+ *
+ * @returns Cache replacement policy, NULL if unsupported.
+ */
+const struct cache_policy *config_cache_policy(const char *policyname)
+{
+	if (!strcmp(policyname, "fifo"))
+		return (cache_policy_fifo);
+	if (!strcmp(policyname, "lru"))
+		return (cache_policy_lru);
+	if (!strcmp(policyname, "plru"))
+		return (cache_policy_plru);
+	if (!strcmp(policyname, "srrip"))
+		return (cache_policy_srrip);
+	if (!strcmp(policyname, "brrip"))
+		return (cache_policy_brrip);
+	if (!strcmp(policyname, "random"))
+		return (cache_policy_random);
+
+	return (NULL);
+}
+
+/**
+ * @brief Gets a page replacement policy.
+ *
+ * @param policyname Replacement policy name.
+ *
+ * @returns Page replacement policy, NULL if unsupported.
+ */
+const struct page_policy *config_page_policy(const char *policyname)
+{
+	if (!strcmp(policyname, "fifo"))
+		return (page_policy_fifo);
+	if (!strcmp(policyname, "clock"))
+		return (page_policy_clock);
+	if (!strcmp(policyname, "lru"))
+		return (page_policy_lru);
+	if (!strcmp(policyname, "working-set"))
+		return (page_policy_ws);
+
+	return (NULL);
+}
+
+/**
+ * @brief Parses a memory size.
+ *
+ * @param str Size in bytes, optionally followed by a K, M, G or T suffix.
+ *
+ * @returns Memory size in bytes, zero if @p str is malformed.
+ */
+static unsigned long int config_size(const char *str)
+{
+	char *end;
+	unsigned long int size;
+
+	size = strtoul(str, &end, 10);
+	switch (*end)
+	{
+		case 'T': case 't': size <<= 10; /* Fall through. */
+		case 'G': case 'g': size <<= 10; /* Fall through. */
+		case 'M': case 'm': size <<= 10; /* Fall through. */
+		case 'K': case 'k': size <<= 10; end++; break;
+		default: break;
+	}
+
+	return ((*end == '\0') ? size : 0);
+}
+
+/**
+ * @brief Reads an architecture.
+ *
+ * The architecture file starts with the number of cores, followed by
+ * one line per core: capacity, number of cache sets, number of cache
+ * ways, number of blocks per way and, optionally, the cache replacement
+ * policy (fifo, lru, plru, srrip, brrip or random; fifo by default).
+ *
+ * Core lines may be followed by outer cache levels, one per line, from
+ * the innermost to the outermost one:
+ *
+ *   cache <sets> <ways> <blocks> <latency> <private|shared> [inclusive|exclusive] [policy]
+ *
+ * A private level is replicated for each core, a shared one is used by
+ * all of them. Inclusion is relative to the level right above and
+ * defaults to inclusive.
+ *
+ * Each core's MMU may also get a TLB:
+ *
+ *   tlb <entries> <ways> <latency> [asid|flush]
+ *
+ * In asid mode (the default) entries are tagged with the task id, in
+ * flush mode every entry is dropped when the core switches tasks.
+ *
+ * Finally, the memory geometry may be given:
+ *
+ *   memory <ram-size> [page-size|huge]
+ *
+ * Sizes are given in bytes and accept K, M, G and T suffixes. The page
+ * size defaults to 4K, and "huge" selects 2M pages. Without a memory
+ * line, 4G of RAM and 4K pages are simulated.
+ * 
+ * @param filename Input architecture filename.
+ * @param errmsg   Store location for what is wrong, on failure (may be NULL).
+ *
+ * @returns An architecture description, NULL if the file cannot be
+ *          opened or is malformed.
+*/
+arch_tt config_arch_read(const char *filename, const char **errmsg)
+{
+    FILE *file;                 /* Architecture file. */
+	int read_cores;             /* Number of cores.   */
+	arch_tt arch;               /* Architecture.      */
+	char line[128];             /* Current line.      */
+	const char *failure = NULL; /* What is wrong.     */
+
+	if ((file = fopen(filename, "r")) == NULL)
+	{
+		if (errmsg != NULL)
+			*errmsg = "failed to open architecture file";
+		return (NULL);
+	}
+
+	if ((fscanf(file, "%d", &read_cores) != 1) || (read_cores < 1))
+	{
+		fclose(file);
+		if (errmsg != NULL)
+			*errmsg = "bad architecture file";
+		return (NULL);
+	}
+
+	arch = arch_create(read_cores);
+	
+	for (int i = 0; (failure == NULL) && (i < read_cores); i++)
+	{
+        int capacity;   /** Core's processing capacity. */
+		int cache_line; /** Number of cache lines.      */
+		int cache_ways; /** Number of cache ways.       */
+		int num_blocks; /** Number of blocks per way    */
+		char name[16];  /** Cache replacement policy.   */
+		const struct cache_policy *policy = cache_policy_fifo;
+		
+		if ((fscanf(file, "%d %d %d %d", &capacity, &cache_line, &cache_ways, &num_blocks) != 4) ||
+			(capacity < 1) || (cache_line < 1) || (cache_ways < 1) || (num_blocks < 1))
+		{
+			failure = "bad core in architecture file";
+			continue;
+		}
+
+		/* Optional replacement policy. */
+		if ((fgets(line, sizeof(line), file) != NULL) && (sscanf(line, "%15s", name) == 1))
+			policy = config_cache_policy(name);
+		if (policy == NULL)
+			failure = "unsupported cache replacement policy";
+		else if (!policy->supports(cache_ways))
+			failure = "cache replacement policy does not support the number of cache ways";
+		else
+			arch_set_core(arch, i, capacity, cache_line, cache_ways, num_blocks, policy);
+	}
+
+	/* Outer cache levels, TLB and memory. */
+	while ((failure == NULL) && (fgets(line, sizeof(line), file) != NULL))
+	{
+		char key[16];         /* Line keyword.                */
+		char opts[3][16];     /* Scope and optional settings. */
+		int cache_line;       /* Number of cache lines.       */
+		int cache_ways;       /* Number of cache ways.        */
+		int num_blocks;       /* Number of blocks per way.    */
+		int latency;          /* Level's latency.             */
+		int nread;            /* Number of fields read.       */
+		bool shared = false;  /* Level shared by all cores?   */
+		enum cache_inclusion inclusion = CACHE_INCLUSIVE;
+		const struct cache_policy *policy = cache_policy_fifo;
+
+		if (sscanf(line, "%15s", key) != 1)
+			continue;
+		if (!strcmp(key, "memory"))
+		{
+			unsigned long int ram_size;
+			unsigned long int page_size = DEFAULT_PAGE_SIZE;
+
+			nread = sscanf(line, "%*s %15s %15s", opts[0], opts[1]);
+			if (nread < 1)
+			{
+				failure = "bad memory line in architecture file";
+				continue;
+			}
+
+			ram_size = config_size(opts[0]);
+			if (nread == 2)
+				page_size = (!strcmp(opts[1], "huge")) ? HUGE_PAGE_SIZE : config_size(opts[1]);
+
+			if ((page_size < BLOCK_SIZE) || (page_size & (page_size - 1)))
+				failure = "page size must be a power of two no smaller than a block";
+			else if ((ram_size < page_size) || (ram_size % page_size))
+				failure = "RAM size must be a multiple of the page size";
+			else if ((ram_size / page_size) > INT_MAX)
+				failure = "too many frames in RAM";
+			else
+				arch_set_memory(arch, ram_size, page_size);
+			continue;
+		}
+		if (!strcmp(key, "tlb"))
+		{
+			enum tlb_mode mode = TLB_ASID;
+
+			nread = sscanf(line, "%*s %d %d %d %15s", &cache_line, &cache_ways, &latency, opts[0]);
+			if (nread < 3 || cache_line < 1 || cache_ways < 1 || (cache_line % cache_ways) || latency < 0)
+				failure = "bad tlb in architecture file";
+			else if ((nread == 4) && !strcmp(opts[0], "flush"))
+				mode = TLB_FLUSH;
+			else if ((nread == 4) && strcmp(opts[0], "asid"))
+				failure = "tlb must be in asid or flush mode";
+
+			if ((failure == NULL) && arch_has_tlb(arch))
+				failure = "duplicate tlb in architecture file";
+			if (failure == NULL)
+				arch_set_tlb(arch, cache_line, cache_ways, latency, mode);
+			continue;
+		}
+		if (strcmp(key, "cache"))
+		{
+			failure = "bad architecture file";
+			continue;
+		}
+
+		nread = sscanf(line, "%*s %d %d %d %d %15s %15s %15s",
+			&cache_line, &cache_ways, &num_blocks, &latency, opts[0], opts[1], opts[2]);
+		if (nread < 5 || cache_line < 1 || cache_ways < 1 || num_blocks < 1 || latency < 0)
+		{
+			failure = "bad cache level in architecture file";
+			continue;
+		}
+
+		if (!strcmp(opts[0], "shared"))
+			shared = true;
+		else if (!strcmp(opts[0], "private"))
+			shared = false;
+		else
+		{
+			failure = "cache level must be private or shared";
+			continue;
+		}
+
+		for (int j = 1; j < nread - 4; j++)
+		{
+			if (!strcmp(opts[j], "inclusive"))
+				inclusion = CACHE_INCLUSIVE;
+			else if (!strcmp(opts[j], "exclusive"))
+				inclusion = CACHE_EXCLUSIVE;
+			else
+				policy = config_cache_policy(opts[j]);
+		}
+		if (policy == NULL)
+			failure = "unsupported cache replacement policy";
+		else if (!policy->supports(cache_ways))
+			failure = "cache replacement policy does not support the number of cache ways";
+		else
+			arch_add_level(arch, cache_line, cache_ways, num_blocks, latency, shared, inclusion, policy);
+	}
+
+	/* House keeping. */
+	fclose(file);
+
+	if (failure != NULL)
+	{
+		arch_destroy(arch);
+		if (errmsg != NULL)
+			*errmsg = failure;
+		return (NULL);
+	}
+
+	return (arch);
+}
+
+/**
+ * @brief Gets an architecture.
+ *
+ * @details Reads it with config_arch_read(), see there for the format
+ *          of the file.
+ *
+ * @param filename Input architecture filename.
+ *
+ * @returns An architecture description.
+ */
+arch_tt config_arch(const char *filename)
+{
+	arch_tt arch;       /* Architecture.  */
+	const char *errmsg; /* What is wrong. */
+
+	if ((arch = config_arch_read(filename, &errmsg)) == NULL)
+		error(errmsg);
+
+	return (arch);
+}
+
+/**
+ * @brief Gets application kernel.
+ *
+ * @param kernelname Kernel name.
+ *
+ * @returns Application kernel, NULL if unsupported.
+ */
+void (*config_kernel(const char *kernelname))(workload_tt)
+{
+	if (!strcmp(kernelname, "linear"))
+		return (kernel_linear);
+	if (!strcmp(kernelname, "logarithmic"))
+		return (kernel_logarithmic);
+	if (!strcmp(kernelname, "quadratic"))
+		return (kernel_quadratic);
+
+	return (NULL);
+}
+
+/**
+ * @brief Gets a core processing strategy.
+ *
+ * @param processername Processing strategy name.
+ *
+ * @returns Core processing strategy, NULL if unsupported.
+ */
+const struct processer *config_processer(const char *processername)
+{
+	if (!strcmp(processername, "non-preemptive"))
+		return (non_preemptive);
+	if (!strcmp(processername, "random-preemptive"))
+		return (random_preemptive);
+	if (!strcmp(processername, "rr-preemptive"))
+		return (rr_preemptive);
+	if (!strcmp(processername, "exp-preemptive"))
+		return (exp_preemptive);
+	if (!strcmp(processername, "adaptive-preemptive"))
+		return (adaptive_preemptive);
+
+	return (NULL);
+}
+
+/**
+ * @brief Gets a loop scheduling strategy.
+ *
+ * @param schedulername Scheduling strategy name.
+ *
+ * @returns Loop scheduling strategy, NULL if unsupported.
+ */
+const struct scheduler *config_scheduler(const char *schedulername)
+{
+	if (!strcmp(schedulername, "fcfs"))
+		return (sched_fcfs);
+	if (!strcmp(schedulername, "srtf"))
+		return (sched_srtf);
+	if (!strcmp(schedulername, "sca"))
+		return (sched_sca);
+
+	return (NULL);
+}
@@ -6,6 +6,18 @@
 #include <workload.h>
 #include <sched_itr.h>
 
+/**
+ * @brief Outer cache level of a core.
+ */
+struct cache_level
+{
+    cache_tt cache;            /**< Level's cache.                      */
+    int latency;               /**< Penalty of being served by level.   */
+    bool shared;               /**< Cache shared with other cores?      */
+    unsigned long int hits;    /**< Hits of this core in the level.     */
+    unsigned long int misses;  /**< Misses of this core in the level.   */
+};
+
 /**
  * @brief Core.
  */
@@ -26,52 +38,58 @@ struct core
     unsigned long int total_misses;     /**< Total cache misses while processing.              */
 
     cache_tt cache;                     /**< Core's cache.                                     */
+    struct cache_level *levels;         /**< Core's outer cache levels.                        */
+    int nlevels;                        /**< Number of outer cache levels.                     */
     mmu_tt mmu;                         /**< Core's MMU.                                       */
+    arena_tt arena;                     /**< Arena of the core (may be NULL).                  */
 };
 
-/**
- * @brief Next available core identification number.
-*/
-static int next_cid = 0;
-
 /**
  * @brief Creates a core.
  * 
+ * @param cid        Core identification number, i.e. its index among cores.
  * @param capacity   Max number of tasks.
  * @param cache_sets Total number of cache sets.
  * @param cache_ways Total number of cache ways.
  * @param num_blocks Total number of blocks per cache way.
+ * @param policy     Cache replacement policy.
+ * @param geometry   Memory geometry.
+ * @param arena      Arena to allocate from (NULL for the C library).
  * 
  * @returns A Core.
 */
-struct core *core_create(int capacity, int cache_sets, int cache_ways, int num_blocks)
+struct core *core_create(int cid, int capacity, int cache_sets, int cache_ways, int num_blocks, const struct cache_policy *policy, const struct mem_geometry *geometry, arena_tt arena)
 {
     struct core *c;
     
     /* Sanity Check. */
+    assert(cid >= 0);
     assert(capacity > 0);
     assert(cache_sets > 0);
     assert(cache_ways > 0);
     assert(num_blocks > 0);
 
-    c = smalloc(sizeof(struct core));
-    c->cid = next_cid++;
+    c = arena_smalloc(arena, sizeof(struct core));
+    c->arena = arena;
+    c->cid = cid;
     c->wtotal = 0;
     c->capacity = capacity;
     c->contention = 0;
-    c->pr_tasks = queue_create();
+    c->pr_tasks = queue_create_arena(arena);
     c->total_page_hit = 0;
     c->total_page_fault = 0;
     c->total_hits = 0;
     c->total_misses = 0;
 
     /* Initializing cache. */
-    c->cache = cache_create(cache_sets, cache_ways, num_blocks);
+    c->cache = cache_create(cache_sets, cache_ways, num_blocks, policy, geometry, arena);
+    c->levels = NULL;
+    c->nlevels = 0;
     /* Initializing MMU. */
     c->mmu = mmu_create(c->cid);
 
-    c->total_workload = queue_create();
-    queue_insert(c->total_workload, scheditr_create(0, 0));
+    c->total_workload = queue_create_arena(arena);
+    queue_insert(c->total_workload, scheditr_create(0, 0, arena));
     return (c);
 }
 
@@ -131,7 +149,7 @@ void core_set_workloads(struct core *c, unsigned long int wtotal, int ntasks)
     /* Sanity check. */
 	assert(c != NULL);
 
-    queue_insert(c->total_workload, scheditr_create(wtotal, ntasks));
+    queue_insert(c->total_workload, scheditr_create(wtotal, ntasks, c->arena));
 }
 
 /**
@@ -230,7 +248,7 @@ int core_getcid(const struct core *c)
  * 
  * @returns Cache's number of acesses in each cache set accessed.
  */
-map_tt core_cache_sets_accesses(const struct core *c)
+counter_tt core_cache_sets_accesses(const struct core *c)
 {
     /* Sanity check. */
     assert(c != NULL);
@@ -251,23 +269,18 @@ double core_cache_sets_variance(const struct core *c)
     assert(c != NULL);
     assert(c->cache != NULL);
 
-    map_tt cache_sets = cache_set_accesses(c->cache);
+    counter_tt cache_sets = cache_set_accesses(c->cache);
     double variance = 0.0;
-    if ( map_size(cache_sets) != 0 )
+    if ( counter_size(cache_sets) != 0 )
     {
         int c_set = cache_num_sets(c->cache);
-        int sum = 0;
-        for ( int i = 0; i < map_size(cache_sets); i++ )
-        {
-            struct map_return *m_r = map_peek(cache_sets, i);
-            sum += m_r->num_obj;
-        }
+        int sum = counter_total(cache_sets);
 
         double mean_value = sum / c_set;
-        for ( int i = 0; i < map_size(cache_sets); i++ )
+        for ( int i = 0; i < counter_size(cache_sets); i++ )
         {
-            struct map_return *m_r = map_peek(cache_sets, i);
-            variance += (m_r->num_obj - mean_value) * (m_r->num_obj - mean_value);
+            int num_obj = counter_get(cache_sets, counter_key(cache_sets, i));
+            variance += (num_obj - mean_value) * (num_obj - mean_value);
         }
         variance /= (double) c_set;
     }
@@ -294,7 +307,7 @@ void core_cache_sets_accesses_update(struct core *c, int index)
  * 
  * @returns Cache's number of conflicts in each cache set accessed.
  */
-map_tt core_cache_sets_conflicts(const struct core *c)
+counter_tt core_cache_sets_conflicts(const struct core *c)
 {
     /* Sanity check. */
     assert(c != NULL);
@@ -323,11 +336,12 @@ void core_cache_sets_conflicts_update(struct core *c, int index)
  * @param c   Target core.
  * @param ts  Task responsible of specified memory instance.
  * @param mem Desired instace of memory to be translated.
+ * @param idx Index of the address to be translated.
  * @param ram Simulation's RAM.
  * 
  * @returns True if Page Hit. False if Page Fault.
  */
-bool core_mmu_translate(struct core *c, struct task *ts, struct mem *mem, struct RAM *ram)
+bool core_mmu_translate(struct core *c, struct task *ts, struct mem *mem, unsigned long int idx, struct RAM *ram)
 {
     /* Sanity check. */
 	assert(c != NULL);
@@ -335,7 +349,114 @@ bool core_mmu_translate(struct core *c, struct task *ts, struct mem *mem, struct
     assert(mem != NULL);
 	assert(ram != NULL);
 
-    return (mmu_translate(c->mmu, ts, mem, ram));
+    return (mmu_translate(c->mmu, ts, mem, idx, ram));
+}
+
+/**
+ * @brief Checks if a core shares any cache level with other cores.
+ * 
+ * @param c Target core.
+ * 
+ * @returns True if any of core's outer cache levels is shared. False otherwise.
+ */
+bool core_cache_shared(const struct core *c)
+{
+    /* Sanity check. */
+    assert(c != NULL);
+
+    for ( int i = 0; i < c->nlevels; i++ )
+    {
+        if ( c->levels[i].shared )
+            return (true);
+    }
+
+    return (false);
+}
+
+/**
+ * @brief Attaches a TLB to a core's MMU. The core owns it from now on.
+ * 
+ * @param c   Target core.
+ * @param tlb TLB to be attached.
+ */
+void core_set_tlb(struct core *c, struct tlb *tlb)
+{
+    /* Sanity check. */
+    assert(c != NULL);
+    assert(tlb != NULL);
+
+    mmu_set_tlb(c->mmu, tlb);
+}
+
+/**
+ * @brief Checks if a core's MMU has a TLB.
+ * 
+ * @param c Target core.
+ * 
+ * @returns True if core has a TLB. False otherwise.
+ */
+bool core_has_tlb(const struct core *c)
+{
+    /* Sanity check. */
+    assert(c != NULL);
+    return (mmu_tlb(c->mmu) != NULL);
+}
+
+/**
+ * @brief Returns the number of TLB hits in a core.
+ * 
+ * @param c Target core.
+ * 
+ * @returns Number of TLB hits, zero if core has no TLB.
+ */
+unsigned long int core_tlb_hit(const struct core *c)
+{
+    /* Sanity check. */
+    assert(c != NULL);
+    return (core_has_tlb(c) ? tlb_hits(mmu_tlb(c->mmu)) : 0);
+}
+
+/**
+ * @brief Returns the number of TLB misses in a core.
+ * 
+ * @param c Target core.
+ * 
+ * @returns Number of TLB misses, zero if core has no TLB.
+ */
+unsigned long int core_tlb_miss(const struct core *c)
+{
+    /* Sanity check. */
+    assert(c != NULL);
+    return (core_has_tlb(c) ? tlb_misses(mmu_tlb(c->mmu)) : 0);
+}
+
+/**
+ * @brief Returns the number of TLB flushes in a core.
+ * 
+ * @param c Target core.
+ * 
+ * @returns Number of TLB flushes on address space switches, zero if
+ * core has no TLB.
+ */
+unsigned long int core_tlb_flushes(const struct core *c)
+{
+    /* Sanity check. */
+    assert(c != NULL);
+    return (core_has_tlb(c) ? tlb_flushes(mmu_tlb(c->mmu)) : 0);
+}
+
+/**
+ * @brief Returns the TLB penalty of the last translation made by a core.
+ * 
+ * @param c Target core.
+ * 
+ * @returns TLB miss latency if last translation missed, zero otherwise.
+ */
+int core_tlb_penalty(const struct core *c)
+{
+    /* Sanity check. */
+    assert(c != NULL);
+    return (mmu_penalty(c->mmu));
 }
 
 /**
@@ -357,32 +478,172 @@ int core_cache_num_sets(const struct core *c)
  * @brief Checks if a specified address is already in core's cache.
  * 
  * @param c    Target core.
- * @param addr Specified addr.
+ * @param addr Specified addresses.
+ * @param idx  Index of specified address.
  * 
  * @return True if cache hit. False if cache miss.
 */
-bool core_cache_checkaddr(const struct core *c, struct mem *addr)
+bool core_cache_checkaddr(struct core *c, const struct mem *addr, unsigned long int idx)
 {   
     /* Sanity check. */
 	assert(c != NULL);
     assert(addr != NULL);
 
-    return cache_check_addr(c->cache, addr);
+    return cache_check_addr(c->cache, addr, idx);
 }  
 
 /**
- * @brief Replaces a cache way with a new address. FIFO approach
+ * @brief Adds an outer cache level to a core, below its current last level.
  * 
- * @param c    Target core.
- * @param addr New address.
+ * @param c       Target core.
+ * @param ce      Level's cache.
+ * @param latency Penalty of an access served by this level (cycles).
+ * @param shared  Is the cache shared with other cores?
 */
-void core_cache_replace(struct core *c, struct mem *addr)
+void core_cache_add_level(struct core *c, cache_tt ce, int latency, bool shared)
 {
+    /* Sanity check. */
+    assert(c != NULL);
+    assert(ce != NULL);
+    assert(latency >= 0);
+
+    cache_attach(ce, (c->nlevels > 0) ? c->levels[c->nlevels - 1].cache : c->cache);
+
+    c->levels = arena_srealloc(c->arena, c->levels, sizeof(struct cache_level) * (c->nlevels + 1));
+    c->levels[c->nlevels].cache = ce;
+    c->levels[c->nlevels].latency = latency;
+    c->levels[c->nlevels].shared = shared;
+    c->levels[c->nlevels].hits = 0;
+    c->levels[c->nlevels].misses = 0;
+    c->nlevels++;
+}
+
+/**
+ * @brief Moves a way evicted from a cache level into the following
+ * exclusive levels, for as long as they evict ways themselves.
+ * 
+ * @param c      Target core.
+ * @param level  Outer cache level (index in c->levels) that receives the way.
+ * @param victim Evicted way.
+*/
+static void core_cache_spill(struct core *c, int level, struct cache_victim *victim)
+{
+    struct cache_victim next;
+
+    for ( ; victim->valid && level < c->nlevels; level++ )
+    {
+        cache_tt ce = c->levels[level].cache;
+
+        if ( cache_inclusion(ce) != CACHE_EXCLUSIVE )
+            break;
+
+        cache_insert(ce, victim, &next);
+        *victim = next;
+    }
+}
+
+/**
+ * @brief Fetches an address that missed the core's cache from the outer
+ * cache levels, and fills the levels that missed it.
+ *
+ * @details Levels are probed from the innermost to the outermost one. An
+ * exclusive level gives away an address that hits it and is only filled
+ * by ways evicted from the level right above it.
+ * 
+ * @param c           Target core.
+ * @param addr        Specified addresses.
+ * @param idx         Index of missed address.
+ * @param mem_latency Penalty of an access served by main memory (cycles).
+ * 
+ * @returns Penalty of the access (cycles).
+*/
+int core_cache_fetch(struct core *c, const struct mem *addr, unsigned long int idx, int mem_latency)
+{
+    struct cache_victim victim;
+    int served = c->nlevels;
+    int penalty = mem_latency;
+
     /* Sanity check. */
 	assert(c != NULL);
     assert(addr != NULL);
 
-    cache_replace(c->cache, addr);
+    for ( int i = 0; i < c->nlevels; i++ )
+    {
+        struct cache_level *l = &c->levels[i];
+
+        if ( cache_check_addr(l->cache, addr, idx) )
+        {
+            l->hits++;
+            served = i;
+            penalty = l->latency;
+            break;
+        }
+        l->misses++;
+    }
+
+    if ( served < c->nlevels && cache_inclusion(c->levels[served].cache) == CACHE_EXCLUSIVE )
+        cache_extract(c->levels[served].cache, addr, idx);
+
+    /* Filling missed levels, outermost first. */
+    for ( int i = served - 1; i >= 0; i-- )
+    {
+        cache_tt ce = c->levels[i].cache;
+
+        if ( cache_inclusion(ce) == CACHE_EXCLUSIVE )
+            continue;
+
+        cache_replace(ce, addr, idx, &victim);
+        core_cache_spill(c, i + 1, &victim);
+    }
+
+    cache_replace(c->cache, addr, idx, &victim);
+    core_cache_spill(c, 0, &victim);
+
+    return (penalty);
+}
+
+/**
+ * @brief Returns the number of cache levels of a core.
+ * 
+ * @param c Target core.
+ * 
+ * @returns Number of cache levels, including the core's own cache.
+*/
+int core_cache_nlevels(const struct core *c)
+{
+    /* Sanity check. */
+    assert(c != NULL);
+    return (c->nlevels + 1);
+}
+
+/**
+ * @brief Gets the number of hits of a core in a cache level.
+ * 
+ * @param c     Target core.
+ * @param level Target level (0 is the core's own cache).
+*/
+unsigned long int core_cache_level_hit(const struct core *c, int level)
+{
+    /* Sanity check. */
+    assert(c != NULL);
+    assert(level >= 0 && level <= c->nlevels);
+
+    return ((level == 0) ? c->total_hits : c->levels[level - 1].hits);
+}
+
+/**
+ * @brief Gets the number of misses of a core in a cache level.
+ * 
+ * @param c     Target core.
+ * @param level Target level (0 is the core's own cache).
+*/
+unsigned long int core_cache_level_miss(const struct core *c, int level)
+{
+    /* Sanity check. */
+    assert(c != NULL);
+    assert(level >= 0 && level <= c->nlevels);
+
+    return ((level == 0) ? c->total_misses : c->levels[level - 1].misses);
 }
 
 /**
@@ -502,16 +763,21 @@ void core_destroy(struct core *c)
 
     mmu_destroy(c->mmu);
     cache_destroy(c->cache);
+    /* Shared caches are owned by whoever created them. */
+    for ( int i = 0; i < c->nlevels; i++ )
+    {
+        if ( !c->levels[i].shared )
+            cache_destroy(c->levels[i].cache);
+    }
+    arena_sfree(c->arena, c->levels);
     for ( int i = 0; i < queue_size(c->pr_tasks); i++ )
     {
         task_destroy(queue_remove(c->pr_tasks));
     }
     queue_destroy(c->pr_tasks);
 
-    for ( int i = 0; i < queue_size(c->total_workload); i++ )
-    {
+    while ( !queue_empty(c->total_workload) )
         scheditr_destroy(queue_remove(c->total_workload));
-    }
     queue_destroy(c->total_workload);
-	free(c);
+	arena_sfree(c->arena, c);
 }
\ No newline at end of file
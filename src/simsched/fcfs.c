@@ -28,55 +28,39 @@
 
 #include <scheduler.h>
 
-/**
- * @brief FCFS scheduler data.
- */
-static struct
-{
-	workload_tt workload; /**< Workload.                     */
-	int batchsize;        /**< Batchsize.                    */
-    int initialized;      /**< Strategy already initialized? */
-} scheddata = { NULL, 1, 0 };
-
 /**
  * @brief Initializes the FCFS scheduler.
  * 
- * @param workload  Target workload.
- * @param batchsize Batch size.
+ * @param sim Target simulation.
  */
-void scheduler_fcfs_init(workload_tt workload, int batchsize)
-{	
+void scheduler_fcfs_init(struct simulation *sim)
+{
 	/* Sanity check. */
-	assert(workload != NULL);
-	assert(batchsize > 0);
-
-	/* Already initialized. */
-	if (scheddata.initialized)
-		return;
-
-	/* Initialize scheduler data. */
-	scheddata.workload = workload;
-    scheddata.batchsize = batchsize;
-    scheddata.initialized = 1;
+	assert(sim != NULL);
+	assert(sim->workload != NULL);
+	assert(sim->batchsize > 0);
 }
 
 /**
  * @brief Finalizes the FCFS scheduler.
+ *
+ * @param sim Target simulation.
  */
-void scheduler_fcfs_end(void)
+void scheduler_fcfs_end(struct simulation *sim)
 {
-	scheddata.initialized = 0;
+	((void) sim);
 }
 
 /**
  * @brief FCFS scheduler. The first BATCHSIZE tasks will be scheduled to the first free core.
  * 
+ * @param sim   Target simulation.
  * @param c     Target core.
  * @param tasks Mapped tasks to current core.
  * 
  * @returns Number of scheduled tasks,
  */
-int scheduler_fcfs_sched(core_tt c, queue_tt tasks)
+int scheduler_fcfs_sched(struct simulation *sim, core_tt c, queue_tt tasks)
 {
 	int n = 0;       /* Number of tasks scheduled.      */
 	int wsize = 0;   /* Size of assigned work.          */
@@ -95,7 +79,7 @@ int scheduler_fcfs_sched(core_tt c, queue_tt tasks)
 	}
 	
 	/* If any task was scheduled, global 'time' must increase based on number of scheduled tasks. */
-    g_iterator += ( n > 0 ) ? n : 1;	
+    sim->clock += ( n > 0 ) ? n : 1;	
 
 	return (n);
 }
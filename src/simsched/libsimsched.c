@@ -0,0 +1,472 @@
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mylib/util.h>
+
+#include <arch.h>
+#include <config.h>
+#include <core.h>
+#include <mem.h>
+#include <process.h>
+#include <scheduler.h>
+#include <simsched.h>
+#include <workload.h>
+
+/**
+ * @brief Description of a task.
+ */
+struct simsched_task
+{
+	int real_id;              /**< Id assigned when workload created. */
+	int arrival;              /**< Arrival moment.                    */
+	unsigned long int work;   /**< Number of memory accesses.         */
+	unsigned long int *addrs; /**< Memory accesses.                   */
+};
+
+/**
+ * @brief Workload description.
+ */
+struct simsched_workload
+{
+	int ntasks;                  /**< Number of tasks. */
+	struct simsched_task *tasks; /**< Tasks.           */
+};
+
+/**
+ * @brief Architecture description.
+ */
+struct simsched_arch
+{
+	arch_tt arch; /**< Underlying description. */
+};
+
+/*============================================================================*
+ * WORKLOADS                                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Creates a workload description.
+ *
+ * @param ntasks Number of tasks. Each must be set with
+ *               simsched_workload_set_task() before running.
+ *
+ * @returns A workload description, NULL if @p ntasks is not positive.
+ */
+struct simsched_workload *simsched_workload_create(int ntasks)
+{
+	struct simsched_workload *w;
+
+	if (ntasks < 1)
+		return (NULL);
+
+	w = smalloc(sizeof(struct simsched_workload));
+	w->ntasks = ntasks;
+	w->tasks = scalloc(ntasks, sizeof(struct simsched_task));
+
+	return (w);
+}
+
+/**
+ * @brief Describes a task.
+ *
+ * @param w       Target workload.
+ * @param i       Task index.
+ * @param real_id Id assigned when workload created.
+ * @param arrival Arrival moment.
+ * @param work    Number of memory accesses.
+ * @param addrs   Memory accesses, copied.
+ *
+ * @returns Zero on success, -1 on invalid arguments.
+ */
+int simsched_workload_set_task(struct simsched_workload *w, int i, int real_id, int arrival, unsigned long int work, const unsigned long int *addrs)
+{
+	struct simsched_task *t;
+
+	if ((w == NULL) || (i < 0) || (i >= w->ntasks))
+		return (-1);
+	if ((arrival < 0) || (work == 0) || (addrs == NULL))
+		return (-1);
+
+	t = &w->tasks[i];
+	sfree(t->addrs);
+	t->real_id = real_id;
+	t->arrival = arrival;
+	t->work = work;
+	t->addrs = smalloc(work*sizeof(unsigned long int));
+	memcpy(t->addrs, addrs, work*sizeof(unsigned long int));
+
+	return (0);
+}
+
+/**
+ * @brief Loads a workload description from a file, either in plain text
+ * or in binary format.
+ *
+ * @param filename Input workload filename.
+ *
+ * @returns A workload description, NULL if the file cannot be opened,
+ *          is malformed or has no tasks.
+ */
+struct simsched_workload *simsched_workload_load(const char *filename)
+{
+	FILE *input;
+	workload_tt loaded;
+	struct simsched_workload *w;
+
+	/* Sanity check. */
+	assert(filename != NULL);
+
+	if ((input = fopen(filename, "rb")) == NULL)
+		return (NULL);
+
+	loaded = (workload_detect_format(input) == WORKLOAD_BINARY) ?
+		workload_read_binary(input, 1, NULL, NULL) : workload_read(input, 1, NULL, NULL);
+	fclose(input);
+	if (loaded == NULL)
+		return (NULL);
+	if (workload_ntasks(loaded) < 1)
+	{
+		workload_destroy(loaded);
+		return (NULL);
+	}
+
+	w = simsched_workload_create(workload_ntasks(loaded));
+	for (int i = 0; i < w->ntasks; i++)
+	{
+		task_tt ts = workload_find_task(loaded, i);
+		struct simsched_task *t = &w->tasks[i];
+
+		t->real_id = task_realid(ts);
+		t->arrival = task_arrivaltime(ts);
+		t->work = task_workload(ts);
+		t->addrs = smalloc(t->work*sizeof(unsigned long int));
+		for (unsigned long int j = 0; j < t->work; j++)
+			t->addrs[j] = mem_addr(task_memacc(ts), j);
+
+		task_destroy(ts);
+	}
+	workload_destroy(loaded);
+
+	return (w);
+}
+
+/**
+ * @brief Returns the number of tasks of a workload description.
+ *
+ * @param w Target workload.
+ *
+ * @returns Number of tasks.
+ */
+int simsched_workload_ntasks(const struct simsched_workload *w)
+{
+	/* Sanity check. */
+	assert(w != NULL);
+
+	return (w->ntasks);
+}
+
+/**
+ * @brief Destroys a workload description.
+ *
+ * @param w Target workload.
+ */
+void simsched_workload_destroy(struct simsched_workload *w)
+{
+	if (w == NULL)
+		return;
+
+	for (int i = 0; i < w->ntasks; i++)
+		sfree(w->tasks[i].addrs);
+	sfree(w->tasks);
+	sfree(w);
+}
+
+/**
+ * @brief Builds the tasks of a workload description. Memory accesses
+ * are shared with the description, not copied.
+ *
+ * @param w      Target workload.
+ * @param ncores Number of working cores.
+ *
+ * @returns A workload, ready to be simulated.
+ */
+static workload_tt simsched_workload_build(const struct simsched_workload *w, int ncores)
+{
+	workload_tt built;
+
+	built = workload_alloc(w->ntasks, ncores, NULL);
+	for (int i = 0; i < w->ntasks; i++)
+	{
+		const struct simsched_task *t = &w->tasks[i];
+		task_tt ts = task_create(i, t->real_id, t->work, t->arrival, NULL);
+
+		task_set_memacc(ts, mem_wrap(t->addrs, t->work, NULL));
+		workload_set_task(built, i, ts);
+	}
+
+	return (built);
+}
+
+/*============================================================================*
+ * ARCHITECTURES                                                              *
+ *============================================================================*/
+
+/**
+ * @brief Creates an architecture description of identical cores.
+ *
+ * @param ncores     Number of cores.
+ * @param capacity   Max number of tasks per core.
+ * @param cache_sets Number of first level cache sets.
+ * @param cache_ways Number of first level cache ways.
+ * @param num_blocks Number of blocks per first level cache way.
+ * @param policy     First level cache replacement policy (NULL for fifo).
+ *
+ * @returns An architecture description, NULL on invalid arguments.
+ */
+struct simsched_arch *simsched_arch_create(int ncores, int capacity, int cache_sets, int cache_ways, int num_blocks, const char *policy)
+{
+	const struct cache_policy *p = cache_policy_fifo;
+	struct simsched_arch *a;
+
+	if ((ncores < 1) || (capacity < 1) || (cache_sets < 1) || (cache_ways < 1) || (num_blocks < 1))
+		return (NULL);
+	if ((policy != NULL) && ((p = config_cache_policy(policy)) == NULL))
+		return (NULL);
+	if (!p->supports(cache_ways))
+		return (NULL);
+
+	a = smalloc(sizeof(struct simsched_arch));
+	a->arch = arch_create(ncores);
+	for (int i = 0; i < ncores; i++)
+		arch_set_core(a->arch, i, capacity, cache_sets, cache_ways, num_blocks, p);
+
+	return (a);
+}
+
+/**
+ * @brief Appends an outer cache level, below the existing ones.
+ *
+ * @param a          Target architecture.
+ * @param cache_sets Number of cache sets.
+ * @param cache_ways Number of cache ways.
+ * @param num_blocks Number of blocks per way.
+ * @param latency    Level's latency.
+ * @param shared     Non-zero if shared by all cores, zero if private.
+ * @param exclusive  Non-zero if exclusive of the level above, zero if inclusive.
+ * @param policy     Cache replacement policy (NULL for fifo).
+ *
+ * @returns Zero on success, -1 on invalid arguments.
+ */
+int simsched_arch_add_cache(struct simsched_arch *a, int cache_sets, int cache_ways, int num_blocks, int latency, int shared, int exclusive, const char *policy)
+{
+	const struct cache_policy *p = cache_policy_fifo;
+
+	if ((a == NULL) || (cache_sets < 1) || (cache_ways < 1) || (num_blocks < 1) || (latency < 0))
+		return (-1);
+	if ((policy != NULL) && ((p = config_cache_policy(policy)) == NULL))
+		return (-1);
+	if (!p->supports(cache_ways))
+		return (-1);
+
+	arch_add_level(a->arch, cache_sets, cache_ways, num_blocks, latency, shared, (exclusive) ? CACHE_EXCLUSIVE : CACHE_INCLUSIVE, p);
+
+	return (0);
+}
+
+/**
+ * @brief Gives every core's MMU a TLB.
+ *
+ * @param a       Target architecture.
+ * @param entries Number of entries.
+ * @param ways    Number of ways.
+ * @param latency Miss latency.
+ * @param flush   Non-zero to flush on task switches, zero to tag entries.
+ *
+ * @returns Zero on success, -1 on invalid arguments.
+ */
+int simsched_arch_set_tlb(struct simsched_arch *a, int entries, int ways, int latency, int flush)
+{
+	if ((a == NULL) || (entries < 1) || (ways < 1) || (entries % ways) || (latency < 0))
+		return (-1);
+
+	arch_set_tlb(a->arch, entries, ways, latency, (flush) ? TLB_FLUSH : TLB_ASID);
+
+	return (0);
+}
+
+/**
+ * @brief Sets the memory geometry.
+ *
+ * @param a         Target architecture.
+ * @param ram_size  RAM size (bytes).
+ * @param page_size Page size (bytes), a power of two no smaller than a block.
+ *
+ * @returns Zero on success, -1 on invalid arguments.
+ */
+int simsched_arch_set_memory(struct simsched_arch *a, unsigned long int ram_size, unsigned long int page_size)
+{
+	if (a == NULL)
+		return (-1);
+	if ((page_size < BLOCK_SIZE) || (page_size & (page_size - 1)))
+		return (-1);
+	if ((ram_size < page_size) || (ram_size % page_size) || ((ram_size / page_size) > INT_MAX))
+		return (-1);
+
+	arch_set_memory(a->arch, ram_size, page_size);
+
+	return (0);
+}
+
+/**
+ * @brief Loads an architecture description from a file, in the format
+ * taken by the simsched tool.
+ *
+ * @param filename Input architecture filename.
+ *
+ * @returns An architecture description, NULL if the file cannot be
+ *          opened or is malformed.
+ */
+struct simsched_arch *simsched_arch_load(const char *filename)
+{
+	struct simsched_arch *a;
+	arch_tt arch;
+
+	/* Sanity check. */
+	assert(filename != NULL);
+
+	if ((arch = config_arch_read(filename, NULL)) == NULL)
+		return (NULL);
+
+	a = smalloc(sizeof(struct simsched_arch));
+	a->arch = arch;
+
+	return (a);
+}
+
+/**
+ * @brief Returns the number of cores of an architecture description.
+ *
+ * @param a Target architecture.
+ *
+ * @returns Number of cores.
+ */
+int simsched_arch_ncores(const struct simsched_arch *a)
+{
+	/* Sanity check. */
+	assert(a != NULL);
+
+	return (arch_ncores(a->arch));
+}
+
+/**
+ * @brief Destroys an architecture description.
+ *
+ * @param a Target architecture.
+ */
+void simsched_arch_destroy(struct simsched_arch *a)
+{
+	if (a == NULL)
+		return;
+
+	arch_destroy(a->arch);
+	sfree(a);
+}
+
+/*============================================================================*
+ * SIMULATIONS                                                                *
+ *============================================================================*/
+
+/**
+ * @brief Sets simulation parameters to their defaults: fcfs scheduling,
+ * non-preemptive processing, fifo paging, linear kernel, one core, batch
+ * size of one, window size of one, no optimization, seed zero and a
+ * single thread.
+ *
+ * @param params Target parameters.
+ */
+void simsched_params_init(struct simsched_params *params)
+{
+	/* Sanity check. */
+	assert(params != NULL);
+
+	params->scheduler = "fcfs";
+	params->processer = "non-preemptive";
+	params->paging = "fifo";
+	params->kernel = "linear";
+	params->ncores = 1;
+	params->batchsize = 1;
+	params->winsize = 1;
+	params->optimize = 0;
+	params->seed = 0;
+	params->nthreads = 1;
+}
+
+/**
+ * @brief Runs a simulation.
+ *
+ * @param w      Workload description.
+ * @param a      Architecture description.
+ * @param params Simulation parameters.
+ * @param stats  Where to store simulation statistics.
+ *
+ * @returns Zero on success, -1 on invalid arguments.
+ */
+int simsched_run(const struct simsched_workload *w, const struct simsched_arch *a, const struct simsched_params *params, struct simstats *stats)
+{
+	const struct scheduler *strategy;
+	const struct processer *processer;
+	const struct page_policy *paging;
+	void (*kernel)(workload_tt);
+	struct mem_geometry geometry;
+	workload_tt workload;
+	array_tt cores;
+	queue_tt caches;
+
+	if ((w == NULL) || (a == NULL) || (params == NULL) || (stats == NULL))
+		return (-1);
+	if ((params->scheduler == NULL) || ((strategy = config_scheduler(params->scheduler)) == NULL))
+		return (-1);
+	if ((params->processer == NULL) || ((processer = config_processer(params->processer)) == NULL))
+		return (-1);
+	if ((params->paging == NULL) || ((paging = config_page_policy(params->paging)) == NULL))
+		return (-1);
+	if ((params->kernel == NULL) || ((kernel = config_kernel(params->kernel)) == NULL))
+		return (-1);
+	if ((params->ncores < 1) || (params->ncores > arch_ncores(a->arch)))
+		return (-1);
+	if ((params->batchsize < 1) || (params->winsize < 0) || (params->winsize > QUANTUM))
+		return (-1);
+	if ((params->optimize < 0) || (params->optimize > 3) || (params->nthreads < 1))
+		return (-1);
+	for (int i = 0; i < w->ntasks; i++)
+	{
+		if (w->tasks[i].addrs == NULL)
+			return (-1);
+	}
+
+	arch_memory(a->arch, &geometry);
+	workload = simsched_workload_build(w, params->ncores);
+	caches = queue_create();
+	cores = arch_cores(a->arch, params->ncores, caches, NULL);
+
+	kernel(workload);
+	workload_sort(workload, WORKLOAD_ARRIVAL);
+
+	simsched(workload, cores, &geometry, strategy, processer, paging, params->batchsize, params->winsize, params->optimize, params->nthreads, params->seed, NULL, NULL, stats);
+
+	/* House keeping. */
+	for (int i = 0; i < params->ncores; i++)
+		core_destroy(array_get(cores, i));
+	array_destroy(cores);
+	while (!queue_empty(caches))
+		cache_destroy(queue_remove(caches));
+	queue_destroy(caches);
+	for (int i = 0; i < w->ntasks; i++)
+		task_destroy(workload_find_task(workload, i));
+	workload_destroy(workload);
+
+	return (0);
+}
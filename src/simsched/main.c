@@ -1,19 +1,28 @@
 #include <assert.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <time.h>
 #include <unistd.h>
 
+#include <mylib/arena.h>
 #include <mylib/util.h>
 
+#include <config.h>
 #include <core.h>
 #include <mmu.h>
 #include <process.h>
+#include <profile.h>
 #include <scheduler.h>
 #include <statistics.h>
 #include <workload.h>
 
+/**
+ * @brief Size of arena slabs (in bytes).
+ */
+#define ARENA_SLAB_SIZE (1 << 20)
+
 /**
  * @name Program Parameters
  */
@@ -21,76 +30,23 @@ static struct
 {
 	workload_tt workload;              /**< Input workload.                            */
     array_tt cores;                    /**< Cores to process tasks.                    */
+	queue_tt caches;                   /**< Caches shared by cores.                    */
+	struct mem_geometry geometry;      /**< Memory geometry.                           */
 	const struct scheduler *scheduler; /**< Loop scheduling strategy.                  */
 	const struct processer *processer; /**< Core processing strategy.                  */
+	const struct page_policy *paging;  /**< Page replacement policy.                   */
 	int optimize;                      /**< If scheduling optimization should be done. */
 	int winsize;                       /**< Memory accesses window size.               */
 	int batchsize;                     /**< Scheduling batch size.                     */
 	int seed;                          /**< Seed.                                      */
+	int nthreads;                      /**< Threads simulating cores.                  */
+	struct report report;              /**< How to report statistics.                  */
 	void (*kernel)(workload_tt);       /**< Application kernel.                        */
-} args = { NULL, NULL, NULL, NULL, -1, 0, 1, 0, NULL };
+	arena_tt arena;                    /**< Arena of simulation objects, if any.       */
+	bool profile;                      /**< Print where simulation time went?          */
+} args = { NULL, NULL, NULL, { 0, 0, 0 }, NULL, NULL, NULL, -1, 0, 1, 0, 1, { NULL, OUTPUT_TEXT, 1, { 99.0 }, false, NULL, TRACE_JSON, NULL }, NULL, NULL, false };
 
 
-/*============================================================================*
- * KERNELS                                                                    *
- *============================================================================*/
-
-/**
- * @brief Applies a linear kernel in a workload
- *
- * @param w Target workload.
- */
-static void kernel_linear(workload_tt w)
-{
-	for (int i = 0; i < workload_ntasks(w); i++)
-	{
-		task_tt task;
-		int load = 0;
-
-		task = queue_peek(workload_tasks(w),i);
-		load = task_workload(task);
-		task_set_workload(task, load);
-	}
-}
-
-/**
- * @brief Applies a logarithmic kernel in a workload
- *
- * @param w Target workload.
- */
-static void kernel_logarithmic(workload_tt w)
-{
-	for (int i = 0; i < workload_ntasks(w); i++)
-	{
-		task_tt task;
-		int load = 0;
-
-		task = queue_peek(workload_tasks(w), i);
-		load = task_workload(task);
-		load = floor(load*(log(load)/log(2.0)));
-		task_set_workload(task, load);
-	}
-}
-
-/**
- * @brief Applies a quadratic kernel in a workload
- *
- * @param w Target workload.
- */
-static void kernel_quadratic(workload_tt w)
-{
-	for (int i = 0; i < workload_ntasks(w); i++)
-	{
-		task_tt task;
-		int load = 0;
-
-		task = queue_peek(workload_tasks(w),i);
-		load = task_workload(task);
-		load = load*load;
-		task_set_workload(task, load);
-	}
-}
-
 /*============================================================================*
  * ARGUMENT CHECKING                                                          *
  *============================================================================*/
@@ -108,15 +64,40 @@ static void usage(void)
 	printf("           non-preemptive       Non-preemptive.\n");
 	printf("           random-preemptive    Random preemptive.\n");
 	printf("           rr-preemptive        Round-Robin Quantum = 10.\n");
+	printf("           exp-preemptive       Exponential quanta, mean = Quantum.\n");
+	printf("           adaptive-preemptive  Quanta doubling on preemption.\n");
+	printf("  --paging <name>         Page replacement policy.\n");
+	printf("           fifo                 First-In, First-Out (default).\n");
+	printf("           clock                Second chance.\n");
+	printf("           lru                  Sampled least recently used.\n");
+	printf("           working-set          Per-task working set.\n");
 	printf("  --batchsize <number>    Batch size.\n");
 	printf("  --kernel <name>         Kernel complexity.\n");
 	printf("           linear               Linear kernel.\n");
 	printf("           logarithmic          Logarithm kernel.\n");
 	printf("           quadratic            Quadratic kernel.\n");
 	printf("  --input <filename>      Input workload file.\n");
+	printf("  --format <type>         Input workload file format (default: detected).\n");
+	printf("           text                 Plain text.\n");
+	printf("           binary               Memory-mappable binary.\n");
 	printf("  --ncores <number>       Number of working cores.\n");
 	printf("  --winsize <number>      Memory Accesses Window size\n");
 	printf("  --seed <number>         Seed value.\n");
+	printf("  --threads <number>      Threads simulating cores (default 1).\n");
+	printf("  --arena                 Allocate simulation objects in an arena.\n");
+	printf("  --output <type>         Format of simulation statistics.\n");
+	printf("           text                 Plain text (default).\n");
+	printf("           csv                  Comma-separated values.\n");
+	printf("           json                 JSON object.\n");
+	printf("  --percentiles <list>    Comma-separated percentiles to report (default 99).\n");
+	printf("  --sketch                Estimate percentiles within 1%%, listing tasks\n");
+	printf("                          in order of completion instead of sorting them.\n");
+	printf("  --trace <filename>      Trace time slices of tasks in cores.\n");
+	printf("  --trace-format <type>   Trace file format.\n");
+	printf("           json                 Chrome trace events (default).\n");
+	printf("           binary               Fixed-size records.\n");
+	printf("  --profile               Print time spent in each simulation phase\n");
+	printf("                          (needs a build with make PROFILE=1).\n");
 	printf("  --optimize <number>     0 = No Opt. 1 = KMeans DTW. 2 = Simple OPT. 3 = Model OPT\n");
 	printf("  --help                  Display this message.\n");
 	printf("Schedulers:\n");
@@ -128,101 +109,6 @@ static void usage(void)
 	exit(EXIT_SUCCESS);
 }
 
-/**
- * @brief Gets workload.
- *
- * @param filename Input workload filename.
- * @param ncores   Number of working cores.
- *
- * @returns A workload.
- */
-static workload_tt get_workload(const char *filename, int ncores)
-{
-	FILE *input;   /* Input workload file. */
-	workload_tt w; /* Workload.            */
-
-	input = fopen(filename, "r");
-	if (input == NULL)
-		error("cannot open input workload file");
-
-	w = workload_read(input, ncores);
-
-	fclose(input);
-
-	return (w);
-}
-
-/**
- * @brief Gets cores.
- * 
- * @param afilename Input architecture filename.
- * @param ncores    Number of cores in architecture, will be obtained from "afilename"
- * 
- * @return Working cores. 
-*/
-static array_tt get_cores(const char *filename, int ncores)
-{
-    FILE *file; /* Architecture file. */
-	int read_cores;
-    array_tt cores;
-
-	assert(ncores > 0);
-
-	if ((file = fopen(filename, "r")) == NULL)
-		error("failed to open architecture file");
-
-	assert(fscanf(file, "%d", &read_cores) == 1);
-	if (read_cores < 1)
-		error("bad architecture file");
-
-	assert(ncores <= read_cores);
-
-	cores = array_create(ncores);
-	
-	for (int i = 0; i < ncores; i++)
-	{
-        core_tt c;      /** Core.                       */
-        int capacity;   /** Core's processing capacity. */
-		int cache_line; /** Number of cache lines.      */
-		int cache_ways; /** Number of cache ways.       */
-		int num_blocks; /** Number of blocks per way    */
-		
-		assert(fscanf(file, "%d", &capacity) == 1);
-		assert(fscanf(file, "%d", &cache_line) == 1);
-		assert(fscanf(file, "%d", &cache_ways) == 1);
-		assert(fscanf(file, "%d\n", &num_blocks) == 1);
-		c = core_create(capacity, cache_line, cache_ways, num_blocks);
-		array_set(cores, i, c);
-	}
-
-	/* House keeping. */
-	fclose(file);
-
-	return (cores);
-}
-
-/**
- * @brief Gets application kernel.
- *
- * @param kernelname Kernel name.
- *
- * @returns Application kernel.
- */
-static void (*get_kernel(const char *kernelname))(workload_tt)
-{
-	if (!strcmp(kernelname, "linear"))
-		return (kernel_linear);
-	if (!strcmp(kernelname, "logarithmic"))
-		return (kernel_logarithmic);
-	if (!strcmp(kernelname, "quadratic"))
-		return (kernel_quadratic);
-
-	error("unsupported application kernel");
-
-	/* Never gets here. */
-	return (NULL);
-}
-
 /**
  * @brief Checks program arguments.
  *
@@ -250,10 +136,39 @@ static void checkargs(const char *wfilename, const char *afilename, const char *
 		error("missing optimization decision.");
 	if (!has_winsize)
 		error("missing window size.");
+	if (args.nthreads < 1)
+		error("number of threads must be positive.");
 	if (args.winsize > QUANTUM)
 		error("window size must be equal or smaller than QUANTUM.");
 }
 
+/**
+ * @brief Reads a comma-separated list of percentiles.
+ *
+ * @param list Target list.
+ */
+static void readpercentiles(const char *list)
+{
+	char *end;
+
+	args.report.npercentiles = 0;
+	do
+	{
+		double p = strtod(list, &end);
+
+		if ((end == list) || !((p > 0.0) && (p <= 100.0)))
+			error("invalid percentile.");
+		if (args.report.npercentiles == REPORT_MAX_PERCENTILES)
+			error("too many percentiles.");
+
+		args.report.percentiles[args.report.npercentiles++] = p;
+		list = end + 1;
+	} while (*end == ',');
+
+	if (*end != '\0')
+		error("invalid percentile.");
+}
+
 /**
  * @brief Reads command line arguments.
  *
@@ -265,8 +180,12 @@ static void readargs(int argc, const char **argv)
 	const char *wfilename  = NULL;
 	const char *afilename  = NULL;
 	const char *kernelname = NULL;
+	const char *tfilename  = NULL;
+	enum workload_format format = WORKLOAD_AUTO;
+	arch_tt arch;
     int ncores      = 0,
-		has_winsize = 0;
+		has_winsize = 0,
+		use_arena   = 0;
 
 
 	/* Parse command line arguments. */
@@ -274,21 +193,22 @@ static void readargs(int argc, const char **argv)
 	{
 		if (!strcmp(argv[i], "--arch"))
 			afilename = argv[++i];
-		else if (!strcmp(argv[i], "--process"))	{
-			i ++;
-			if (!strcmp(argv[i], "non-preemptive"))
-				args.processer = (non_preemptive);
-			else if (!strcmp(argv[i], "random-preemptive"))
-				args.processer = (random_preemptive);
-			else if (!strcmp(argv[i], "rr-preemptive"))
-				args.processer = (rr_preemptive);
-			else 
-				/* Sanity check. */
+		else if (!strcmp(argv[i], "--process"))
+		{
+			if ((args.processer = config_processer(argv[++i])) == NULL)
 				error("invalid core processing strategy.");
-		} else if (!strcmp(argv[i], "--batchsize"))
+		}
+		else if (!strcmp(argv[i], "--paging"))
+		{
+			if ((args.paging = config_page_policy(argv[++i])) == NULL)
+				error("unsupported page replacement policy");
+		}
+		else if (!strcmp(argv[i], "--batchsize"))
 			args.batchsize = atoi(argv[++i]);
 		else if (!strcmp(argv[i], "--input"))
 			wfilename = argv[++i]; 
+		else if (!strcmp(argv[i], "--format"))
+			format = config_format(argv[++i]);
 		else if (!strcmp(argv[i], "--kernel"))
 			kernelname = argv[++i];
 		else if (!strcmp(argv[i], "--ncores"))
@@ -300,30 +220,61 @@ static void readargs(int argc, const char **argv)
 		}
 		else if (!strcmp(argv[i], "--seed"))
 			args.seed = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--threads"))
+			args.nthreads = atoi(argv[++i]);
 		else if (!strcmp(argv[i], "--optimize"))
 			args.optimize = atoi(argv[++i]);
-		else if (!strcmp(argv[i], "--help"))
-			usage();
-		else
+		else if (!strcmp(argv[i], "--arena"))
+			use_arena = 1;
+		else if (!strcmp(argv[i], "--output"))
+			args.report.format = config_output(argv[++i]);
+		else if (!strcmp(argv[i], "--percentiles"))
+			readpercentiles(argv[++i]);
+		else if (!strcmp(argv[i], "--sketch"))
+			args.report.sketch = true;
+		else if (!strcmp(argv[i], "--trace"))
+			tfilename = argv[++i];
+		else if (!strcmp(argv[i], "--trace-format"))
+			args.report.traceformat = config_trace_format(argv[++i]);
+		else if (!strcmp(argv[i], "--profile"))
 		{
-            if (!strcmp(argv[i], "fcfs"))
-                args.scheduler = sched_fcfs;
-			else if (!strcmp(argv[i], "srtf"))
-				args.scheduler = sched_srtf;
-			else if (!strcmp(argv[i], "sca"))
-				args.scheduler = sched_sca;
-			else
-				error("invalid option or unsupported scheduling strategy");
-
+#ifndef PROFILE
+			error("simsched was built without profiling (make PROFILE=1).");
+#endif
+			args.profile = true;
 		}
+		else if (!strcmp(argv[i], "--help"))
+			usage();
+		else if ((args.scheduler = config_scheduler(argv[i])) == NULL)
+			error("invalid option or unsupported scheduling strategy");
 	}
 
 
 	checkargs(wfilename, afilename, kernelname, ncores, has_winsize);
 
-	args.workload = get_workload(wfilename, ncores);
-    args.cores = get_cores(afilename, ncores);
-	args.kernel = get_kernel(kernelname);
+	if (args.paging == NULL)
+		args.paging = page_policy_fifo;
+
+	if ((args.kernel = config_kernel(kernelname)) == NULL)
+		error("unsupported application kernel");
+
+	if ((tfilename != NULL) && ((args.report.trace = fopen(tfilename, "wb")) == NULL))
+		error("cannot open trace file");
+
+	if (use_arena)
+		args.arena = arena_create(ARENA_SLAB_SIZE);
+
+	arch = config_arch(afilename);
+	if (ncores > arch_ncores(arch))
+		error("not enough cores in architecture file");
+
+	arch_memory(arch, &args.geometry);
+	args.workload = config_workload(wfilename, format, ncores, args.arena);
+	args.caches = queue_create_arena(args.arena);
+    args.cores = arch_cores(arch, ncores, args.caches, args.arena);
+
+	/* House keeping. */
+	arch_destroy(arch);
 }
 
 /*============================================================================*
@@ -335,15 +286,41 @@ static void readargs(int argc, const char **argv)
  */
 int main(int argc, const char** argv)
 {
+	struct profile_timer phases[PROFILE_NPHASES];
+
     readargs(argc, argv);
+	args.report.out = stdout;
+	if (args.profile)
+		args.report.profile = phases;
 
 	args.kernel(args.workload);
 
-	srand(args.seed);
-
 	workload_sort(args.workload, WORKLOAD_ARRIVAL);
 
-	simsched(args.workload, args.cores, args.scheduler, args.processer, args.batchsize, args.winsize, args.optimize);
+	simsched(args.workload, args.cores, &args.geometry, args.scheduler, args.processer, args.paging, args.batchsize, args.winsize, args.optimize, args.nthreads, args.seed, args.arena, &args.report, NULL);
+
+	if ((args.report.trace != NULL) && (fclose(args.report.trace) != 0))
+		error("cannot write trace file");
+
+	/* Keep machine-readable output clean. */
+	if (args.profile)
+		profile_print(phases, (args.report.format == OUTPUT_TEXT) ? stdout : stderr);
+
+	/*
+	 * Arena objects go at once, without walking them; the few that live
+	 * outside of it (MMUs, the workload mapping) go with the process.
+	 */
+	if (args.arena != NULL)
+	{
+		/* Keep machine-readable output clean. */
+		fprintf((args.report.format == OUTPUT_TEXT) ? stdout : stderr,
+			"Arena peak use: %zu bytes in %lu allocations, %zu bytes in %d slabs\n",
+			arena_used(args.arena), arena_nallocs(args.arena),
+			arena_size(args.arena), arena_nslabs(args.arena));
+		arena_destroy(args.arena);
+
+		return (EXIT_SUCCESS);
+	}
 
 	/* House keeping, */
 	for ( unsigned long int i = 0; i < array_size(args.cores); i++)
@@ -352,6 +329,9 @@ int main(int argc, const char** argv)
 		core_destroy(c);
 	}
 	array_destroy(args.cores);
+	while (!queue_empty(args.caches))
+		cache_destroy(queue_remove(args.caches));
+	queue_destroy(args.caches);
 	workload_destroy(args.workload);
 
     return (EXIT_SUCCESS);
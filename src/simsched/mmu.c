@@ -8,7 +8,9 @@
  */
 struct mmu
 {
-    int core_id; /**< Which core this MMU is related to. */
+    int core_id; /**< Which core this MMU is related to.       */
+    tlb_tt tlb;  /**< MMU's TLB, NULL if translations are free. */
+    int penalty; /**< TLB penalty of the last translation.      */
 };
 
 /**
@@ -22,31 +24,80 @@ struct mmu *mmu_create(int core_id)
 {
     struct mmu *mmu = smalloc(sizeof(struct mmu));
     mmu->core_id = core_id;
+    mmu->tlb = NULL;
+    mmu->penalty = 0;
     return (mmu);
 }
 
+/**
+ * @brief Attaches a TLB to a MMU. The MMU owns it from now on.
+ * 
+ * @param mmu Target MMU.
+ * @param tlb TLB to be attached.
+ */
+void mmu_set_tlb(struct mmu *mmu, struct tlb *tlb)
+{
+    /* Sanity check. */
+    assert(mmu != NULL);
+    assert(tlb != NULL);
+    assert(mmu->tlb == NULL);
+
+    mmu->tlb = tlb;
+}
+
+/**
+ * @brief Returns the TLB of a MMU.
+ * 
+ * @param mmu Target MMU.
+ * 
+ * @returns MMU's TLB, NULL if it has none.
+ */
+tlb_tt mmu_tlb(const struct mmu *mmu)
+{
+    /* Sanity check. */
+    assert(mmu != NULL);
+    return (mmu->tlb);
+}
+
+/**
+ * @brief Returns the TLB penalty of the last translation, i.e. the TLB
+ * miss latency if it missed, zero otherwise.
+ * 
+ * @param mmu Target MMU.
+ * 
+ * @returns TLB penalty of the last translation.
+ */
+int mmu_penalty(const struct mmu *mmu)
+{
+    /* Sanity check. */
+    assert(mmu != NULL);
+    return (mmu->penalty);
+}
+
 /**
  * @brief Translates the virtual memory to physical memory using RAM's frames.
  * The physical address translated is inside "mem".
  * If task's page table line is invalid, we must ask for RAM's next frame.
+ * If the MMU has a TLB, the translation is also looked up there: a page fault
+ * is always a TLB miss, and a miss costs the TLB latency (see mmu_penalty()).
  * 
  * @param mmu Target MMU. 
  * @param ts  Task responsible of specified memory instance.
  * @param mem Desired instace of memory to be translated.
+ * @param idx Index of the address to be translated.
  * @param ram Simulation's RAM.
  * 
  * @returns True if Page Hit. False if Page Fault.
  */
-bool mmu_translate(const struct mmu *mmu, struct task *ts, struct mem *mem, RAM_tt ram)
+bool mmu_translate(struct mmu *mmu, struct task *ts, struct mem *mem, unsigned long int idx, RAM_tt ram)
 {
     /* Sanity check. */
     assert(mmu != NULL);
     assert(ts != NULL);
     assert(mem != NULL);
 
-    unsigned long int mem_virtual_address  = mem_virtual_addr(mem) * PAGE_SIZE,
-                      mem_physical_address = 0;
-    int index    = (int) (mem_virtual_address / PAGE_SIZE),
+    unsigned long int mem_physical_address = 0;
+    int index    = (int) mem_virtual_addr(mem, idx, RAM_geometry(ram)),
         frame_id = 0;
                  /* Checking if mem addr's line is valid. */
     // If not valid, page fault
@@ -54,15 +105,32 @@ bool mmu_translate(const struct mmu *mmu, struct task *ts, struct mem *mem, RAM_
 
     if ( !page_hit )
     {
-        frame_id = RAM_next_frame(ram, task_gettsid(ts));
+        frame_id = RAM_next_frame(ram, task_gettsid(ts), index);
         mem_physical_address = frame_id;
         task_valid_pt_line(ts, index);
         task_set_pt_line_frameid(ts, index, frame_id);
     } 
     else 
         mem_physical_address = task_get_pt_line_frameid(ts, index);
+    RAM_reference(ram, task_gettsid(ts), mem_physical_address);
+
+    if ( mmu->tlb != NULL )
+    {
+        bool tlb_hit;
+
+        /* The page was (re)mapped, shoot down its old translation. */
+        if ( !page_hit )
+            tlb_invalidate(mmu->tlb, task_gettsid(ts), index);
+        tlb_hit = tlb_access(mmu->tlb, task_gettsid(ts), index, mem_physical_address);
+
+        if ( tlb_hit )
+            task_set_tlb_hit(ts, task_tlb_hit(ts) + 1);
+        else
+            task_set_tlb_miss(ts, task_tlb_miss(ts) + 1);
+        mmu->penalty = tlb_hit ? 0 : tlb_latency(mmu->tlb);
+    }
 
-    mem_set_physical_addr(mem, mem_physical_address);
+    mem_set_physical_addr(mem, idx, mem_physical_address);
     return page_hit;
 }   
 
@@ -75,5 +143,7 @@ void mmu_destroy(struct mmu *mmu)
 {
     /* Sanity check. */
     assert(mmu != NULL);
-    free(mmu);
+    if ( mmu->tlb != NULL )
+        tlb_destroy(mmu->tlb);
+    sfree(mmu);
 }
\ No newline at end of file
@@ -6,7 +6,7 @@
 
 #include <model.h>
 #include <core.h>
-#include <mylib/map.h>
+#include <mylib/counter.h>
 
 
 struct conflicts_finder
@@ -185,6 +185,7 @@ struct model
     struct bucket** buckets; /**< Buckets in our simulation. Number of buckets = num_cores.                                            */
 
     bool trained;            /**< If the model was already trained.                                                                    */
+    struct rng *rng;         /**< Random sequence of E-greedy exploration.                                                             */
 };
 
 
@@ -255,15 +256,17 @@ static inline void load_eps(struct model *m, const char* filename)
  * @param num_cores     Total number of cores in our simulation.
  * @param core_capacity Cores' capacity.
  * @param winsize       Current winsize.
+ * @param rng           Random sequence of the exploration.
  * 
  * @returns New Reinforcement Learning model instance.
  */
-model_tt model_create(int num_cores, int core_capacity, int winsize)
+model_tt model_create(int num_cores, int core_capacity, int winsize, struct rng *rng)
 {
     struct model *m;
     /* Sanity check. */
     assert(num_cores > 0);
     assert(core_capacity > 0);
+    assert(rng != NULL);
 
     m = (struct model*) malloc(sizeof(struct model));
     m->alpha = 0.5;
@@ -272,6 +275,7 @@ model_tt model_create(int num_cores, int core_capacity, int winsize)
     m->min_eps = 0.0;
     m->reward_penalty = 0.2;
     m->winsize = winsize;
+    m->rng = rng;
 
     m->num_actions = num_cores;
     m->num_cores = num_cores;
@@ -374,13 +378,7 @@ static inline double calc_perc_conflict(struct queue *bucket, struct core *core,
     assert(winsize >= 0);
     double conflict_perc = 0.0;
 
-    map_tt m_a = core_cache_sets_accesses(core);
-    int number_accesses = 0;
-    for ( int i = 0; i < map_size(m_a); i++ )
-    {
-        struct map_return *m_r = (struct map_return*) map_peek(m_a, i);
-        number_accesses += m_r->num_obj;
-    }
+    int number_accesses = counter_total(core_cache_sets_accesses(core));
 
     if ( (queue_size(bucket) > 1) && (number_accesses > 0) )
         conflict_perc = (double) conflicts_finder_bucket(bucket, winsize, core_capacity(core)) / number_accesses;
@@ -479,10 +477,10 @@ static inline int choose_action(struct model *m, int state)
     assert(m != NULL);
     assert(state >= 0);
 
-    double random_value = (double) rand() / RAND_MAX;
+    double random_value = (double) rng_next(m->rng) / RNG_MAX;
     if ( random_value < m->epsilon )
     {
-        return rand () % m->num_actions;
+        return rng_next(m->rng) % m->num_actions;
     } else 
     {
         double best_action = m->q_table[state][0];
@@ -0,0 +1,796 @@
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include <mylib/heap.h>
+#include <mylib/util.h>
+
+#include <process.h>
+#include <profile.h>
+
+/**
+ * @brief Time slice policy of a processing strategy.
+ */
+struct timeslice
+{
+    unsigned long int (*share)(const_task_tt);        /**< Workload a task is expected to process in a scheduling round. */
+    int (*slice)(struct simulation *, const_task_tt); /**< Time slice given to a task when it enters a core.            */
+    bool fresh_sets;                                  /**< Clear per-set cache counters every scheduling round?         */
+};
+
+/**
+ * @brief Smallest number of accesses (summed over cores) worth running in parallel.
+ */
+#define PARALLEL_MIN_ACCESSES 4096
+
+struct pool;
+
+/**
+ * @brief Worker thread of a pool.
+ */
+struct worker
+{
+    struct pool *pool; /**< Pool of the worker. */
+    int tid;           /**< Thread index.       */
+};
+
+/**
+ * @brief Worker threads that step independent cores in parallel.
+ */
+struct pool
+{
+    struct simulation *sim;  /**< Simulation the workers belong to.             */
+    int nthreads;            /**< Number of threads, including the calling one. */
+    pthread_t *threads;      /**< Worker threads.                               */
+    struct worker *workers;  /**< Worker threads' arguments.                    */
+    pthread_mutex_t lock;    /**< Protects the fields below.                    */
+    pthread_cond_t start;    /**< Signals a new round.                          */
+    pthread_cond_t done;     /**< Signals the end of a round.                   */
+    unsigned long int round; /**< Current round.                                */
+    int pending;             /**< Workers still busy in the current round.      */
+    bool quit;               /**< Workers should exit?                          */
+    struct slot *slots;      /**< Round's cores processing state.               */
+    const int *active;       /**< Round's cores, by index.                      */
+    int nactive;             /**< Round's number of cores.                      */
+    int span;                /**< Round's accesses per core.                    */
+    heap_tt events;          /**< Slice end events of cores.                    */
+};
+
+/*============================================================================*
+ * TIME SLICE POLICIES                                                        *
+ *============================================================================*/
+
+/**
+ * @brief Returns the whole work left of a task.
+ *
+ * @param ts Target task.
+ *
+ * @returns Task's work left.
+ */
+static unsigned long int share_work_left(const_task_tt ts)
+{
+    return (task_work_left(ts));
+}
+
+/**
+ * @brief Returns the work left of a task, bounded by QUANTUM.
+ *
+ * @param ts Target task.
+ *
+ * @returns Task's work left, up to QUANTUM.
+ */
+static unsigned long int share_quantum(const_task_tt ts)
+{
+    int work_left = task_work_left(ts);
+
+    return ((work_left < QUANTUM) ? work_left : QUANTUM);
+}
+
+/**
+ * @brief Returns the adaptive quantum of a task, which grows with the work
+ * it already processed, so long-running tasks are switched out less often:
+ * a task that has processed w cycles gets max(QUANTUM, w) more, i.e.
+ * QUANTUM twice and then doubling.
+ *
+ * @param ts Target task.
+ *
+ * @returns Task's work left, up to its adaptive quantum.
+ */
+static unsigned long int share_adaptive(const_task_tt ts)
+{
+    unsigned long int quantum = task_work_processed(ts);
+    unsigned long int work_left = task_work_left(ts);
+
+    if ( quantum < QUANTUM )
+        quantum = QUANTUM;
+
+    return ((quantum < work_left) ? quantum : work_left);
+}
+
+/**
+ * @brief Runs a task to completion.
+ *
+ * @param sim Target simulation.
+ * @param ts  Target task.
+ *
+ * @returns Time slice.
+ */
+static int slice_run_to_completion(struct simulation *sim, const_task_tt ts)
+{
+    ((void) sim);
+
+    return (task_work_left(ts));
+}
+
+/**
+ * @brief Runs a task for a random slice of its work left.
+ *
+ * @param sim Target simulation.
+ * @param ts  Target task.
+ *
+ * @returns Time slice.
+ */
+static int slice_random(struct simulation *sim, const_task_tt ts)
+{
+    return ((rng_next(&sim->rng) % (task_work_left(ts))) + 1);
+}
+
+/**
+ * @brief Runs a task for a fixed quantum.
+ *
+ * @param sim Target simulation.
+ * @param ts  Target task.
+ *
+ * @returns Time slice.
+ */
+static int slice_quantum(struct simulation *sim, const_task_tt ts)
+{
+    ((void) sim);
+
+    return (share_quantum(ts));
+}
+
+/**
+ * @brief Runs a task for an exponentially distributed slice with mean QUANTUM.
+ *
+ * @param sim Target simulation.
+ * @param ts  Target task.
+ *
+ * @returns Time slice.
+ */
+static int slice_exponential(struct simulation *sim, const_task_tt ts)
+{
+    double u = (rng_next(&sim->rng) + 1.0) / (RNG_MAX + 2.0);
+    double slice = ceil(-QUANTUM * log(u));
+    int work_left = task_work_left(ts);
+
+    return ((slice < work_left) ? (int) slice : work_left);
+}
+
+/**
+ * @brief Runs a task for its adaptive quantum.
+ *
+ * @param sim Target simulation.
+ * @param ts  Target task.
+ *
+ * @returns Time slice.
+ */
+static int slice_adaptive(struct simulation *sim, const_task_tt ts)
+{
+    ((void) sim);
+
+    return (share_adaptive(ts));
+}
+
+/*============================================================================*
+ * PROCESSING ENGINE                                                          *
+ *============================================================================*/
+
+/**
+ * @brief Initializes the processing engine.
+ *
+ * @param sim Target simulation.
+*/
+static void processer_init(struct simulation *sim)
+{
+    struct pool *pool;
+
+    /* Sanity check. */
+    assert(sim != NULL);
+    assert(sim->workload != NULL);
+    assert(sim->cores != NULL);
+    assert(sim->nthreads > 0);
+
+    pool = smalloc(sizeof(struct pool));
+    pool->sim = sim;
+    pool->nthreads = sim->nthreads;
+    pool->threads = NULL;
+    pool->workers = NULL;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    pool->round = 0;
+    pool->pending = 0;
+    pool->quit = false;
+    pool->slots = NULL;
+    pool->active = NULL;
+    pool->nactive = 0;
+    pool->span = 0;
+    pool->events = heap_create();
+
+    sim->processdata = pool;
+}
+
+/**
+ * @brief Processing state of a core.
+ */
+struct slot
+{
+    int accum_penalties;       /**< Penalties of the tasks already processed by core.   */
+    int penalties;             /**< Penalties of the current task.                      */
+    int time_to_process;       /**< Time slice of the current task.                     */
+    int time_processed;        /**< How much of the time slice was processed.           */
+    int accum_total_processed; /**< How much workload was processed by core.            */
+    unsigned long int hits;    /**< Current task's cache hits when its slice began.     */
+    unsigned long int misses;  /**< Current task's cache misses when its slice began.   */
+    unsigned long int faults;  /**< Current task's page faults when its slice began.    */
+#ifdef PROFILE
+    struct profile_timer mmu;   /**< Time translating addresses.                         */
+    struct profile_timer cache; /**< Time checking caches.                               */
+#endif
+};
+
+/**
+ * @brief Starts the time slice of a task in a core.
+ *
+ * @param sim Target simulation.
+ * @param s   Core's processing state.
+ * @param t   Target task.
+ * @param ts  Time slice policy.
+ */
+static inline void slot_begin(struct simulation *sim, struct slot *s, const_task_tt t, const struct timeslice *ts)
+{
+    s->penalties = 0;
+    s->time_to_process = ts->slice(sim, t);
+    s->time_processed = 0;
+    s->hits = task_hit(t);
+    s->misses = task_miss(t);
+    s->faults = task_page_fault(t);
+}
+
+/**
+ * @brief Returns the heap key of a slice end event, i.e. the iteration at which
+ * a core's current task leaves it. Simultaneous events are ordered by core index,
+ * the order in which cores are stepped.
+ *
+ * @param time   Iteration of the event.
+ * @param core   Core index.
+ * @param ncores Number of cores.
+ *
+ * @returns Heap key of the event.
+ */
+static inline long int event_key(int time, int core, int ncores)
+{
+    return ((long int) time*ncores + core);
+}
+
+/**
+ * @brief Processes one memory access of the current task of a core.
+ *
+ * @param sim Target simulation.
+ * @param c   Target core.
+ * @param s   Core's processing state.
+ */
+static inline void processer_step(struct simulation *sim, core_tt c, struct slot *s)
+{
+    task_tt curr_task = queue_peek(core_get_tsks(c), 0);
+
+    // Just arrived
+    if ( s->time_processed == 0 )
+    {
+        /*
+            Contention is added into consideration. If a core didn't suffer contention, this value is negative
+            so it will subtract from 'entry_time'.
+        */
+        int entry_time = (sim->clock + s->accum_total_processed + s->accum_penalties) + core_contention(c);
+        // Setting the new moment that task arrived.
+        task_set_emoment(curr_task, entry_time - task_arrivaltime(curr_task) );
+    }
+
+
+    int c_sets = core_cache_num_sets(c);
+    unsigned long int r_pages = RAM_num_frames(sim->RAM);
+    unsigned long int page_size = RAM_geometry(sim->RAM)->page_size;
+    unsigned long int position = task_memptr(curr_task);
+
+
+    /* Used at optimizing (grouping tasks by their last used cache sets) */
+    int *t_lineacc = task_lineacc(curr_task);
+    int *t_pageacc = task_pageacc(curr_task);
+
+    mem_tt m = task_memacc(curr_task);
+    PROFILE_START(translating);
+    bool page_hit = core_mmu_translate(c, curr_task, m, position, sim->RAM);
+    PROFILE_STOP(translating, s->mmu);
+    s->penalties += core_tlb_penalty(c);
+    PROFILE_START(checking);
+    bool hit = core_cache_checkaddr(c, m, position);
+    PROFILE_STOP(checking, s->cache);
+    unsigned long int frame = mem_physical_addr(m, position);
+
+    if ( page_hit )
+    {
+        task_set_page_hit(curr_task, task_page_hit(curr_task) + 1);
+        core_set_page_hit(c, core_page_hit(c) + 1);
+    }
+    else
+    {
+        task_set_page_fault(curr_task, task_page_fault(curr_task) + 1);
+        core_set_page_fault(c, core_page_fault(c) + 1);
+        s->penalties += PAGE_FAULT_PENALTY;
+    }
+
+    if ( hit )
+    {
+        task_set_hit(curr_task, task_hit(curr_task) + 1);
+        core_set_hit(c, core_hit(c) + 1);
+    }
+    else
+    {
+        task_set_miss(curr_task, task_miss(curr_task) + 1);
+        core_set_miss(c, core_miss(c) + 1);
+        core_cache_sets_conflicts_update(c, (frame * page_size) % c_sets);
+        /* If miss, we must add a penalty. */
+        s->penalties += core_cache_fetch(c, m, position, MISS_PENALTY);
+    }
+    // Mapping which line addr was allocated
+    core_cache_sets_accesses_update(c, (frame * page_size) % c_sets);
+
+    t_pageacc[position] = (frame * page_size) % r_pages;
+    t_lineacc[position++] = (frame * page_size) % c_sets;
+
+    task_set_memptr(curr_task, position);
+
+    s->time_processed++;
+    task_set_workprocess(curr_task, task_work_processed(curr_task) + 1);
+}
+
+/**
+ * @brief Takes the current task out of a core once its time slice is over,
+ * and starts the next one, if any.
+ *
+ * @param sim Target simulation.
+ * @param i   Index of target core.
+ * @param s   Core's processing state.
+ * @param ts  Time slice policy.
+ *
+ * @returns True if core has a next task. False otherwise.
+ */
+static bool processer_slice_end(struct simulation *sim, int i, struct slot *s, const struct timeslice *ts)
+{
+    queue_tt tasks = core_get_tsks(array_get(sim->cores, i));
+    task_tt curr_task = queue_peek(tasks, 0);
+
+    // Set waiting time
+    /* Time that task spent "idling". */
+    int time_waiting = task_emoment(curr_task) - task_lmoment(curr_task);
+
+    // Setting the new moment that task left. ( How much processed + accumulated waitings )
+    int left_time = task_emoment(curr_task) + s->penalties + s->time_processed;
+    task_set_lmoment(curr_task, left_time);
+    task_set_waiting_time(curr_task, task_waiting_time(curr_task) + s->penalties + time_waiting);
+
+    if ( sim->trace != NULL )
+    {
+        struct slice slice;
+
+        slice.id = task_realid(curr_task);
+        slice.tsid = task_gettsid(curr_task);
+        slice.start = (long) task_arrivaltime(curr_task) + task_emoment(curr_task);
+        slice.end = (long) task_arrivaltime(curr_task) + left_time;
+        slice.hits = task_hit(curr_task) - s->hits;
+        slice.misses = task_miss(curr_task) - s->misses;
+        slice.faults = task_page_fault(curr_task) - s->faults;
+        trace_slice(sim->trace, i, &slice);
+    }
+
+    /* If a task has finished, we add it to "finished tasks queue", otherwise, we 'recycle' it into workload. */
+    if ( task_work_left(curr_task) == 0 )
+    {
+        queue_insert(workload_fintasks(sim->workload), queue_remove(tasks));
+
+        /* Account for the task as it finishes, so reports need not revisit it. */
+        sim->waiting_sum += task_waiting_time(curr_task);
+        if ( sim->waiting != NULL )
+        {
+            sketch_insert(sim->waiting, task_waiting_time(curr_task));
+            sketch_insert(sim->slowdown, task_slowdown(curr_task));
+        }
+    }
+    else queue_insert((queue_tt) array_get(workload_arrtasks(sim->workload), array_size(workload_arrtasks(sim->workload)) - 2), queue_remove(tasks));
+    s->accum_total_processed += s->time_processed;
+    s->accum_penalties += s->penalties;
+
+    // Refresh values for next task (if any)
+    if ( queue_size(tasks) == 0 )
+        return (false);
+
+    slot_begin(sim, s, queue_peek(tasks, 0), ts);
+
+    return (true);
+}
+
+/**
+ * @brief Checks if the next accesses of a core's current task are all page hits.
+ *
+ * @param c    Target core.
+ * @param span Number of accesses.
+ * @param g    Memory geometry.
+ *
+ * @returns True if none of the next "span" accesses faults. False otherwise.
+ */
+static bool processer_resident(const_core_tt c, int span, const struct mem_geometry *g)
+{
+    task_tt curr_task = queue_peek(core_get_tsks(c), 0);
+    mem_tt m = task_memacc(curr_task);
+    unsigned long int position = task_memptr(curr_task);
+
+    for ( int k = 0; k < span; k++ )
+    {
+        if ( !task_check_pt_line_valid(curr_task, mem_virtual_addr(m, position + k, g)) )
+            return (false);
+    }
+
+    return (true);
+}
+
+/**
+ * @brief Runs the accesses of a round for the cores assigned to a thread.
+ * Cores are dealt round-robin to threads, so the assignment does not depend
+ * on scheduling and every core is always stepped by a single thread.
+ *
+ * @param pool Target pool.
+ * @param tid  Thread index.
+ */
+static void processer_round(struct pool *pool, int tid)
+{
+    for ( int j = tid; j < pool->nactive; j += pool->nthreads )
+    {
+        core_tt c = array_get(pool->sim->cores, pool->active[j]);
+        for ( int k = 0; k < pool->span; k++ )
+            processer_step(pool->sim, c, &pool->slots[pool->active[j]]);
+    }
+}
+
+/**
+ * @brief Worker thread.
+ *
+ * @param arg Worker thread.
+ *
+ * @returns Nothing.
+ */
+static void *processer_worker(void *arg)
+{
+    struct pool *pool = ((struct worker *) arg)->pool;
+    int tid = ((struct worker *) arg)->tid;
+    unsigned long int round = 0;
+
+    for ( ;; )
+    {
+        pthread_mutex_lock(&pool->lock);
+        while ( (pool->round == round) && !pool->quit )
+            pthread_cond_wait(&pool->start, &pool->lock);
+        if ( pool->quit )
+        {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        round = pool->round;
+        pthread_mutex_unlock(&pool->lock);
+
+        processer_round(pool, tid);
+
+        pthread_mutex_lock(&pool->lock);
+        if ( --pool->pending == 0 )
+            pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return (NULL);
+}
+
+/**
+ * @brief Steps independent cores in parallel, "span" accesses each.
+ * The calling thread takes part as thread zero.
+ *
+ * @param pool    Target pool.
+ * @param slots   Cores processing state.
+ * @param active  Cores to step, by index.
+ * @param nactive Number of cores to step.
+ * @param span    Accesses per core.
+ */
+static void processer_parallel(struct pool *pool, struct slot *slots, const int *active, int nactive, int span)
+{
+    /* Spawn workers on first use. */
+    if ( pool->threads == NULL )
+    {
+        pool->threads = smalloc(sizeof(pthread_t) * (pool->nthreads - 1));
+        pool->workers = smalloc(sizeof(struct worker) * (pool->nthreads - 1));
+        pool->quit = false;
+        for ( int t = 1; t < pool->nthreads; t++ )
+        {
+            pool->workers[t - 1].pool = pool;
+            pool->workers[t - 1].tid = t;
+            if ( pthread_create(&pool->threads[t - 1], NULL, processer_worker, &pool->workers[t - 1]) != 0 )
+                error("failed to create simulation thread");
+        }
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->slots = slots;
+    pool->active = active;
+    pool->nactive = nactive;
+    pool->span = span;
+    pool->pending = pool->nthreads - 1;
+    pool->round++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    processer_round(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while ( pool->pending > 0 )
+        pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * @brief Processes the tasks assigned to cores. Each iteration, every core processes one
+ * cycle of its first task, if a core is empty, it is just ignored. A task leaves its core
+ * once it used up its time slice, either finished or recycled into the workload.
+ *
+ * Rather than stepping iteration by iteration, time advances from one slice end event
+ * to the next. Between two events, cores are still stepped in lockstep whenever they may
+ * interfere with each other, i.e. share a cache level, or fault on a page (RAM is global),
+ * or use a page replacement policy that depends on the global order of references.
+ * Otherwise each core runs its accesses up to the next event at once, on several threads
+ * if so configured. Either way, every shared structure sees the same sequence of operations,
+ * and slice ends (which touch workload queues) are handled serially in core order, so
+ * results are exactly those of the cycle-by-cycle loop, whatever the number of threads.
+ *
+ * @param sim Target simulation.
+ * @param ts  Time slice policy.
+*/
+static void processer_process(struct simulation *sim, const struct timeslice *ts)
+{
+    struct pool *pool = sim->processdata;
+    int ncores = array_size(sim->cores);
+    struct slot slots[ncores];
+    heap_tt events = pool->events;
+    int active[ncores];   /* Cores with tasks left, in index order. */
+    int nactive = 0;
+    bool coupled = RAM_ordered(sim->RAM);
+
+    /* Storing the amount scheduled in this iteration. Useful to know how well-balanced the scheduling strategy is. */
+    for ( int i = 0; i < ncores; i++ )
+    {
+        core_tt c = array_get(sim->cores, i);
+        queue_tt tsks = core_get_tsks(c);
+        int size = queue_size(tsks);
+        unsigned long int acc = 0;
+        for ( int j = 0; j < size; j++ )
+            acc += ts->share(queue_peek(tsks, j));
+        core_set_workloads(c, acc, size);
+        slots[i].accum_penalties = 0;
+#ifdef PROFILE
+        slots[i].mmu = slots[i].cache = (struct profile_timer) { 0, 0 };
+#endif
+        if ( queue_size(tsks) > 0 )
+        {
+            slots[i].accum_total_processed = 0;
+            slot_begin(sim, &slots[i], queue_peek(tsks, 0), ts);
+            heap_insert(events, &slots[i], event_key(slots[i].time_to_process, i, ncores));
+            active[nactive++] = i;
+        }
+
+        // Cleaning up. If values are negative, cache_set's map will be reseted.
+        if ( ts->fresh_sets )
+        {
+            core_cache_sets_accesses_update(c, -1);
+            core_cache_sets_conflicts_update(c, -1);
+        }
+
+        coupled = coupled || core_cache_shared(c);
+    }
+
+    /* Counts number of cycles spent processing current tasks. */
+    int iterator = 0;
+    while ( !heap_empty(events) )
+    {
+        int span = heap_next_key(events)/ncores - iterator;
+        bool lockstep = false;
+
+        /* Can cores interfere before the next event? */
+        if ( nactive > 1 )
+        {
+            lockstep = coupled;
+            for ( int j = 0; (j < nactive) && !lockstep; j++ )
+                lockstep = !processer_resident(array_get(sim->cores, active[j]), span, RAM_geometry(sim->RAM));
+        }
+
+        if ( lockstep )
+        {
+            for ( int k = 0; k < span; k++ )
+            {
+                for ( int j = 0; j < nactive; j++ )
+                    processer_step(sim, array_get(sim->cores, active[j]), &slots[active[j]]);
+            }
+        }
+        else if ( (pool->nthreads > 1) && (nactive > 1) && ((long) span*nactive >= PARALLEL_MIN_ACCESSES) )
+            processer_parallel(pool, slots, active, nactive, span);
+        else
+        {
+            for ( int j = 0; j < nactive; j++ )
+            {
+                core_tt c = array_get(sim->cores, active[j]);
+                for ( int k = 0; k < span; k++ )
+                    processer_step(sim, c, &slots[active[j]]);
+            }
+        }
+        iterator += span;
+
+        // Tasks' time slices are over
+        while ( !heap_empty(events) && (heap_next_key(events)/ncores == iterator) )
+        {
+            struct slot *s = heap_remove(events);
+            int core = s - slots;
+
+            if ( processer_slice_end(sim, core, s, ts) )
+                heap_insert(events, s, event_key(iterator + s->time_to_process, core, ncores));
+            else
+            {
+                int j = 0;
+                while ( active[j] != core )
+                    j++;
+                for ( nactive--; j < nactive; j++ )
+                    active[j] = active[j + 1];
+            }
+        }
+    }
+
+#ifdef PROFILE
+    for ( int i = 0; i < ncores; i++ )
+    {
+        profile_merge(sim->profile, PROFILE_MMU, &slots[i].mmu);
+        profile_merge(sim->profile, PROFILE_CACHE, &slots[i].cache);
+    }
+#endif
+
+    /* Finding the MAX waiting time. We must keep in mind that our cores waits until all core are free to get the next batch of tasks. */
+    int max_penalties = 0;
+    for ( int i = 0; i < ncores; i++ ) { if (max_penalties < slots[i].accum_penalties) max_penalties = slots[i].accum_penalties; }
+
+    /* Cleaning up. */
+    for ( int i = 0; i < ncores; i++ )
+        core_vacate(array_get(sim->cores, i));
+
+    /* Max processing time spent (max_penalties) + preparation time (iterator) */
+    sim->clock += max_penalties + iterator;
+}
+
+/**
+ * @brief Finalizes the processing engine.
+ *
+ * @param sim Target simulation.
+*/
+static void processer_end(struct simulation *sim)
+{
+    struct pool *pool = sim->processdata;
+
+    /* Join workers. */
+    if ( pool->threads != NULL )
+    {
+        pthread_mutex_lock(&pool->lock);
+        pool->quit = true;
+        pthread_cond_broadcast(&pool->start);
+        pthread_mutex_unlock(&pool->lock);
+        for ( int t = 1; t < pool->nthreads; t++ )
+            pthread_join(pool->threads[t - 1], NULL);
+        sfree(pool->workers);
+        sfree(pool->threads);
+    }
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+    heap_destroy(pool->events);
+    sfree(pool);
+
+    sim->processdata = NULL;
+}
+
+/*============================================================================*
+ * PROCESSING STRATEGIES                                                      *
+ *============================================================================*/
+
+static const struct timeslice _run_to_completion = { share_work_left, slice_run_to_completion, false };
+static const struct timeslice _random_slice      = { share_work_left, slice_random, false };
+static const struct timeslice _fixed_quantum     = { share_quantum, slice_quantum, true };
+static const struct timeslice _exp_quantum       = { share_quantum, slice_exponential, true };
+static const struct timeslice _adaptive_quantum  = { share_adaptive, slice_adaptive, true };
+
+/**
+ * @brief Non preemptive: tasks run to completion.
+ */
+static void processer_non_preemptive_process(struct simulation *sim)
+{
+    processer_process(sim, &_run_to_completion);
+}
+
+/**
+ * @brief Random preemptive: tasks run for a random slice of their work left.
+ */
+static void processer_random_preemptive_process(struct simulation *sim)
+{
+    processer_process(sim, &_random_slice);
+}
+
+/**
+ * @brief Round-Robin: tasks run for QUANTUM cycles.
+ */
+static void processer_rr_preemptive_process(struct simulation *sim)
+{
+    processer_process(sim, &_fixed_quantum);
+}
+
+/**
+ * @brief Exponential: tasks run for exponentially distributed quanta with mean QUANTUM.
+ */
+static void processer_exp_preemptive_process(struct simulation *sim)
+{
+    processer_process(sim, &_exp_quantum);
+}
+
+/**
+ * @brief Adaptive: quanta double each time a task is preempted, starting at QUANTUM.
+ */
+static void processer_adaptive_preemptive_process(struct simulation *sim)
+{
+    processer_process(sim, &_adaptive_quantum);
+}
+
+static struct processer _non_preemptive = {
+    processer_init,
+    processer_non_preemptive_process,
+    processer_end
+};
+
+static struct processer _random_preemptive = {
+    processer_init,
+    processer_random_preemptive_process,
+    processer_end
+};
+
+static struct processer _rr_preemptive = {
+    processer_init,
+    processer_rr_preemptive_process,
+    processer_end
+};
+
+static struct processer _exp_preemptive = {
+    processer_init,
+    processer_exp_preemptive_process,
+    processer_end
+};
+
+static struct processer _adaptive_preemptive = {
+    processer_init,
+    processer_adaptive_preemptive_process,
+    processer_end
+};
+
+const struct processer *non_preemptive = &_non_preemptive;
+const struct processer *random_preemptive = &_random_preemptive;
+const struct processer *rr_preemptive = &_rr_preemptive;
+const struct processer *exp_preemptive = &_exp_preemptive;
+const struct processer *adaptive_preemptive = &_adaptive_preemptive;
@@ -0,0 +1,95 @@
+/* clock_gettime() and CLOCK_MONOTONIC. */
+#define _POSIX_C_SOURCE 199309L
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <profile.h>
+
+/**
+ * @brief Names of profiled phases, indented after nesting.
+ */
+static const char *phase_names[PROFILE_NPHASES] = {
+    "simulation",
+    "  arrival",
+    "  grouping",
+    "  model",
+    "  schedule",
+    "  process",
+    "    mmu",
+    "    cache",
+    "  report"
+};
+
+/**
+ * @brief Reads a monotonic clock.
+ *
+ * @returns Current time (in nanoseconds).
+ */
+uint64_t profile_now(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return ((uint64_t) t.tv_sec*1000000000 + t.tv_nsec);
+}
+
+/**
+ * @brief Adds time to a phase.
+ *
+ * @param phases Time accumulated by each phase.
+ * @param phase  Target phase.
+ * @param timer  Time to add.
+ *
+ * @note Not thread safe. Threads time into their own timers,
+ * which are merged afterwards.
+ */
+void profile_merge(struct profile_timer *phases, enum profile_phase phase, const struct profile_timer *timer)
+{
+    /* Sanity check. */
+    assert(phases != NULL);
+    assert((phase >= 0) && (phase < PROFILE_NPHASES));
+    assert(timer != NULL);
+
+    phases[phase].ns += timer->ns;
+    phases[phase].calls += timer->calls;
+}
+
+/**
+ * @brief Prints the time spent in each phase.
+ *
+ * @param phases Time accumulated by each phase.
+ * @param out    Output file.
+ *
+ * @note Timers themselves cost some tens of nanoseconds per call,
+ * which inflates phases with many short calls, namely mmu and cache.
+ */
+void profile_print(const struct profile_timer *phases, FILE *out)
+{
+    double total;
+
+    /* Sanity check. */
+    assert(phases != NULL);
+    assert(out != NULL);
+
+    total = (double) phases[PROFILE_SIMULATION].ns;
+
+    fprintf(out, "Profile:\n");
+    fprintf(out, "  %-14s %12s %12s %8s %14s\n", "phase", "calls", "time (ms)", "share", "ns/call");
+    for ( int i = 0; i < PROFILE_NPHASES; i++ )
+    {
+        if ( phases[i].calls == 0 )
+            continue;
+
+        fprintf(out, "  %-14s %12lu %12.3f %7.1f%% %14.1f\n",
+            phase_names[i],
+            phases[i].calls,
+            phases[i].ns/1e6,
+            (total > 0) ? 100.0*phases[i].ns/total : 0.0,
+            (double) phases[i].ns/phases[i].calls
+        );
+    }
+}
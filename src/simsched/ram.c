@@ -1,6 +1,9 @@
 #include <assert.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdlib.h>
 
+#include <mylib/arena.h>
 #include <mylib/util.h>
 
 #include <ram.h>
@@ -11,41 +14,338 @@
 struct RAM
 {
     workload_tt w;                /**< Simulation's workload. Must be used ONLY when a frame is assigned to other task.    */
-    unsigned long int next_frame; /**< Which is the next frame.                                                            */
+    struct mem_geometry geometry; /**< Memory geometry.                                                                    */
+    unsigned long int next_frame; /**< Replacement cursor (FIFO position or CLOCK/working-set hand).                       */
     unsigned long int num_frames; /**< Total number of frames in Simulation's RAM. A frame has the same size as Task PAGE. */
-    int* frame_assignment;        /**< Frame/Task assignment. Array index is the frame index.                              */
+    unsigned long int used;       /**< Number of frames handed out at least once.                                          */
+    int* frame_assignment;        /**< Frame/Task assignment (task id plus one, zero if free). Array index is frame index. */
+    int* frame_line;              /**< Frame/Page table line assignment. Array index is the frame index.                   */
+
+    const struct page_policy *policy; /**< Page replacement policy.                         */
+    unsigned char *referenced;        /**< Reference bits (CLOCK).                          */
+    unsigned long int *stamp;         /**< Last reference time of each frame (LRU, WS).     */
+    unsigned long int *task_time;     /**< Per-task virtual time, in references (WS).       */
+    unsigned long int time;           /**< Global virtual time, in references (LRU).        */
+    uint64_t seed;                    /**< Sampling sequence state (LRU).                   */
+    unsigned long int faults;         /**< Number of page faults served.                    */
+    unsigned long int evictions;      /**< Number of frames taken from a resident page.     */
+    arena_tt arena;                   /**< Arena of the RAM (may be NULL).                  */
 };
 
+/**
+ * @brief Page replacement policy.
+ */
+struct page_policy
+{
+    const char *name;                                            /**< Policy name.                    */
+    bool ordered;                                                /**< Depends on references' order?   */
+    void (*init)(struct RAM *);                                  /**< Allocates policy state.         */
+    void (*reference)(struct RAM *, int, unsigned long int);     /**< Records a reference to a frame. */
+    unsigned long int (*victim)(struct RAM *);                   /**< Selects a frame to be replaced. */
+};
+
+/*============================================================================*
+ * PAGE REPLACEMENT POLICIES                                                  *
+ *============================================================================*/
+
+/**
+ * @brief Selects frames in a FIFO order.
+ *
+ * @param ram Target RAM.
+ *
+ * @returns Frame to be replaced.
+ */
+static unsigned long int fifo_victim(struct RAM *ram)
+{
+    unsigned long int frame = ram->next_frame;
+
+    ram->next_frame = (ram->next_frame + 1) % ram->num_frames;
+
+    return (frame);
+}
+
+/**
+ * @brief Allocates CLOCK reference bits.
+ *
+ * @param ram Target RAM.
+ */
+static void clock_init(struct RAM *ram)
+{
+    ram->referenced = arena_scalloc(ram->arena, ram->num_frames, sizeof(unsigned char));
+}
+
+/**
+ * @brief Sets the reference bit of a frame.
+ *
+ * @param ram     Target RAM.
+ * @param task_id Referencing task.
+ * @param frame   Referenced frame.
+ */
+static void clock_reference(struct RAM *ram, int task_id, unsigned long int frame)
+{
+    ((void) task_id);
+
+    ram->referenced[frame] = 1;
+}
+
+/**
+ * @brief Sweeps the clock hand until an unreferenced frame is found,
+ * clearing reference bits on the way.
+ *
+ * @param ram Target RAM.
+ *
+ * @returns Frame to be replaced.
+ */
+static unsigned long int clock_victim(struct RAM *ram)
+{
+    while ( ram->referenced[ram->next_frame] )
+    {
+        ram->referenced[ram->next_frame] = 0;
+        ram->next_frame = (ram->next_frame + 1) % ram->num_frames;
+    }
+
+    return (fifo_victim(ram));
+}
+
+/**
+ * @brief Allocates LRU time stamps.
+ *
+ * @param ram Target RAM.
+ */
+static void lru_init(struct RAM *ram)
+{
+    ram->stamp = arena_scalloc(ram->arena, ram->num_frames, sizeof(unsigned long int));
+    ram->seed = 0x9e3779b97f4a7c15;
+}
+
+/**
+ * @brief Stamps a frame with the current global time.
+ *
+ * @param ram     Target RAM.
+ * @param task_id Referencing task.
+ * @param frame   Referenced frame.
+ */
+static void lru_reference(struct RAM *ram, int task_id, unsigned long int frame)
+{
+    ((void) task_id);
+
+    ram->stamp[frame] = ++ram->time;
+}
+
+/**
+ * @brief Selects the least recently used frame among RAM_LRU_SAMPLES
+ * randomly sampled ones (all of them in a small RAM).
+ *
+ * @param ram Target RAM.
+ *
+ * @returns Frame to be replaced.
+ */
+static unsigned long int lru_victim(struct RAM *ram)
+{
+    unsigned long int frame = 0;
+
+    if ( ram->num_frames <= RAM_LRU_SAMPLES )
+    {
+        for ( unsigned long int i = 1; i < ram->num_frames; i++ )
+            if ( ram->stamp[i] < ram->stamp[frame] )
+                frame = i;
+        return (frame);
+    }
+
+    for ( int i = 0; i < RAM_LRU_SAMPLES; i++ )
+    {
+        unsigned long int candidate;
+
+        /* xorshift64. */
+        ram->seed ^= ram->seed << 13;
+        ram->seed ^= ram->seed >> 7;
+        ram->seed ^= ram->seed << 17;
+
+        candidate = ram->seed % ram->num_frames;
+        if ( (i == 0) || (ram->stamp[candidate] < ram->stamp[frame]) )
+            frame = candidate;
+    }
+
+    return (frame);
+}
+
+/**
+ * @brief Allocates working-set time stamps and task virtual clocks.
+ *
+ * @param ram Target RAM.
+ */
+static void ws_init(struct RAM *ram)
+{
+    ram->stamp = arena_scalloc(ram->arena, ram->num_frames, sizeof(unsigned long int));
+    ram->task_time = arena_scalloc(ram->arena, workload_ntasks(ram->w), sizeof(unsigned long int));
+}
+
+/**
+ * @brief Advances the virtual time of the referencing task and stamps the frame with it.
+ *
+ * @param ram     Target RAM.
+ * @param task_id Referencing task.
+ * @param frame   Referenced frame.
+ */
+static void ws_reference(struct RAM *ram, int task_id, unsigned long int frame)
+{
+    ram->stamp[frame] = ++ram->task_time[task_id];
+}
+
+/**
+ * @brief Sweeps the hand for a frame outside its owner's working set,
+ * i.e. not referenced in the last RAM_WS_WINDOW references of the task
+ * that owns it. Frames of finished tasks are always outside. If every
+ * frame is in a working set, the one idle for the longest is replaced.
+ *
+ * @param ram Target RAM.
+ *
+ * @returns Frame to be replaced.
+ */
+static unsigned long int ws_victim(struct RAM *ram)
+{
+    unsigned long int frame = ram->next_frame,
+                      max_age = 0;
+
+    for ( unsigned long int i = 0; i < ram->num_frames; i++ )
+    {
+        unsigned long int candidate = (ram->next_frame + i) % ram->num_frames,
+                          age;
+        int owner = ram->frame_assignment[candidate] - 1;
+        task_tt ts = workload_find_task(ram->w, owner);
+
+        if ( task_work_left(ts) == 0 )
+        {
+            frame = candidate;
+            break;
+        }
+
+        age = ram->task_time[owner] - ram->stamp[candidate];
+        if ( age > RAM_WS_WINDOW )
+        {
+            frame = candidate;
+            break;
+        }
+        if ( age > max_age )
+        {
+            max_age = age;
+            frame = candidate;
+        }
+    }
+
+    ram->next_frame = (frame + 1) % ram->num_frames;
+
+    return (frame);
+}
+
+static const struct page_policy _page_policy_fifo = {
+    "fifo", false, NULL, NULL, fifo_victim
+};
+
+static const struct page_policy _page_policy_clock = {
+    "clock", false, clock_init, clock_reference, clock_victim
+};
+
+static const struct page_policy _page_policy_lru = {
+    "lru", true, lru_init, lru_reference, lru_victim
+};
+
+static const struct page_policy _page_policy_ws = {
+    "working-set", false, ws_init, ws_reference, ws_victim
+};
+
+const struct page_policy *page_policy_fifo = &_page_policy_fifo;
+const struct page_policy *page_policy_clock = &_page_policy_clock;
+const struct page_policy *page_policy_lru = &_page_policy_lru;
+const struct page_policy *page_policy_ws = &_page_policy_ws;
+
+/**
+ * @brief Returns the name of a page replacement policy.
+ *
+ * @param policy Target page replacement policy.
+ *
+ * @returns Policy name.
+ */
+const char *page_policy_name(const struct page_policy *policy)
+{
+    /* Sanity check. */
+    assert(policy != NULL);
+    return (policy->name);
+}
+
+/*============================================================================*
+ * RAM                                                                        *
+ *============================================================================*/
+
 /**
  * @brief Initiates the Simulation's RAM instance.
- * 
+ *
+ * @param w        Simulation's workload.
+ * @param geometry Memory geometry, of which the number of frames follows.
+ * @param policy   Page replacement policy.
+ * @param arena    Arena to allocate from (NULL for the C library).
+ *
  * @return RAM instance.
  */
-RAM_tt RAM_init(struct workload *w)
+RAM_tt RAM_init(struct workload *w, const struct mem_geometry *geometry, const struct page_policy *policy, arena_tt arena)
 {
     /* Sanity check. */
     assert(w != NULL);
-    struct RAM *ram = smalloc(sizeof(struct RAM));
+    assert(geometry != NULL);
+    assert(geometry->ram_size / geometry->page_size <= INT_MAX);
+    assert(policy != NULL);
+    struct RAM *ram = arena_smalloc(arena, sizeof(struct RAM));
     ram->w = w;
-    ram->num_frames = RAM_SIZE / PAGE_SIZE;
-    ram->next_frame = ram->num_frames - 1;
+    ram->arena = arena;
+    ram->geometry = *geometry;
+    ram->num_frames = geometry->ram_size / geometry->page_size;
+    ram->next_frame = 0;
+    ram->used = 0;
+    ram->policy = policy;
+    ram->referenced = NULL;
+    ram->stamp = NULL;
+    ram->task_time = NULL;
+    ram->time = 0;
+    ram->seed = 0;
+    ram->faults = 0;
+    ram->evictions = 0;
 
 
     /**
-     * For memory reasons, there is no "frame" struct. 
-     * Each frame has its initial address (its index * PAGE_SIZE), and which task it's related to (found at frame_assigment)
+     * For memory reasons, there is no "frame" struct.
+     * Each frame has its initial address (its index * page size), and which task it's related to (found at frame_assigment)
+     * and which line of task's page table maps it (found at frame_line).
+     * Both tables are zero-filled by calloc(), so untouched frames are never brought in by the OS and
+     * large memories cost nothing until they are actually used (unless they come from an arena).
      */
-    ram->frame_assignment = smalloc(sizeof(int) * ram->num_frames);
-    for ( unsigned long int i = 0; i < ram->num_frames; i++ ) ram->frame_assignment[i] = -1;
+    ram->frame_assignment = arena_scalloc(arena, ram->num_frames, sizeof(int));
+    ram->frame_line = arena_scalloc(arena, ram->num_frames, sizeof(int));
+    if ( policy->init != NULL )
+        policy->init(ram);
 
     return ram;
 }
 
+/**
+ * @brief Returns the geometry of RAM.
+ *
+ * @param ram Target RAM.
+ *
+ * @returns Memory geometry.
+ */
+const struct mem_geometry *RAM_geometry(const struct RAM *ram)
+{
+    /* Sanity check. */
+    assert(ram != NULL);
+
+    return (&ram->geometry);
+}
+
 /**
  * @brief Returns the total number of frames in RAM.
- * 
+ *
  * @param ram Target RAM.
- * 
+ *
  * @returns Total number of frames in RAM.
  */
 unsigned long int RAM_num_frames(const struct RAM *ram)
@@ -56,50 +356,138 @@ unsigned long int RAM_num_frames(const struct RAM *ram)
 }
 
 /**
- * @brief Selects a next frame in a FIFO order. 
+ * @brief Returns RAM's page replacement policy.
+ *
+ * @param ram Target RAM.
+ *
+ * @returns Page replacement policy.
+ */
+const struct page_policy *RAM_policy(const struct RAM *ram)
+{
+    /* Sanity check. */
+    assert(ram != NULL);
+    return (ram->policy);
+}
+
+/**
+ * @brief Checks if RAM's page replacement depends on the global order of
+ * references, and not only on the order of each task's own references.
+ *
+ * @param ram Target RAM.
+ *
+ * @returns True if references of different tasks must be replayed in order.
+ */
+bool RAM_ordered(const struct RAM *ram)
+{
+    /* Sanity check. */
+    assert(ram != NULL);
+    return (ram->policy->ordered);
+}
+
+/**
+ * @brief Returns the number of page faults served by RAM.
+ *
+ * @param ram Target RAM.
+ *
+ * @returns Number of page faults.
+ */
+unsigned long int RAM_faults(const struct RAM *ram)
+{
+    /* Sanity check. */
+    assert(ram != NULL);
+    return (ram->faults);
+}
+
+/**
+ * @brief Returns the number of frames taken from a resident page.
+ *
+ * @param ram Target RAM.
+ *
+ * @returns Number of evictions.
+ */
+unsigned long int RAM_evictions(const struct RAM *ram)
+{
+    /* Sanity check. */
+    assert(ram != NULL);
+    return (ram->evictions);
+}
+
+/**
+ * @brief Records a reference to a frame, either a page hit or a freshly
+ * assigned frame. Feeds the replacement policy.
+ *
+ * @param ram     Target RAM.
+ * @param task_id Referencing task.
+ * @param frame   Referenced frame.
+ */
+void RAM_reference(struct RAM *ram, int task_id, unsigned long int frame)
+{
+    /* Sanity check. */
+    assert(ram != NULL);
+    assert(frame < ram->num_frames);
+
+    if ( ram->policy->reference != NULL )
+        ram->policy->reference(ram, task_id, frame);
+}
+
+/**
+ * @brief Selects a next frame. Free frames are handed out first, then
+ * frames are replaced according to the page replacement policy.
  * If frame was assigned to a task that is still at workload, we must invalid task's line.
- * Also, assigns frame to the new task (task_id). 
- * 
- * @param ram     Target RAM. 
+ * Also, assigns frame to the new task (task_id) and page table line (line).
+ *
+ * @param ram     Target RAM.
  * @param task_id Task_id to be assigned to frame.
- * 
+ * @param line    Task's page table line that will map the frame.
+ *
  * @returns Frame's id.
  */
-unsigned long int RAM_next_frame(struct RAM *ram, int task_id)
+unsigned long int RAM_next_frame(struct RAM *ram, int task_id, int line)
 {
+    unsigned long int frame;
+
     /* Sanity check. */
     assert(ram != NULL);
     assert(task_id >= 0);
+    assert(line >= 0);
 
-    ram->next_frame = (ram->next_frame + 1) % ram->num_frames;
-    int last_task = ram->frame_assignment[ram->next_frame];
+    ram->faults++;
+    frame = ( ram->used < ram->num_frames ) ? ram->used++ : ram->policy->victim(ram);
+    int last_task = ram->frame_assignment[frame];
     // Will only happen when a frame was assigned before.
-    if ( last_task != -1 )
+    if ( last_task != 0 )
     {
-        task_tt replaced_task = workload_find_task(ram->w, last_task);
+        task_tt replaced_task = workload_find_task(ram->w, last_task - 1);
+        ram->evictions++;
         // If any task found.
         if ( replaced_task != NULL )
         {
-            int index = task_find_pt_line_frame_id(replaced_task, ram->next_frame); 
-            if ( index != -1 ) task_invalid_pt_line(replaced_task, index);
+            int index = ram->frame_line[frame];
+            if ( task_check_pt_line_valid(replaced_task, index) && (unsigned long int) task_get_pt_line_frameid(replaced_task, index) == frame )
+                task_invalid_pt_line(replaced_task, index);
         }
 
     }
 
     // Assigning frame to task
-    ram->frame_assignment[ram->next_frame] = task_id;
-    return (ram->next_frame % ram->num_frames);
+    ram->frame_assignment[frame] = task_id + 1;
+    ram->frame_line[frame] = line;
+    return (frame);
 }
 
 /**
  * @brief Destroys RAM instance.
- * 
+ *
  * @param ram Target RAM.
  */
 void RAM_destroy(struct RAM *ram)
 {
     /* Sanity check. */
     assert(ram != NULL);
-    free(ram->frame_assignment);
-    free(ram);
+    arena_sfree(ram->arena, ram->frame_assignment);
+    arena_sfree(ram->arena, ram->frame_line);
+    arena_sfree(ram->arena, ram->referenced);
+    arena_sfree(ram->arena, ram->stamp);
+    arena_sfree(ram->arena, ram->task_time);
+    arena_sfree(ram->arena, ram);
 }
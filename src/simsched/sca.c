@@ -7,71 +7,54 @@
 
 #include <scheduler.h>
 
-/**
- * @brief SCA scheduler data.
-*/
-static struct
-{
-    workload_tt workload; /**< Workload.                     */
-    int batchsize;        /**< Batchsize.                    */
-    int initialized;      /**< Strategy already initialized? */
-} scheddata = { NULL, 1, 0 };
-
-
 /**
  * @brief Initializes the SCA scheduler.
  * 
- * @param workload  Target workload.
- * @param batchsize Batch size.
+ * @param sim Target simulation.
 */
-void scheduler_sca_init(workload_tt workload, int batchsize)
+void scheduler_sca_init(struct simulation *sim)
 {
     /* Sanity check. */
-    assert(workload != NULL);
-    assert(batchsize > 0);
-
-    /* Already initialized. */
-    if (scheddata.initialized)
-        return;
-
-    /* Initialize scheduler data. */
-    scheddata.workload = workload;
-    scheddata.batchsize = batchsize;
-    scheddata.initialized = 1;
+    assert(sim != NULL);
+    assert(sim->workload != NULL);
+    assert(sim->batchsize > 0);
 }
 
 /** 
  * @brief Finalizes the SCA scheduler.
+ *
+ * @param sim Target simulation.
 */
-void scheduler_sca_end(void)
+void scheduler_sca_end(struct simulation *sim)
 {
-    scheddata.initialized = 0;
+    ((void) sim);
 }
 
 /**
  * @brief SCA scheduler. A Task will be scheduled to the same core (always). If a task hasn't been scheduled yet, it goes to the first free core.
  * 
+ * @param sim   Target simulation.
  * @param c     Target core.
  * @param tasks Mapped tasks to current core.
  * 
  * @returns Number of scheduled tasks.
 */
-int scheduler_sca_sched(core_tt c, queue_tt tasks)
+int scheduler_sca_sched(struct simulation *sim, core_tt c, queue_tt tasks)
 {
     int n = 0;       /* Number of tasks scheduled.      */
 	int wsize = 0;   /* Size of assigned work.          */
-	int wk_size = workload_totaltasks(scheddata.workload); /* Total number of left tasks in workload. */
+	int wk_size = workload_totaltasks(sim->workload); /* Total number of left tasks in workload. */
 	int cr_size = queue_size(tasks);  /* Current number of tasks that have 'arrived'. */
 
 	
 	/* We should schedule when there are, atleast, batchsize tasks free OR whenever the total left has arrived. */
-	if ( cr_size >= scheddata.batchsize || wk_size == cr_size )
+	if ( cr_size >= sim->batchsize || wk_size == cr_size )
 	{
 		/* Get Tasks. */
 		for ( int i = 0; i < cr_size; i++ )
 		{
             /* Scheduled enough tasks. */
-            if ( n == scheddata.batchsize) break;
+            if ( n == sim->batchsize) break;
 
             task_tt curr_task = queue_remove(tasks);
             
@@ -90,7 +73,7 @@ int scheduler_sca_sched(core_tt c, queue_tt tasks)
 	}
 	
 	/* If any task was scheduled, global 'time' must increase based on number of scheduled tasks. */
-    g_iterator += ( n > 0 ) ? n : 1;
+    sim->clock += ( n > 0 ) ? n : 1;
 	
 
 	return (n);
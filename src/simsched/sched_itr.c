@@ -1,6 +1,7 @@
 
 #include <assert.h>
 #include <mylib/util.h>
+#include <mylib/arena.h>
 #include <stdlib.h>
 
 #include <sched_itr.h>
@@ -13,6 +14,7 @@ struct sched_itr
     unsigned long int twork; /**< Total workload assigned.                      */
     int pmiss;               /**< Total time spent with misses in an iteration. */
     int ntasks;              /**< Total number of tasks assgnied at that itr.   */
+    arena_tt arena;          /**< Arena of the iteration (may be NULL).         */
 };
 
 /**
@@ -20,9 +22,10 @@ struct sched_itr
  * 
  * @param twork  Total work assigned to a core in a given scheduling iteration.
  * @param ntasks Total number of tasks assigned to a core in the same iteration.
+ * @param arena  Arena to allocate from (NULL for the C library).
  *
 */
-sched_itr_tt scheditr_create(unsigned long int twork, int ntasks)
+sched_itr_tt scheditr_create(unsigned long int twork, int ntasks, arena_tt arena)
 {
 	struct sched_itr *si;
 
@@ -30,7 +33,8 @@ sched_itr_tt scheditr_create(unsigned long int twork, int ntasks)
 	assert(ntasks >= 0);
 
 
-	si = smalloc(sizeof(struct sched_itr));
+	si = arena_smalloc(arena, sizeof(struct sched_itr));
+    si->arena = arena;
 
     si->twork = twork;
     si->ntasks = ntasks;
@@ -108,5 +112,5 @@ void scheditr_destroy(struct sched_itr *si)
 	/* Sanity check. */
     assert(si != NULL);
 
-    free(si);
+    arena_sfree(si->arena, si);
 }
\ No newline at end of file
@@ -2,132 +2,915 @@
 #include <limits.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <mylib/util.h>
 #include <mylib/array.h>
-#include <mylib/dqueue.h>
 #include <mylib/queue.h>
+#include <mylib/sketch.h>
+#include <mylib/writer.h>
 #include <kmeans.h>
 
 #include <core.h>
 #include <model.h>
+#include <profile.h>
 #include <ram.h>
 #include <sched_itr.h>
 #include <scheduler.h>
 #include <workload.h>
 
 /**
- * @brief Global iterator.
-*/
-int g_iterator = 0;
+ * @brief Size of the buffer of statistics output (in bytes).
+ */
+#define DUMP_BUFSIZE (64*1024)
 
 /**
- * @brief Ready cores.
+ * @brief Version of the schema of CSV and JSON statistics.
  */
-static queue_tt ready;
+#define DUMP_VERSION 4
 
 /**
- * @brief Processing cores.
-*/
-static queue_tt processing;
+ * @brief Relative accuracy of percentiles estimated with a sketch.
+ */
+#define DUMP_SKETCH_ACCURACY 0.01
 
 /**
- * @brief Running cores.
+ * @brief Metrics of a finished task.
  */
-static queue_tt running;
+struct row
+{
+	unsigned long int id;          /**< Real ID.      */
+	unsigned long int tsid;        /**< Task ID.      */
+	unsigned long int waiting;     /**< Waiting time. */
+	unsigned long int page_hits;   /**< Page hits.    */
+	unsigned long int page_faults; /**< Page faults.  */
+	unsigned long int hits;        /**< Cache hits.   */
+	unsigned long int misses;      /**< Cache misses. */
+	unsigned long int tlb_hits;    /**< TLB hits.     */
+	unsigned long int tlb_misses;  /**< TLB misses.   */
+	float slowdown;                /**< Slowdown.     */
+};
 
-void sort_ascending(unsigned long int *a, int nelements, unsigned long int *m, unsigned long int *ph, unsigned long int *pf, unsigned long int *h, unsigned long int *mi, float *sl, unsigned long int *ids)
+/**
+ * @brief Metrics of finished tasks.
+ */
+struct columns
 {
-	/* Sanity check. */
-	assert(a != NULL);
-	assert(m != NULL);
-	assert(ph != NULL);
-	assert(pf != NULL);
-	assert(h != NULL);
-	assert(mi != NULL);
-	assert(sl != NULL);
-	assert(nelements > 0);
+	int ntasks;       /**< Number of tasks.                 */
+	struct row *rows; /**< Metrics of each task.            */
+	int *perm;        /**< Tasks in ascending waiting time. */
+};
+
+/**
+ * @brief Percentiles of waiting time and slowdown.
+ *
+ * @details There is room for one percentile more than can be reported,
+ *          so that p99 is computed along with them.
+ */
+struct percentiles
+{
+	int n;                                                 /**< Number of percentiles.    */
+	double p[REPORT_MAX_PERCENTILES + 1];                  /**< Percentiles.              */
+	unsigned long int waiting[REPORT_MAX_PERCENTILES + 1]; /**< Waiting time percentiles. */
+	double slowdown[REPORT_MAX_PERCENTILES + 1];           /**< Slowdown percentiles.     */
+	bool sketch;                                           /**< Estimated with a sketch?  */
+};
+
+/**
+ * @brief Sorting key of a task.
+ */
+struct rank
+{
+	unsigned long int waiting; /**< Waiting time. */
+	unsigned long int tsid;    /**< Task ID.      */
+	int idx;                   /**< Column index. */
+};
+
+/**
+ * @brief Compares two tasks by waiting time, then by task ID.
+ */
+static int rank_compare(const void *a, const void *b)
+{
+	const struct rank *r1 = a;
+	const struct rank *r2 = b;
+
+	if (r1->waiting != r2->waiting)
+		return ((r1->waiting < r2->waiting) ? -1 : 1);
+	if (r1->tsid != r2->tsid)
+		return ((r1->tsid < r2->tsid) ? -1 : 1);
+
+	return (0);
+}
+
+/**
+ * @brief Compares two floats.
+ */
+static int float_compare(const void *a, const void *b)
+{
+	float f1 = *((const float *) a);
+	float f2 = *((const float *) b);
+
+	return ((f1 > f2) - (f1 < f2));
+}
+
+/**
+ * @brief Gathers the metrics of a finished task.
+ *
+ * @param r Where to store the metrics.
+ * @param t Target task.
+ */
+static void row_create(struct row *r, const_task_tt t)
+{
+	r->id = task_realid(t);
+	r->tsid = task_gettsid(t);
+	r->waiting = task_waiting_time(t);
+	r->page_hits = task_page_hit(t);
+	r->page_faults = task_page_fault(t);
+	r->hits = task_hit(t);
+	r->misses = task_miss(t);
+	r->tlb_hits = task_tlb_hit(t);
+	r->tlb_misses = task_tlb_miss(t);
+	r->slowdown = task_slowdown(t);
+}
+
+/**
+ * @brief Gathers the metrics of finished tasks.
+ *
+ * @details Tasks are ranked by waiting time, ties broken by task ID,
+ *          through a permutation of column indexes.
+ *
+ * @param cols Where to store the metrics.
+ * @param w    Target workload.
+ */
+static void columns_create(struct columns *cols, workload_tt w)
+{
+	struct rank *ranks;
+	int n = queue_size(workload_fintasks(w));
 
-	/* Short array. */
-	for ( int i = 0; i < nelements; i++ )
+	cols->ntasks = n;
+	cols->rows = smalloc(n*sizeof(struct row));
+	cols->perm = smalloc(n*sizeof(int));
+	ranks = smalloc(n*sizeof(struct rank));
+
+	for (int k = 0; k < n; k++)
+	{
+		row_create(&cols->rows[k], queue_peek(workload_fintasks(w), k));
+
+		ranks[k].waiting = cols->rows[k].waiting;
+		ranks[k].tsid = cols->rows[k].tsid;
+		ranks[k].idx = k;
+	}
+
+	qsort(ranks, n, sizeof(struct rank), rank_compare);
+	for (int k = 0; k < n; k++)
+		cols->perm[k] = ranks[k].idx;
+
+	/* House keeping. */
+	sfree(ranks);
+}
+
+/**
+ * @brief Releases the metrics of finished tasks.
+ *
+ * @param cols Target metrics.
+ */
+static void columns_destroy(struct columns *cols)
+{
+	sfree(cols->rows);
+	sfree(cols->perm);
+}
+
+/**
+ * @brief Locates a percentile in n sorted values.
+ *
+ * @details The percentile p lies at index p*n/100 - 1. When that index
+ *          is whole, the percentile is the mean of the values at it and
+ *          at the next one.
+ *
+ * @param n        Number of values.
+ * @param p        Target percentile, in (0, 100].
+ * @param midpoint Set if the percentile is a mean of two values.
+ *
+ * @returns The index of the (first) value of the percentile.
+ */
+static int percentile_index(int n, double p, bool *midpoint)
+{
+	double index = ((p/100.0) * n) - 1;
+	int rounded_index = round(index);
+
+	*midpoint = (index == rounded_index);
+
+	if (rounded_index < 0)
+		rounded_index = 0;
+	if (rounded_index > n - 1)
+		rounded_index = n - 1;
+	if (rounded_index == n - 1)
+		*midpoint = false;
+
+	return (rounded_index);
+}
+
+/**
+ * @brief Computes exact percentiles of waiting time and slowdown.
+ *
+ * @param pct  Where to store percentiles.
+ * @param cols Metrics of finished tasks.
+ */
+static void percentiles_exact(struct percentiles *pct, const struct columns *cols)
+{
+	int n = cols->ntasks;
+	float *sorted;
+
+	pct->sketch = false;
+
+	if (n == 0)
 	{
-		for ( int j = 0; j < nelements; j++ )
+		for (int i = 0; i < pct->n; i++)
 		{
-			if ( a[j] > a[i] )
-			{
-				unsigned long int tmp; /* Temporary data. */
-				float tmpf;
+			pct->waiting[i] = 0;
+			pct->slowdown[i] = 0.0;
+		}
+		return;
+	}
+
+	sorted = smalloc(n*sizeof(float));
+	for (int k = 0; k < n; k++)
+		sorted[k] = cols->rows[k].slowdown;
+	qsort(sorted, n, sizeof(float), float_compare);
+
+	for (int i = 0; i < pct->n; i++)
+	{
+		bool midpoint;
+		int k = percentile_index(n, pct->p[i], &midpoint);
+		unsigned long int w1 = cols->rows[cols->perm[k]].waiting;
+		float s1 = sorted[k];
+
+		if (midpoint)
+		{
+			unsigned long int w2 = cols->rows[cols->perm[k + 1]].waiting;
+			float s2 = sorted[k + 1];
+
+			pct->waiting[i] = (w1 + w2) / 2;
+			pct->slowdown[i] = (s1 + s2) / 2;
+		}
+		else
+		{
+			pct->waiting[i] = w1;
+			pct->slowdown[i] = s1;
+		}
+	}
 
-				tmp = a[i];
-				a[i] = a[j];
-				a[j] = tmp;
+	/* House keeping. */
+	sfree(sorted);
+}
 
-				tmp = m[i];
-				m[i] = m[j];
-				m[j] = tmp;
+/**
+ * @brief Estimates percentiles of waiting time and slowdown.
+ *
+ * @param pct      Where to store percentiles.
+ * @param waiting  Waiting times of finished tasks.
+ * @param slowdown Slowdowns of finished tasks.
+ */
+static void percentiles_sketch(struct percentiles *pct, const_sketch_tt waiting, const_sketch_tt slowdown)
+{
+	int n = sketch_count(waiting);
 
-				tmp = ph[i];
-				ph[i] = ph[j];
-				ph[j] = tmp;
+	pct->sketch = true;
 
-				tmp = pf[i];
-				pf[i] = pf[j];
-				pf[j] = tmp;
+	for (int i = 0; i < pct->n; i++)
+	{
+		bool midpoint;
+		int k = (n > 0) ? percentile_index(n, pct->p[i], &midpoint) : 0;
+		double w1 = sketch_rank(waiting, k);
+		double s1 = sketch_rank(slowdown, k);
 
-				tmp = h[i];
-				h[i] = h[j];
-				h[j] = tmp;
+		if ((n > 0) && midpoint)
+		{
+			w1 = (w1 + sketch_rank(waiting, k + 1))/2;
+			s1 = (s1 + sketch_rank(slowdown, k + 1))/2;
+		}
 
-				tmp = mi[i];
-				mi[i] = mi[j];
-				mi[j] = tmp;
+		pct->waiting[i] = (unsigned long int) (w1 + 0.5);
+		pct->slowdown[i] = s1;
+	}
+}
 
-				tmpf = sl[i];
-				sl[i] = sl[j];
-				sl[j] = tmpf;
+/**
+ * @brief Load balance of scheduling iterations.
+ *
+ * @details Per-core metrics of iterations are kept in flat arrays, one
+ *          row of ncores entries per iteration, in the order of cores
+ *          in the array of working cores. The first iteration of each
+ *          core is a placeholder and it is left out.
+ */
+struct imbalance
+{
+	int ncores;                          /**< Number of cores.                          */
+	int nitrs;                           /**< Number of iterations.                     */
+	int *cids;                           /**< Core IDs.                                 */
+	unsigned long int *work;             /**< Workload of cores.                        */
+	int *ntasks;                         /**< Number of tasks of cores.                 */
+	int *cachemiss;                      /**< Cache misses of cores.                    */
+	unsigned long int *work_unbalance;   /**< Workload unbalancement of iterations.     */
+	int *ntasks_unbalance;               /**< Tasks unbalancement of iterations.        */
+	int *cachemiss_unbalance;            /**< Cache miss unbalancement of iterations.   */
+	double *max_mean;                    /**< Max over mean workload of iterations.     */
+	unsigned long int work_total;        /**< Total workload unbalancement.             */
+	int ntasks_total;                    /**< Total tasks unbalancement.                */
+	int cachemiss_total;                 /**< Total cache miss unbalancement.           */
+	double max_mean_avg;                 /**< Mean of max over mean workload.           */
+	double max_mean_max;                 /**< Largest max over mean workload.           */
+};
 
-				tmp = ids[i];
-				ids[i] = ids[j];
-				ids[j] = tmp;
-			}
+/**
+ * @brief Compares two unsigned long integers.
+ */
+static int ulong_compare(const void *a, const void *b)
+{
+	unsigned long int u1 = *((const unsigned long int *) a);
+	unsigned long int u2 = *((const unsigned long int *) b);
+
+	return ((u1 > u2) - (u1 < u2));
+}
+
+/**
+ * @brief Compares two integers.
+ */
+static int int_compare(const void *a, const void *b)
+{
+	int i1 = *((const int *) a);
+	int i2 = *((const int *) b);
+
+	return ((i1 > i2) - (i1 < i2));
+}
+
+/**
+ * @brief Sums absolute differences between all pairs of values.
+ *
+ * @details Once sorted, the ith value exceeds each of the i values
+ *          before it, so it adds i times itself minus their sum.
+ *
+ * @param a Target values, sorted on return.
+ * @param n Number of values.
+ *
+ * @returns The sum of |a[j] - a[k]| over all j < k.
+ */
+static unsigned long int pairwise_ulong(unsigned long int *a, int n)
+{
+	unsigned long int sum = 0, prefix = 0;
+
+	qsort(a, n, sizeof(unsigned long int), ulong_compare);
+
+	for (int i = 0; i < n; i++)
+	{
+		sum += i*a[i] - prefix;
+		prefix += a[i];
+	}
+
+	return (sum);
+}
+
+/**
+ * @brief Sums absolute differences between all pairs of values.
+ *
+ * @param a Target values, sorted on return.
+ * @param n Number of values.
+ *
+ * @returns The sum of |a[j] - a[k]| over all j < k.
+ */
+static long int pairwise_int(int *a, int n)
+{
+	long int sum = 0, prefix = 0;
+
+	qsort(a, n, sizeof(int), int_compare);
+
+	for (int i = 0; i < n; i++)
+	{
+		sum += ((long int) i)*a[i] - prefix;
+		prefix += a[i];
+	}
+
+	return (sum);
+}
+
+/**
+ * @brief Computes the load balance of scheduling iterations.
+ *
+ * @param imb   Where to store the load balance.
+ * @param cores Working cores.
+ */
+static void imbalance_create(struct imbalance *imb, array_tt cores)
+{
+	int ncores = array_size(cores);
+	int nitrs = queue_size(core_workloads(array_get(cores, 0))) - 1;
+	unsigned long int *wrk;
+	int *scratch;
+
+	if (nitrs < 0)
+		nitrs = 0;
+
+	imb->ncores = ncores;
+	imb->nitrs = nitrs;
+	imb->cids = smalloc(ncores*sizeof(int));
+	imb->work = smalloc(nitrs*ncores*sizeof(unsigned long int));
+	imb->ntasks = smalloc(nitrs*ncores*sizeof(int));
+	imb->cachemiss = smalloc(nitrs*ncores*sizeof(int));
+	imb->work_unbalance = smalloc(nitrs*sizeof(unsigned long int));
+	imb->ntasks_unbalance = smalloc(nitrs*sizeof(int));
+	imb->cachemiss_unbalance = smalloc(nitrs*sizeof(int));
+	imb->max_mean = smalloc(nitrs*sizeof(double));
+	imb->work_total = 0;
+	imb->ntasks_total = 0;
+	imb->cachemiss_total = 0;
+	imb->max_mean_avg = 0.0;
+	imb->max_mean_max = 0.0;
+
+	/* Flatten iterations, one core at a time. */
+	for (int j = 0; j < ncores; j++)
+	{
+		core_tt c = array_get(cores, j);
+		queue_tt itrs = core_workloads(c);
+
+		imb->cids[j] = core_getcid(c);
+		for (int i = 0; i < nitrs; i++)
+		{
+			const_sched_itr_tt si = queue_peek(itrs, i + 1);
+
+			imb->work[i*ncores + j] = scheditr_twork(si);
+			imb->ntasks[i*ncores + j] = scheditr_ntasks(si);
+			imb->cachemiss[i*ncores + j] = scheditr_pmiss(si);
 		}
 	}
-	
+
+	wrk = smalloc(ncores*sizeof(unsigned long int));
+	scratch = smalloc(ncores*sizeof(int));
+
+	for (int i = 0; i < nitrs; i++)
+	{
+		unsigned long int sum = 0;
+		double mean;
+
+		for (int j = 0; j < ncores; j++)
+		{
+			wrk[j] = imb->work[i*ncores + j];
+			sum += wrk[j];
+		}
+		imb->work_unbalance[i] = pairwise_ulong(wrk, ncores);
+
+		/* Sorted, so the largest workload comes last. */
+		mean = ((double) sum)/ncores;
+		imb->max_mean[i] = (sum > 0) ? wrk[ncores - 1]/mean : 1.0;
+
+		for (int j = 0; j < ncores; j++)
+			scratch[j] = imb->ntasks[i*ncores + j];
+		imb->ntasks_unbalance[i] = pairwise_int(scratch, ncores);
+
+		for (int j = 0; j < ncores; j++)
+			scratch[j] = imb->cachemiss[i*ncores + j];
+		imb->cachemiss_unbalance[i] = pairwise_int(scratch, ncores);
+
+		imb->work_total += imb->work_unbalance[i];
+		imb->ntasks_total += imb->ntasks_unbalance[i];
+		imb->cachemiss_total += imb->cachemiss_unbalance[i];
+		imb->max_mean_avg += imb->max_mean[i];
+		if (imb->max_mean_max < imb->max_mean[i])
+			imb->max_mean_max = imb->max_mean[i];
+	}
+	if (nitrs > 0)
+		imb->max_mean_avg /= nitrs;
+
+	/* House keeping. */
+	sfree(scratch);
+	sfree(wrk);
 }
 
-void one_sort_asceding(float *a, int nelements)
+/**
+ * @brief Releases the load balance of scheduling iterations.
+ *
+ * @param imb Target load balance.
+ */
+static void imbalance_destroy(struct imbalance *imb)
 {
-	assert(a != NULL);
-	
+	sfree(imb->cids);
+	sfree(imb->work);
+	sfree(imb->ntasks);
+	sfree(imb->cachemiss);
+	sfree(imb->work_unbalance);
+	sfree(imb->ntasks_unbalance);
+	sfree(imb->cachemiss_unbalance);
+	sfree(imb->max_mean);
+}
+
+/**
+ * @brief Dumps a floating point number as a JSON value.
+ *
+ * @param wr    Target writer.
+ * @param value Target number.
+ */
+static void dump_json_double(writer_tt wr, double value)
+{
+	if (isfinite(value))
+		writer_printf(wr, "%lf", value);
+	else
+		writer_puts(wr, "null");
+}
 
-	for ( int i = 0; i < nelements; i++ )
+/**
+ * @brief Dumps statistics of a task.
+ *
+ * @details Plain text only lists TLB hits and misses when cores have
+ *          a TLB.
+ *
+ * @param wr     Target writer.
+ * @param format Output format.
+ * @param first  Is this the first task?
+ * @param tlb    Do cores have a TLB?
+ * @param r      Metrics of the task.
+ */
+static void dump_task(writer_tt wr, enum simsched_output format, bool first, bool tlb, const struct row *r)
+{
+	switch (format)
 	{
-		for ( int j = 0; j < nelements; j++ )
+		case OUTPUT_TEXT:
+			writer_printf(wr, "%3lu | %3lu | %10lu | %5lu %5lu | %5lu %5lu | ",
+				r->id, r->tsid, r->waiting, r->page_hits, r->page_faults, r->hits, r->misses
+			);
+			if (tlb)
+				writer_printf(wr, "%5lu %5lu | ", r->tlb_hits, r->tlb_misses);
+			writer_printf(wr, "%lf\n", r->slowdown);
+			break;
+
+		case OUTPUT_CSV:
+			writer_printf(wr, "task,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lf\n",
+				r->id, r->tsid, r->waiting, r->page_hits, r->page_faults, r->hits, r->misses, r->tlb_hits, r->tlb_misses, r->slowdown
+			);
+			break;
+
+		case OUTPUT_JSON:
+			writer_printf(wr, "%s\n    {\"id\": %lu, \"tsid\": %lu, \"waiting_time\": %lu, ", (first) ? "" : ",", r->id, r->tsid, r->waiting);
+			writer_printf(wr, "\"page_hits\": %lu, \"page_faults\": %lu, ", r->page_hits, r->page_faults);
+			writer_printf(wr, "\"cache_hits\": %lu, \"cache_misses\": %lu, ", r->hits, r->misses);
+			writer_printf(wr, "\"tlb_hits\": %lu, \"tlb_misses\": %lu, \"slowdown\": ", r->tlb_hits, r->tlb_misses);
+			dump_json_double(wr, r->slowdown);
+			writer_puts(wr, "}");
+			break;
+	}
+}
+
+/**
+ * @brief Dumps the header of the statistics of tasks.
+ *
+ * @param wr     Target writer.
+ * @param format Output format.
+ */
+static void dump_tasks_begin(writer_tt wr, enum simsched_output format)
+{
+	if (format == OUTPUT_CSV)
+		writer_puts(wr, "kind,id,tsid,waiting_time,page_hits,page_faults,cache_hits,cache_misses,tlb_hits,tlb_misses,slowdown\n");
+	else if (format == OUTPUT_JSON)
+		writer_puts(wr, "  \"tasks\": [");
+}
+
+/**
+ * @brief Dumps the trailer of the statistics of tasks.
+ *
+ * @param wr     Target writer.
+ * @param format Output format.
+ */
+static void dump_tasks_end(writer_tt wr, enum simsched_output format)
+{
+	if (format == OUTPUT_JSON)
+		writer_puts(wr, "\n  ],\n");
+}
+
+/**
+ * @brief Dumps statistics of cores.
+ *
+ * @details Plain text only lists cores' TLB statistics, and only when
+ *          cores have a TLB.
+ *
+ * @param wr     Target writer.
+ * @param format Output format.
+ * @param cores  Working cores.
+ */
+static void dump_cores(writer_tt wr, enum simsched_output format, array_tt cores)
+{
+	if (format == OUTPUT_CSV)
+		writer_puts(wr, "kind,core,page_hits,page_faults,cache_hits,cache_misses,tlb_hits,tlb_misses,tlb_flushes\n");
+	else if (format == OUTPUT_JSON)
+		writer_puts(wr, "  \"cores\": [");
+
+	for (unsigned long int i = 0; i < array_size(cores); i++)
+	{
+		core_tt c = array_get(cores, i);
+
+		switch (format)
 		{
-			if ( a[j] > a[i] )
+			case OUTPUT_TEXT:
+				if (core_has_tlb(c))
+				{
+					writer_printf(wr, "Core %d TLB hits: %lu - TLB misses: %lu - TLB flushes: %lu\n",
+						core_getcid(c), core_tlb_hit(c), core_tlb_miss(c), core_tlb_flushes(c)
+					);
+				}
+				break;
+
+			case OUTPUT_CSV:
+				writer_printf(wr, "core,%d,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+					core_getcid(c), core_page_hit(c), core_page_fault(c), core_hit(c), core_miss(c),
+					core_tlb_hit(c), core_tlb_miss(c), core_tlb_flushes(c)
+				);
+				break;
+
+			case OUTPUT_JSON:
+				writer_printf(wr, "%s\n    {\"core\": %d, \"page_hits\": %lu, \"page_faults\": %lu, \"cache_hits\": %lu, \"cache_misses\": %lu, ",
+					(i == 0) ? "" : ",", core_getcid(c), core_page_hit(c), core_page_fault(c), core_hit(c), core_miss(c)
+				);
+				writer_printf(wr, "\"tlb_hits\": %lu, \"tlb_misses\": %lu, \"tlb_flushes\": %lu}",
+					core_tlb_hit(c), core_tlb_miss(c), core_tlb_flushes(c)
+				);
+				break;
+		}
+	}
+
+	if (format == OUTPUT_JSON)
+		writer_puts(wr, "\n  ],\n");
+}
+
+/**
+ * @brief Dumps the scheduling iterations of cores, and their balance.
+ *
+ * @details Iterations are numbered from one, as the first iteration of
+ *          each core is a placeholder. Plain text has no such records.
+ *
+ * @param wr     Target writer.
+ * @param format Output format.
+ * @param imb    Load balance of scheduling iterations.
+ */
+static void dump_itrs(writer_tt wr, enum simsched_output format, const struct imbalance *imb)
+{
+	int ncores = imb->ncores;
+
+	if (format == OUTPUT_TEXT)
+		return;
+
+	/* Per-core iterations. */
+	if (format == OUTPUT_CSV)
+		writer_puts(wr, "kind,core,iteration,ntasks,work,cache_misses\n");
+	else
+		writer_puts(wr, "  \"iterations\": [");
+
+	for (int j = 0; j < ncores; j++)
+	{
+		for (int i = 0; i < imb->nitrs; i++)
+		{
+			int k = i*ncores + j;
+
+			if (format == OUTPUT_CSV)
+			{
+				writer_printf(wr, "iteration,%d,%d,%d,%lu,%d\n",
+					imb->cids[j], i + 1, imb->ntasks[k], imb->work[k], imb->cachemiss[k]
+				);
+			}
+			else
+			{
+				writer_printf(wr, "%s\n    {\"core\": %d, \"iteration\": %d, \"ntasks\": %d, \"work\": %lu, \"cache_misses\": %d}",
+					((j == 0) && (i == 0)) ? "" : ",", imb->cids[j], i + 1, imb->ntasks[k], imb->work[k], imb->cachemiss[k]
+				);
+			}
+		}
+	}
+
+	if (format == OUTPUT_JSON)
+		writer_puts(wr, "\n  ],\n");
+
+	/* Balance of iterations. */
+	if (format == OUTPUT_CSV)
+		writer_puts(wr, "kind,iteration,workload_unbalance,ntasks_unbalance,cachemiss_unbalance,max_mean\n");
+	else
+		writer_puts(wr, "  \"imbalance\": [");
+
+	for (int i = 0; i < imb->nitrs; i++)
+	{
+		if (format == OUTPUT_CSV)
+		{
+			writer_printf(wr, "imbalance,%d,%lu,%d,%d,%lf\n",
+				i + 1, imb->work_unbalance[i], imb->ntasks_unbalance[i], imb->cachemiss_unbalance[i], imb->max_mean[i]
+			);
+		}
+		else
+		{
+			writer_printf(wr, "%s\n    {\"iteration\": %d, \"workload_unbalance\": %lu, \"ntasks_unbalance\": %d, \"cachemiss_unbalance\": %d, \"max_mean\": %lf}",
+				(i == 0) ? "" : ",", i + 1, imb->work_unbalance[i], imb->ntasks_unbalance[i], imb->cachemiss_unbalance[i], imb->max_mean[i]
+			);
+		}
+	}
+
+	if (format == OUTPUT_JSON)
+		writer_puts(wr, "\n  ],\n");
+}
+
+/**
+ * @brief Dumps summary statistics.
+ *
+ * @param wr         Target writer.
+ * @param format     Output format.
+ * @param cores      Working cores.
+ * @param RAM        Simulation's RAM.
+ * @param s          Summary statistics.
+ * @param pct        Percentiles of waiting time and slowdown.
+ * @param imb        Load balance of scheduling iterations.
+ * @param nlevels    Number of cache levels.
+ * @param level_hit  Cache hits of each level.
+ * @param level_miss Cache misses of each level.
+ */
+static void dump_summary(writer_tt wr, enum simsched_output format, array_tt cores, const_RAM_tt RAM, const struct simstats *s, const struct percentiles *pct, const struct imbalance *imb, int nlevels, const unsigned long int *level_hit, const unsigned long int *level_miss)
+{
+	const char *paging = page_policy_name(RAM_policy(RAM));
+
+	switch (format)
+	{
+		case OUTPUT_TEXT:
+			writer_printf(wr, "waiting time sum: %lu\n", s->waiting_sum);
+			for (int i = 0; i < pct->n; i++)
+				writer_printf(wr, "%gth Percentile Waiting Time: %lu\n", pct->p[i], pct->waiting[i]);
+			for (int i = 0; i < pct->n; i++)
+				writer_printf(wr, "%gth Percentile Tasks' Slowdown: %f\n", pct->p[i], pct->slowdown[i]);
+			writer_printf(wr, "Total page hits: %lu - Total page faults: %lu\n", s->page_hits, s->page_faults);
+			if ( core_has_tlb(array_get(cores, 0)) )
+				writer_printf(wr, "Total TLB hits: %lu - Total TLB misses: %lu\n", s->tlb_hits, s->tlb_misses);
+			writer_printf(wr, "Page replacement (%s) faults: %lu - evictions: %lu\n", paging, RAM_faults(RAM), s->evictions);
+			writer_printf(wr, "Total cache hits: %lu - Total cache misses: %lu\n", s->cache_hits, s->cache_misses);
+			/* Outer cache levels. */
+			for ( int l = 1; l < nlevels; l++ )
+				writer_printf(wr, "Total L%d cache hits: %lu - Total L%d cache misses: %lu\n", l + 1, level_hit[l], l + 1, level_miss[l]);
+			writer_printf(wr, "Total Unbalancement: %lu\n", s->workload_unbalance);
+			writer_printf(wr, "Total Workload Unbalancement: %lu\n", s->workload_unbalance);
+			writer_printf(wr, "Total Number of Tasks Unbalancement: %d\n", s->ntasks_unbalance);
+			writer_printf(wr, "Total Cache Miss Unbalancement: %d\n", s->cachemiss_unbalance);
+			writer_printf(wr, "time: %lu\n", s->time);
+			writer_printf(wr, "cost: %lu\n", s->cost);
+			writer_printf(wr, "performance: %ld\n", s->performance);
+			writer_printf(wr, "total: %lu\n", s->total);
+			writer_printf(wr, "cov: %lf\n", s->cov);
+			writer_printf(wr, "slowdown: %lf\n", s->slowdown);
+			break;
+
+		case OUTPUT_CSV:
+			writer_puts(wr, "kind,level,cache_hits,cache_misses\n");
+			for ( int l = 0; l < nlevels; l++ )
+				writer_printf(wr, "level,%d,%lu,%lu\n", l + 1, level_hit[l], level_miss[l]);
+			writer_puts(wr, "kind,percentile,waiting_time,slowdown\n");
+			for (int i = 0; i < pct->n; i++)
+				writer_printf(wr, "percentile,%g,%lu,%lf\n", pct->p[i], pct->waiting[i], pct->slowdown[i]);
+			writer_puts(wr, "kind,name,value\n");
+			writer_printf(wr, "summary,version,%d\n", DUMP_VERSION);
+			writer_printf(wr, "summary,percentiles,%s\n", (pct->sketch) ? "sketch" : "exact");
+			writer_printf(wr, "summary,waiting_sum,%lu\n", s->waiting_sum);
+			writer_printf(wr, "summary,waiting_p99,%lu\n", s->waiting_p99);
+			writer_printf(wr, "summary,slowdown_p99,%f\n", s->slowdown_p99);
+			writer_printf(wr, "summary,page_hits,%lu\n", s->page_hits);
+			writer_printf(wr, "summary,page_faults,%lu\n", s->page_faults);
+			writer_printf(wr, "summary,paging,%s\n", paging);
+			writer_printf(wr, "summary,paging_faults,%lu\n", RAM_faults(RAM));
+			writer_printf(wr, "summary,evictions,%lu\n", s->evictions);
+			writer_printf(wr, "summary,cache_hits,%lu\n", s->cache_hits);
+			writer_printf(wr, "summary,cache_misses,%lu\n", s->cache_misses);
+			writer_printf(wr, "summary,tlb_hits,%lu\n", s->tlb_hits);
+			writer_printf(wr, "summary,tlb_misses,%lu\n", s->tlb_misses);
+			writer_printf(wr, "summary,workload_unbalance,%lu\n", s->workload_unbalance);
+			writer_printf(wr, "summary,ntasks_unbalance,%d\n", s->ntasks_unbalance);
+			writer_printf(wr, "summary,cachemiss_unbalance,%d\n", s->cachemiss_unbalance);
+			writer_printf(wr, "summary,max_mean_avg,%lf\n", imb->max_mean_avg);
+			writer_printf(wr, "summary,max_mean_max,%lf\n", imb->max_mean_max);
+			writer_printf(wr, "summary,time,%lu\n", s->time);
+			writer_printf(wr, "summary,cost,%lu\n", s->cost);
+			writer_printf(wr, "summary,performance,%lu\n", s->performance);
+			writer_printf(wr, "summary,total,%lu\n", s->total);
+			writer_printf(wr, "summary,cov,%lf\n", s->cov);
+			writer_printf(wr, "summary,slowdown,%lf\n", s->slowdown);
+			break;
+
+		case OUTPUT_JSON:
+			writer_puts(wr, "  \"levels\": [");
+			for ( int l = 0; l < nlevels; l++ )
+			{
+				writer_printf(wr, "%s\n    {\"level\": %d, \"cache_hits\": %lu, \"cache_misses\": %lu}",
+					(l == 0) ? "" : ",", l + 1, level_hit[l], level_miss[l]
+				);
+			}
+			writer_puts(wr, "\n  ],\n");
+			writer_puts(wr, "  \"percentiles\": [");
+			for (int i = 0; i < pct->n; i++)
 			{
-				float tmp = a[i];
-				a[i] = a[j];
-				a[j] = tmp;
+				writer_printf(wr, "%s\n    {\"percentile\": %g, \"waiting_time\": %lu, \"slowdown\": ",
+					(i == 0) ? "" : ",", pct->p[i], pct->waiting[i]
+				);
+				dump_json_double(wr, pct->slowdown[i]);
+				writer_puts(wr, "}");
 			}
+			writer_puts(wr, "\n  ],\n");
+			writer_puts(wr, "  \"summary\": {\n");
+			writer_printf(wr, "    \"percentiles\": \"%s\",\n", (pct->sketch) ? "sketch" : "exact");
+			writer_printf(wr, "    \"waiting_sum\": %lu, \"waiting_p99\": %lu, \"slowdown_p99\": ", s->waiting_sum, s->waiting_p99);
+			dump_json_double(wr, s->slowdown_p99);
+			writer_printf(wr, ",\n    \"page_hits\": %lu, \"page_faults\": %lu, ", s->page_hits, s->page_faults);
+			writer_printf(wr, "\"paging\": \"%s\", \"paging_faults\": %lu, \"evictions\": %lu,\n", paging, RAM_faults(RAM), s->evictions);
+			writer_printf(wr, "    \"cache_hits\": %lu, \"cache_misses\": %lu, ", s->cache_hits, s->cache_misses);
+			writer_printf(wr, "\"tlb_hits\": %lu, \"tlb_misses\": %lu,\n", s->tlb_hits, s->tlb_misses);
+			writer_printf(wr, "    \"workload_unbalance\": %lu, \"ntasks_unbalance\": %d, \"cachemiss_unbalance\": %d,\n",
+				s->workload_unbalance, s->ntasks_unbalance, s->cachemiss_unbalance
+			);
+			writer_printf(wr, "    \"max_mean_avg\": %lf, \"max_mean_max\": %lf,\n", imb->max_mean_avg, imb->max_mean_max);
+			writer_printf(wr, "    \"time\": %lu, \"cost\": %lu, \"performance\": %lu, \"total\": %lu, ",
+				s->time, s->cost, s->performance, s->total
+			);
+			writer_puts(wr, "\"cov\": ");
+			dump_json_double(wr, s->cov);
+			writer_puts(wr, ", \"slowdown\": ");
+			dump_json_double(wr, s->slowdown);
+			writer_puts(wr, "\n  }\n");
+			break;
+	}
+}
+
+/**
+ * @brief Dumps statistics of tasks, and computes their percentiles.
+ *
+ * @details Exact percentiles need every task ranked, and tasks are then
+ *          listed in ascending order of waiting time. Sketches are fed
+ *          as tasks finish, and tasks are then listed in order of
+ *          completion.
+ *
+ * @param wr     Target writer (may be NULL).
+ * @param format Output format.
+ * @param tlb    Do cores have a TLB?
+ * @param sim    Target simulation.
+ * @param pct    Where to store percentiles, of which only the
+ *               percentiles themselves must be set.
+ */
+static void dump_tasks(writer_tt wr, enum simsched_output format, bool tlb, const struct simulation *sim, struct percentiles *pct)
+{
+	queue_tt fintasks = workload_fintasks(sim->workload);
+
+	if (wr != NULL)
+		dump_tasks_begin(wr, format);
+
+	if (sim->waiting != NULL)
+	{
+		for (int k = 0; (wr != NULL) && (k < queue_size(fintasks)); k++)
+		{
+			struct row r;
+
+			row_create(&r, queue_peek(fintasks, k));
+			dump_task(wr, format, (k == 0), tlb, &r);
 		}
+
+		percentiles_sketch(pct, sim->waiting, sim->slowdown);
 	}
+	else
+	{
+		struct columns cols;
+
+		columns_create(&cols, sim->workload);
+
+		for (int k = 0; (wr != NULL) && (k < cols.ntasks); k++)
+			dump_task(wr, format, (k == 0), tlb, &cols.rows[cols.perm[k]]);
+
+		percentiles_exact(pct, &cols);
+
+		/* House keeping. */
+		columns_destroy(&cols);
+	}
+
+	if (wr != NULL)
+		dump_tasks_end(wr, format);
 }
 
 /**
  * @brief Dumps simulation statistics.
  *
- * @param cores    Working cores.
- * @param workload Workload.
+ * @param sim    Target simulation.
+ * @param report How to print statistics (may be NULL).
+ * @param stats  Where to store summary statistics (may be NULL).
  */
-static void simsched_dump(array_tt cores, workload_tt w)
+static void simsched_dump(const struct simulation *sim, const struct report *report, struct simstats *stats)
 {
+	array_tt cores = sim->cores;
+	const_RAM_tt RAM = sim->RAM;
 	unsigned long int min, max, total;
 	double mean, stddev;
-	int rounded_index;
-	int ntasks = workload_ntasks(w);
 	int ncores = array_size(cores);
+	struct simstats s;
+	struct percentiles pct;
+	struct imbalance imb;
+	writer_tt wr = NULL;
+	enum simsched_output format = OUTPUT_TEXT;
+	const double p99 = 99.0;
+	int ip99 = -1;
+	bool tlb = core_has_tlb(array_get(cores, 0));
 
 	min = INT_MAX; max = 0;
 	total = 0; mean = 0.0; stddev = 0.0;
@@ -165,104 +948,48 @@ static void simsched_dump(array_tt cores, workload_tt w)
 	} 
 	stddev = sqrt(stddev/(ncores));
 
-	/** Calculating Metrics */
-	unsigned long int ids[ntasks],                 //
-		              map[ntasks],                 // 
-		              waiting_times[ntasks],       //    
-					  task_page_hits[ntasks],	   // Tasks' metrics
-					  task_page_faults[ntasks],    //   
-		              task_hits[ntasks],           //
-		              task_misses[ntasks] ,        //
-		              percentile_waitingtime = 0;
-	int k = 0;
-	float percentile_slowdown   = 0;
-	float task_slowdown[ntasks];
-
-	double percentile_index = 0.0f;
-	for ( k = 0; k < ntasks; k++ )
-	{
-		task_tt curr_task = queue_peek(workload_fintasks(w), k);
-		ids[k] = task_realid(curr_task);
-		map[k] = task_gettsid(curr_task);
-		waiting_times[k] = task_waiting_time(curr_task);
-		task_page_hits[k] = task_page_hit(curr_task);
-		task_page_faults[k] = task_page_fault(curr_task); 
-		task_hits[k] = task_hit(curr_task);
-		task_misses[k] = task_miss(curr_task);
-		task_slowdown[k] = (((float) task_waiting_time(curr_task) + (float) task_workload(curr_task)) / ((float) task_workload(curr_task)));
+	/* Percentiles to compute, p99 always among them. */
+	pct.n = 0;
+	for (int i = 0; (report != NULL) && (i < report->npercentiles); i++)
+	{
+		if (report->percentiles[i] == p99)
+			ip99 = i;
+		pct.p[pct.n++] = report->percentiles[i];
+	}
+	if (ip99 < 0)
+	{
+		ip99 = pct.n;
+		pct.p[pct.n++] = p99;
 	}
 
-	sort_ascending(waiting_times, ntasks, map, task_page_hits, task_page_faults, task_hits, task_misses, task_slowdown, ids);
-
-	
 	/** Print statistics. */
-	// Mapping Task id with its corresponding accumulative waiting_time, cache hits and cache misses.
-	for ( int i = 0; i < k; i++)
+	if ((report != NULL) && (report->out != NULL))
 	{
-		printf("%3lu | %3lu | %10lu | %5lu %5lu | %5lu %5lu | %lf\n", ids[i], map[i], waiting_times[i], task_page_hits[i], task_page_faults[i], task_hits[i], task_misses[i], task_slowdown[i]);
-	}
-	one_sort_asceding(task_slowdown, ntasks);
-	
-	percentile_index = (0.99 * ntasks) - 1;
-		
-	rounded_index = round(percentile_index);
-	percentile_waitingtime = ( percentile_index == rounded_index ) ? (waiting_times[rounded_index] + waiting_times[rounded_index + 1]) / 2 : waiting_times[rounded_index];
-	percentile_slowdown = ( percentile_index == rounded_index ) ? ( task_slowdown[rounded_index] + task_slowdown[rounded_index + 1] ) / 2 : task_slowdown[rounded_index];
-	unsigned long int sum = 0;
-	for ( int i = 0; i < queue_size(workload_fintasks(w)); i++ )
-	{
-		task_tt ts = queue_peek(workload_fintasks(w), i);
-		sum += task_waiting_time(ts);
+		format = report->format;
+		wr = writer_create(report->out, DUMP_BUFSIZE);
+
+		if (format == OUTPUT_JSON)
+			writer_printf(wr, "{\n  \"version\": %d,\n", DUMP_VERSION);
 	}
 
-	// Analysing how well balanced was the scheduling.
-	int num_itr = queue_size(core_workloads(array_get(cores, 0)));
-
-	unsigned long int all_wrk[ncores];
-	int all_ntasks[ncores],
-	    all_cachemiss[ncores];
-	unsigned long int total_workload_unbalancement = 0;
-	int total_ntasks_unbalancement = 0;
-	int total_cachemiss_unbalancement = 0;
-	for ( int i = 1; i < num_itr; i++ )
-	{
-		unsigned long int wrk_diff = 0;
-		int ntasks_diff = 0,
-		    cachemiss_diff = 0;
-		for( unsigned long int j = 0; j < array_size(cores); j++ )
-		{
-			core_tt c = array_get(cores, j);
-			sched_itr_tt si = (sched_itr_tt) queue_peek(core_workloads(c), i);
+	// Mapping Task id with its corresponding accumulative waiting_time, cache hits and cache misses.
+	dump_tasks(wr, format, tlb, sim, &pct);
+	s.waiting_p99 = pct.waiting[ip99];
+	s.slowdown_p99 = pct.slowdown[ip99];
 
-			all_wrk[j] = scheditr_twork(si);
-			all_ntasks[j] = scheditr_ntasks(si);
-			all_cachemiss[j] = scheditr_pmiss(si);
-		}
+	/* p99 was not asked for, but summary statistics need it. */
+	if ((report == NULL) || (ip99 == report->npercentiles))
+		pct.n--;
 
-		for (int j = 0; j < ncores; j++ )
-		{
-			for (int k = j + 1; k < ncores; k++ )
-			{
-				/* Workload unbalancement. */
-				if ( all_wrk[j] > all_wrk[k] )
-					wrk_diff += all_wrk[j] - all_wrk[k];
-				else 
-					wrk_diff += all_wrk[k] - all_wrk[j];
-
-				/* Number of tasks unbalancement. */
-				ntasks_diff += abs(all_ntasks[j] - all_ntasks[k]);
-				cachemiss_diff += abs(all_cachemiss[j] - all_cachemiss[k]);
-			}
-		}
-		total_workload_unbalancement += wrk_diff;
-		total_ntasks_unbalancement += ntasks_diff;
-		total_cachemiss_unbalancement += cachemiss_diff;
-	}
+	// Analysing how well balanced was the scheduling.
+	imbalance_create(&imb, cores);
 
 	unsigned long int page_hit = 0,
 					  page_fault = 0,
 					  cache_hit = 0,
-	    			  cache_miss = 0;
+	    			  cache_miss = 0,
+	                  tlb_hit = 0,
+	                  tlb_miss = 0;
 
 	for ( unsigned long int i = 0; i < array_size(cores); i++ )
 	{
@@ -270,68 +997,112 @@ static void simsched_dump(array_tt cores, workload_tt w)
 		page_fault += core_page_fault(array_get(cores, i));
 		cache_hit += core_hit(array_get(cores, i));
 		cache_miss += core_miss(array_get(cores, i));
+		if ( core_has_tlb(array_get(cores, i)) )
+		{
+			tlb_hit += core_tlb_hit(array_get(cores, i));
+			tlb_miss += core_tlb_miss(array_get(cores, i));
+		}
+	}
+
+	s.waiting_sum = sim->waiting_sum;
+	s.page_hits = page_hit;
+	s.page_faults = page_fault;
+	s.cache_hits = cache_hit;
+	s.cache_misses = cache_miss;
+	s.evictions = RAM_evictions(RAM);
+	s.tlb_hits = tlb_hit;
+	s.tlb_misses = tlb_miss;
+	s.workload_unbalance = imb.work_total;
+	s.ntasks_unbalance = imb.ntasks_total;
+	s.cachemiss_unbalance = imb.cachemiss_total;
+	s.time = max;
+	s.cost = max*ncores;
+	s.performance = total/max;
+	s.total = total;
+	s.cov = stddev/mean;
+	s.slowdown = max/((double) min);
+
+	if (wr != NULL)
+	{
+		int nlevels = core_cache_nlevels(array_get(cores, 0));
+		unsigned long int level_hit[nlevels],
+		                  level_miss[nlevels];
+
+		level_hit[0] = cache_hit;
+		level_miss[0] = cache_miss;
+		for ( int l = 1; l < nlevels; l++ )
+		{
+			level_hit[l] = 0;
+			level_miss[l] = 0;
+			for ( int i = 0; i < ncores; i++ )
+			{
+				level_hit[l] += core_cache_level_hit(array_get(cores, i), l);
+				level_miss[l] += core_cache_level_miss(array_get(cores, i), l);
+			}
+		}
+
+		dump_cores(wr, format, cores);
+		dump_itrs(wr, format, &imb);
+		dump_summary(wr, format, cores, RAM, &s, &pct, &imb, nlevels, level_hit, level_miss);
+
+		if (format == OUTPUT_JSON)
+			writer_puts(wr, "}\n");
+
+		writer_destroy(wr);
 	}
 
-	printf("waiting time sum: %lu\n", sum);
-	printf("99th Percentile Waiting Time: %ld\n", percentile_waitingtime);
-	printf("99th Percentile Tasks' Slowdown: %f\n", percentile_slowdown);
-	printf("Total page hits: %lu - Total page faults: %lu\n", page_hit, page_fault);
-	printf("Total cache hits: %lu - Total cache misses: %lu\n", cache_hit, cache_miss);
-	printf("Total Unbalancement: %lu\n", total_workload_unbalancement);
-	printf("Total Workload Unbalancement: %lu\n", total_workload_unbalancement);
-	printf("Total Number of Tasks Unbalancement: %d\n", total_ntasks_unbalancement);
-	printf("Total Cache Miss Unbalancement: %d\n", total_cachemiss_unbalancement);
-	printf("time: %lu\n", max);
-	printf("cost: %lu\n", max*ncores);
-	printf("performance: %ld\n", total/max);
-	printf("total: %lu\n", total);
-	printf("cov: %lf\n", stddev/mean);
-	printf("slowdown: %lf\n", max/((double) min));
+	if (stats != NULL)
+		*stats = s;
 
+	/* House keeping. */
+	imbalance_destroy(&imb);
 }
 
 /**
  * @brief Spawns cores.
  *
- * @param cores Working cores.
- * @param pin   Pin cores?
+ * @param sim      Target simulation.
+ * @param pincores Pin cores?
  */
-static void cores_spawn(array_tt cores, bool pincores)
+static void cores_spawn(struct simulation *sim, bool pincores)
 {
-	ready = queue_create();	
-	running = queue_create();
+	sim->ready = queue_create();	
+	sim->processing = queue_create();
 
 	if (!pincores)
-		array_shuffle(cores);
+		array_shuffle(sim->cores, &sim->rng);
 
-	for ( unsigned long int i = 0; i < array_size(cores); i++ )
+	for ( unsigned long int i = 0; i < array_size(sim->cores); i++ )
 	{
-		core_tt c = array_get(cores, i);
-		queue_insert(ready, c);
+		core_tt c = array_get(sim->cores, i);
+		queue_insert(sim->ready, c);
 	}
 }
 
 /**
  * @brief Cleaning queues.
+ *
+ * @param sim Target simulation.
  */
-static void threads_join(void)
+static void threads_join(struct simulation *sim)
 {
-	queue_destroy(running);
-	queue_destroy(ready);
-	queue_destroy(processing);
+	queue_destroy(sim->ready);
+	queue_destroy(sim->processing);
 }
 
 /**
  * @brief Chooses a core to run next.
  *
- * @param Target core queue.
+ * @param sim Target simulation.
+ * @param q   Target core queue.
  *
  * @returns The next core to run.
  */
-static core_tt choose_core(queue_tt q)
+static core_tt choose_core(struct simulation *sim, queue_tt q)
 {
 	core_tt t;
 	/* Sanity check. */
+	assert(sim != NULL);
 	assert(q != NULL);
 	assert(!queue_empty(q));
 
@@ -339,7 +1110,7 @@ static core_tt choose_core(queue_tt q)
 	{
 		t = queue_remove(q);
 
-		if (rand()%2)
+		if (rng_next(&sim->rng)%2)
 			break;
 
 		queue_insert(q, t);
@@ -507,31 +1278,81 @@ static void model_optimization(struct workload *w, struct model *m, array_tt cor
 	model_train(m, cores, all_buckets, all_tasks); 
 }
 
+/**
+ * @brief Moves tasks that have arrived by now to the ready queues.
+ *
+ * @param sim Target simulation.
+ */
+static inline void check_arrivals(struct simulation *sim)
+{
+	PROFILE_START(arrival);
+	workload_checktasks(sim->workload, sim->clock);
+	PROFILE_PHASE(arrival, sim->profile, PROFILE_ARRIVAL);
+}
+
 /**
  * @brief Simulates a parallel execution.
  *
  * @param w         Workload.
+ * @param cores     Working cores.
+ * @param geometry  Memory geometry.
  * @param strategy  Scheduling strategy.
  * @param processer Processing strategy.
- * @param cores     Working cores.
+ * @param paging    Page replacement policy.
  * @param batchsize Batchsize;
  * @param winsize   Memory accesses window size.
  * @param optimize  Optimize schedulers? 
+ * @param nthreads  Threads simulating cores.
+ * @param seed      Seed of the simulation's random sequence.
+ * @param arena     Arena of per-run objects (may be NULL).
+ * @param report    How to print statistics, and where to store phase times (may be NULL).
+ * @param stats     Where to store summary statistics (may be NULL).
  */
-void simsched(workload_tt w, array_tt cores, const struct scheduler *strategy, const struct processer *processer, int batchsize, int winsize, int optimize)
+void simsched(workload_tt w, array_tt cores, const struct mem_geometry *geometry, const struct scheduler *strategy, const struct processer *processer, const struct page_policy *paging, int batchsize, int winsize, int optimize, int nthreads, int seed, arena_tt arena, const struct report *report, struct simstats *stats)
 {
+	struct simulation sim;
+
 	/* Sanity check. */
 	assert(w != NULL);
     assert(cores != NULL);
+	assert(geometry != NULL);
 	assert(strategy != NULL);
 	assert(processer != NULL);
+	assert(paging != NULL);
+	assert(nthreads > 0);
+
+	PROFILE_START(simulation);
+
+	memset(sim.profile, 0, sizeof(sim.profile));
+	sim.clock = 0;
+	sim.workload = w;
+	sim.cores = cores;
+	sim.arena = arena;
+	sim.RAM = RAM_init(w, geometry, paging, sim.arena);
+	sim.batchsize = batchsize;
+	sim.nthreads = nthreads;
+	sim.processdata = NULL;
+	sim.trace = NULL;
+	rng_seed(&sim.rng, seed);
+	sim.waiting_sum = 0;
+	sim.waiting = NULL;
+	sim.slowdown = NULL;
+	if ((report != NULL) && (report->trace != NULL))
+		sim.trace = trace_create(report->trace, report->traceformat, cores);
+	if ((report != NULL) && (report->sketch))
+	{
+		sim.waiting = sketch_create(DUMP_SKETCH_ACCURACY);
+		sim.slowdown = sketch_create(DUMP_SKETCH_ACCURACY);
+	}
 
-	RAM_tt RAM = RAM_init(w);
-	cores_spawn(cores, strategy->pincores);
-	strategy->init(w, batchsize);
-	processer->init(w, cores, &g_iterator, RAM);
+	/* Page tables are sized after the memory geometry. */
+	for (int i = 0; i < workload_ntasks(w); i++)
+		task_map(workload_find_task(w, i), geometry);
+
+	cores_spawn(&sim, strategy->pincores);
+	strategy->init(&sim);
+	processer->init(&sim);
 
-    processing = queue_create();
 	/* 
 	 * 'workload' is a critical region, so we must add a queue contention delay to proper analyse.
 	 * This value is accumulative and calculated based on how many iterations was spent scheduling tasks.
@@ -551,16 +1372,19 @@ void simsched(workload_tt w, array_tt cores, const struct scheduler *strategy, c
 	 */
 	if ( optimize == 1)
 	{
-		kmeans_tt k = kmeans_create(100, array_size(cores), winsize);
+		kmeans_tt k = kmeans_create(100, array_size(cores), winsize, &sim.rng);
 		for ( /* noop */; workload_totaltasks(w) > 0; /* noop */)
 		{    
 			controller = 0;
-			workload_checktasks(w, g_iterator);
+			check_arrivals(&sim);
 
 			while ( workload_currtasks(w) < batchsize && workload_currtasks(w) != workload_totaltasks(w) )
 			{
-				workload_checktasks(w, g_iterator);
-				g_iterator++;
+				/* Nothing happens until the next arrival. */
+				if ( sim.clock < workload_next_arrival(w) )
+					sim.clock = workload_next_arrival(w);
+				check_arrivals(&sim);
+				sim.clock++;
 			}
 			
 			/* Number of already processed tasks, i.e., Number of tasks in our second-from-last queue. */
@@ -572,86 +1396,104 @@ void simsched(workload_tt w, array_tt cores, const struct scheduler *strategy, c
 			// 	group(w, winsize, k);
 			// else 
 			// 	populate_queues_opt(w, cores, array_size(cores));
+			PROFILE_START(grouping);
 			group(w, winsize, k);
+			PROFILE_PHASE(grouping, sim.profile, PROFILE_GROUPING);
 
 
 			/* Scheduling tasks to ready cores. */
+			PROFILE_START(scheduling);
 
-			while ( !queue_empty(ready) )
+			while ( !queue_empty(sim.ready) )
 			{
-				core_tt c = choose_core(ready);
+				core_tt c = choose_core(&sim, sim.ready);
 
 				/* Scheduling with core's "piece" of workload. */
-				queue_contention = strategy->sched(c, (queue_tt) array_get(workload_arrtasks(w), core_getcid(c)));
+				queue_contention = strategy->sched(&sim, c, (queue_tt) array_get(workload_arrtasks(w), core_getcid(c)));
 				controller += queue_contention;
 
 				if ( controller != 0 )
 				{
-					if ( queue_contention == 0 ) g_iterator--;
-					queue_insert(processing, c);
-				} else queue_insert(ready, c);
+					if ( queue_contention == 0 ) sim.clock--;
+					queue_insert(sim.processing, c);
+				} else queue_insert(sim.ready, c);
 
 				core_set_contention(c, -(queue_contention));
 			}
+			PROFILE_PHASE(scheduling, sim.profile, PROFILE_SCHEDULE);
 			
-			processer->process();
+			PROFILE_START(processing);
+			processer->process(&sim);
+			PROFILE_PHASE(processing, sim.profile, PROFILE_PROCESS);
 	
 			/* Cleaning up. */
-			while(!queue_empty(processing))
-				queue_insert(ready, queue_remove(processing));
+			while(!queue_empty(sim.processing))
+				queue_insert(sim.ready, queue_remove(sim.processing));
 		}
 		kmeans_destroy(k);	
 	} else if ( optimize == 2 ){
 		for ( /* noop */; workload_totaltasks(w) > 0; /* noop */)
 		{    
 			controller = 0;
-			workload_checktasks(w, g_iterator);
+			check_arrivals(&sim);
 
 			while ( workload_currtasks(w) < batchsize && workload_currtasks(w) != workload_totaltasks(w) )
 			{
-				workload_checktasks(w, g_iterator);
-				g_iterator++;
+				/* Nothing happens until the next arrival. */
+				if ( sim.clock < workload_next_arrival(w) )
+					sim.clock = workload_next_arrival(w);
+				check_arrivals(&sim);
+				sim.clock++;
 			}
 			
+			PROFILE_START(grouping);
 			populate_queues_opt(w, cores, array_size(cores));
+			PROFILE_PHASE(grouping, sim.profile, PROFILE_GROUPING);
 
 			/* Scheduling tasks to ready cores. */
+			PROFILE_START(scheduling);
 
-			while ( !queue_empty(ready) )
+			while ( !queue_empty(sim.ready) )
 			{
-				core_tt c = choose_core(ready);
+				core_tt c = choose_core(&sim, sim.ready);
 
 				/* Scheduling with core's "piece" of workload. */
-				queue_contention = strategy->sched(c, (queue_tt) array_get(workload_arrtasks(w), core_getcid(c)));
+				queue_contention = strategy->sched(&sim, c, (queue_tt) array_get(workload_arrtasks(w), core_getcid(c)));
 				controller += queue_contention;
 
 				if ( controller != 0 )
 				{
-					if ( queue_contention == 0 ) g_iterator--;
-					queue_insert(processing, c);
-				} else queue_insert(ready, c);
+					if ( queue_contention == 0 ) sim.clock--;
+					queue_insert(sim.processing, c);
+				} else queue_insert(sim.ready, c);
 
 				core_set_contention(c, -(queue_contention));
 			}
+			PROFILE_PHASE(scheduling, sim.profile, PROFILE_SCHEDULE);
 			
-			processer->process();
+			PROFILE_START(processing);
+			processer->process(&sim);
+			PROFILE_PHASE(processing, sim.profile, PROFILE_PROCESS);
 	
 			/* Cleaning up. */
-			while(!queue_empty(processing))
-				queue_insert(ready, queue_remove(processing));
+			while(!queue_empty(sim.processing))
+				queue_insert(sim.ready, queue_remove(sim.processing));
 		}
 	} else if ( optimize == 3 )
 	{
-		model_tt model = model_create(array_size(cores), core_capacity(array_get(cores, 0)), winsize);
+		model_tt model = model_create(array_size(cores), core_capacity(array_get(cores, 0)), winsize, &sim.rng);
 		for ( /* noop */; workload_totaltasks(w) > 0; /* noop */)
 		{    
 			controller = 0;
-			workload_checktasks(w, g_iterator);
+			check_arrivals(&sim);
 
 			while ( workload_currtasks(w) < batchsize && workload_currtasks(w) != workload_totaltasks(w) )
 			{
-				workload_checktasks(w, g_iterator);
-				g_iterator++;
+				/* Nothing happens until the next arrival. */
+				if ( sim.clock < workload_next_arrival(w) )
+					sim.clock = workload_next_arrival(w);
+				check_arrivals(&sim);
+				sim.clock++;
 			}
 			
 			/* Number of already processed tasks, i.e., Number of tasks in our second-from-last queue. */
@@ -662,32 +1504,38 @@ void simsched(workload_tt w, array_tt cores, const struct scheduler *strategy, c
 			// 	model_optimization(w, model, cores);
 			// else
 			// 	populate_queues_opt(w, cores, array_size(cores));
+			PROFILE_START(grouping);
 			model_optimization(w, model, cores);
+			PROFILE_PHASE(grouping, sim.profile, PROFILE_MODEL);
 
 			/* Scheduling tasks to ready cores. */
+			PROFILE_START(scheduling);
 
-			while ( !queue_empty(ready) )
+			while ( !queue_empty(sim.ready) )
 			{
-				core_tt c = choose_core(ready);
+				core_tt c = choose_core(&sim, sim.ready);
 
 				/* Scheduling with core's "piece" of workload. */
-				queue_contention = strategy->sched(c, (queue_tt) array_get(workload_arrtasks(w), core_getcid(c)));
+				queue_contention = strategy->sched(&sim, c, (queue_tt) array_get(workload_arrtasks(w), core_getcid(c)));
 				controller += queue_contention;
 
 				if ( controller != 0 )
 				{
-					if ( queue_contention == 0 ) g_iterator--;
-					queue_insert(processing, c);
-				} else queue_insert(ready, c);
+					if ( queue_contention == 0 ) sim.clock--;
+					queue_insert(sim.processing, c);
+				} else queue_insert(sim.ready, c);
 
 				core_set_contention(c, -(queue_contention));
 			}
+			PROFILE_PHASE(scheduling, sim.profile, PROFILE_SCHEDULE);
 			
-			processer->process();
+			PROFILE_START(processing);
+			processer->process(&sim);
+			PROFILE_PHASE(processing, sim.profile, PROFILE_PROCESS);
 	
 			/* Cleaning up. */
-			while(!queue_empty(processing))
-				queue_insert(ready, queue_remove(processing));
+			while(!queue_empty(sim.processing))
+				queue_insert(sim.ready, queue_remove(sim.processing));
 		}
 		model_destroy(model);
 	}
@@ -696,7 +1544,7 @@ void simsched(workload_tt w, array_tt cores, const struct scheduler *strategy, c
 		for ( /* noop */ ; workload_totaltasks(w) > 0 ; /* noop */ )
 		{	
 			controller = 0;
-			workload_checktasks(w, g_iterator);
+			check_arrivals(&sim);
 
 			/* 
 			   Idle. 
@@ -704,19 +1552,23 @@ void simsched(workload_tt w, array_tt cores, const struct scheduler *strategy, c
 			*/
 			while ( workload_currtasks(w) < batchsize && workload_currtasks(w) != workload_totaltasks(w) ) 
 			{ 
-				g_iterator++;
-				workload_checktasks(w, g_iterator);
+				/* Nothing happens until the next arrival. */
+				sim.clock = ( sim.clock + 1 < workload_next_arrival(w) ) ? workload_next_arrival(w) : sim.clock + 1;
+				check_arrivals(&sim);
 			}
 
+			PROFILE_START(grouping);
 			populate_queues_not_opt(w, cores);
+			PROFILE_PHASE(grouping, sim.profile, PROFILE_GROUPING);
 
 			/* Scheduling tasks to ready cores. */
-			while(!queue_empty(ready))
+			PROFILE_START(scheduling);
+			while(!queue_empty(sim.ready))
 			{
-				core_tt c = choose_core(ready);
+				core_tt c = choose_core(&sim, sim.ready);
 
 				/* Scheduling with entire workload. */
-				queue_contention = strategy->sched(c, (queue_tt) array_get(workload_arrtasks(w), array_size(workload_arrtasks(w)) - 2));
+				queue_contention = strategy->sched(&sim, c, (queue_tt) array_get(workload_arrtasks(w), array_size(workload_arrtasks(w)) - 2));
 
 				controller += queue_contention;
 
@@ -727,16 +1579,16 @@ void simsched(workload_tt w, array_tt cores, const struct scheduler *strategy, c
 						But if none were scheduled to current core, we must desconsider that we 'looked' for more tasks.
 						As if we knew, beforehand, that there weren't enough tasks yet.
 					*/
-					if ( queue_contention == 0 ) g_iterator--;
+					if ( queue_contention == 0 ) sim.clock--;
 
-					queue_insert(processing, c);
+					queue_insert(sim.processing, c);
 
 				/* Otherwise, keep waiting until enough tasks arrive. */
-				} else queue_insert(ready, c);
+				} else queue_insert(sim.ready, c);
 
 				/*
-					We are basing ourselves in g_iterator to indicate the waiting time of tasks (Check processing strategies).
-					Since we can't prevent a core from trying to schedule (increasing the g_iterator), 
+					We are basing ourselves in sim.clock to indicate the waiting time of tasks (Check processing strategies).
+					Since we can't prevent a core from trying to schedule (increasing the sim.clock), 
 					we force those cores that shouldn't be affected by queue contention to have a negative
 					value (by counting how many tasks were scheduled and removing it from how many tasks given core have)
 					in order to remove this contention value from them.
@@ -746,18 +1598,35 @@ void simsched(workload_tt w, array_tt cores, const struct scheduler *strategy, c
 				*/
 				core_set_contention(c, -(queue_contention));
 			}
-			processer->process();
+			PROFILE_PHASE(scheduling, sim.profile, PROFILE_SCHEDULE);
+			PROFILE_START(processing);
+			processer->process(&sim);
+			PROFILE_PHASE(processing, sim.profile, PROFILE_PROCESS);
 
 			/* Cleaning up. */
-			while(!queue_empty(processing))
-				queue_insert(ready, queue_remove(processing));
+			while(!queue_empty(sim.processing))
+				queue_insert(sim.ready, queue_remove(sim.processing));
 		}
 	}
 
-	strategy->end();
-	processer->end();
-	simsched_dump(cores, w);
+	strategy->end(&sim);
+	processer->end(&sim);
+	PROFILE_START(reporting);
+	simsched_dump(&sim, report, stats);
+	PROFILE_PHASE(reporting, sim.profile, PROFILE_REPORT);
+
+	threads_join(&sim);
+	RAM_destroy(sim.RAM);
+	if (sim.trace != NULL)
+		trace_destroy(sim.trace);
+	if (sim.waiting != NULL)
+	{
+		sketch_destroy(sim.slowdown);
+		sketch_destroy(sim.waiting);
+	}
 
-	threads_join();
-	RAM_destroy(RAM);
-}
\ No newline at end of file
+	PROFILE_PHASE(simulation, sim.profile, PROFILE_SIMULATION);
+
+	if ((report != NULL) && (report->profile != NULL))
+		memcpy(report->profile, sim.profile, sizeof(sim.profile));
+}
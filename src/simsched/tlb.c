@@ -0,0 +1,256 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include <mylib/util.h>
+
+#include <tlb.h>
+
+/**
+ * @brief Invalid ASID, marks an empty entry.
+ */
+#define TLB_ASID_INVALID -1
+
+/**
+ * @brief TLB entry.
+ */
+struct tlb_entry
+{
+    unsigned long int vpn;   /**< Virtual page number.           */
+    unsigned long int frame; /**< Physical frame it maps to.     */
+    int asid;                /**< Owner's address space id.      */
+    unsigned long int stamp; /**< Last use, for LRU replacement. */
+};
+
+/**
+ * @brief Set-associative, ASID-tagged TLB.
+ */
+struct tlb
+{
+    int num_sets;               /**< Number of sets.                         */
+    int num_ways;               /**< Number of ways per set.                 */
+    int latency;                /**< Miss penalty (page walk, in cycles).    */
+    enum tlb_mode mode;         /**< ASID tagging or flush on switch.        */
+    int asid;                   /**< Last address space looked up.           */
+    unsigned long int clock;    /**< Lookups so far, stamps entries.         */
+    struct tlb_entry *entries;  /**< Entries, num_ways per set.              */
+    unsigned long int hits;     /**< Number of hits.                         */
+    unsigned long int misses;   /**< Number of misses.                       */
+    unsigned long int flushes;  /**< Number of flushes on switch.            */
+};
+
+/**
+ * @brief Creates a TLB.
+ * 
+ * @param num_entries Total number of entries.
+ * @param num_ways    Number of ways per set.
+ * @param latency     Miss penalty.
+ * @param mode        Address space switch handling.
+ * 
+ * @returns A TLB.
+ */
+struct tlb *tlb_create(int num_entries, int num_ways, int latency, enum tlb_mode mode)
+{
+    struct tlb *tlb;
+
+    /* Sanity check. */
+    assert(num_entries > 0);
+    assert(num_ways > 0);
+    assert(num_entries % num_ways == 0);
+    assert(latency >= 0);
+
+    tlb = smalloc(sizeof(struct tlb));
+    tlb->num_sets = num_entries / num_ways;
+    tlb->num_ways = num_ways;
+    tlb->latency = latency;
+    tlb->mode = mode;
+    tlb->asid = TLB_ASID_INVALID;
+    tlb->clock = 0;
+    tlb->hits = 0;
+    tlb->misses = 0;
+    tlb->flushes = 0;
+    tlb->entries = smalloc(sizeof(struct tlb_entry) * num_entries);
+    for ( int i = 0; i < num_entries; i++ )
+        tlb->entries[i].asid = TLB_ASID_INVALID;
+
+    return (tlb);
+}
+
+/**
+ * @brief Drops every entry of a TLB.
+ * 
+ * @param tlb Target TLB.
+ */
+void tlb_flush(struct tlb *tlb)
+{
+    /* Sanity check. */
+    assert(tlb != NULL);
+
+    for ( int i = 0; i < tlb->num_sets * tlb->num_ways; i++ )
+        tlb->entries[i].asid = TLB_ASID_INVALID;
+}
+
+/**
+ * @brief Drops the translation of a page, if cached.
+ * 
+ * @param tlb  Target TLB.
+ * @param asid Address space id (task id).
+ * @param vpn  Virtual page number.
+ */
+void tlb_invalidate(struct tlb *tlb, int asid, unsigned long int vpn)
+{
+    struct tlb_entry *set;
+
+    /* Sanity check. */
+    assert(tlb != NULL);
+
+    set = &tlb->entries[(vpn % tlb->num_sets) * tlb->num_ways];
+    for ( int i = 0; i < tlb->num_ways; i++ )
+    {
+        if ( (set[i].asid == asid) && (set[i].vpn == vpn) )
+            set[i].asid = TLB_ASID_INVALID;
+    }
+}
+
+/**
+ * @brief Looks up a translation, refilling the least recently used way
+ * of its set on a miss. An entry that maps the page to another frame is
+ * stale (the page was evicted meanwhile) and counts as a miss.
+ * In flush mode, switching to another address space first drops every entry.
+ * 
+ * @param tlb   Target TLB.
+ * @param asid  Address space id (task id).
+ * @param vpn   Virtual page number.
+ * @param frame Frame the page currently maps to.
+ * 
+ * @returns True on a TLB hit. False otherwise.
+ */
+bool tlb_access(struct tlb *tlb, int asid, unsigned long int vpn, unsigned long int frame)
+{
+    struct tlb_entry *set;
+    int victim = 0;
+
+    /* Sanity check. */
+    assert(tlb != NULL);
+    assert(asid >= 0);
+
+    if ( (tlb->mode == TLB_FLUSH) && (asid != tlb->asid) && (tlb->asid != TLB_ASID_INVALID) )
+    {
+        tlb_flush(tlb);
+        tlb->flushes++;
+    }
+    tlb->asid = asid;
+    tlb->clock++;
+
+    set = &tlb->entries[(vpn % tlb->num_sets) * tlb->num_ways];
+    for ( int i = 0; i < tlb->num_ways; i++ )
+    {
+        if ( (set[i].asid == asid) && (set[i].vpn == vpn) )
+        {
+            victim = i;
+            if ( set[i].frame == frame )
+            {
+                set[i].stamp = tlb->clock;
+                tlb->hits++;
+                return (true);
+            }
+            break;
+        }
+
+        /* Least recently used, or empty, way. */
+        if ( set[i].asid == TLB_ASID_INVALID )
+            victim = i;
+        else if ( (set[victim].asid != TLB_ASID_INVALID) && (set[i].stamp < set[victim].stamp) )
+            victim = i;
+    }
+
+    set[victim].vpn = vpn;
+    set[victim].frame = frame;
+    set[victim].asid = asid;
+    set[victim].stamp = tlb->clock;
+    tlb->misses++;
+
+    return (false);
+}
+
+/**
+ * @brief Returns the miss penalty of a TLB.
+ * 
+ * @param tlb Target TLB.
+ * 
+ * @returns Miss penalty.
+ */
+int tlb_latency(const struct tlb *tlb)
+{
+    /* Sanity check. */
+    assert(tlb != NULL);
+    return (tlb->latency);
+}
+
+/**
+ * @brief Returns how a TLB copes with address space switches.
+ * 
+ * @param tlb Target TLB.
+ * 
+ * @returns TLB mode.
+ */
+enum tlb_mode tlb_mode(const struct tlb *tlb)
+{
+    /* Sanity check. */
+    assert(tlb != NULL);
+    return (tlb->mode);
+}
+
+/**
+ * @brief Returns the number of TLB hits.
+ * 
+ * @param tlb Target TLB.
+ * 
+ * @returns Number of hits.
+ */
+unsigned long int tlb_hits(const struct tlb *tlb)
+{
+    /* Sanity check. */
+    assert(tlb != NULL);
+    return (tlb->hits);
+}
+
+/**
+ * @brief Returns the number of TLB misses.
+ * 
+ * @param tlb Target TLB.
+ * 
+ * @returns Number of misses.
+ */
+unsigned long int tlb_misses(const struct tlb *tlb)
+{
+    /* Sanity check. */
+    assert(tlb != NULL);
+    return (tlb->misses);
+}
+
+/**
+ * @brief Returns the number of flushes caused by address space switches.
+ * 
+ * @param tlb Target TLB.
+ * 
+ * @returns Number of flushes.
+ */
+unsigned long int tlb_flushes(const struct tlb *tlb)
+{
+    /* Sanity check. */
+    assert(tlb != NULL);
+    return (tlb->flushes);
+}
+
+/**
+ * @brief Destroys a TLB.
+ * 
+ * @param tlb Target TLB.
+ */
+void tlb_destroy(struct tlb *tlb)
+{
+    /* Sanity check. */
+    assert(tlb != NULL);
+    sfree(tlb->entries);
+    sfree(tlb);
+}
@@ -0,0 +1,223 @@
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <mylib/util.h>
+#include <mylib/writer.h>
+
+#include <core.h>
+#include <trace.h>
+
+/**
+ * @brief Number of slices buffered per core.
+ */
+#define TRACE_BUFFER_SLICES 1024
+
+/**
+ * @brief Size of the output buffer of a trace (in bytes).
+ */
+#define TRACE_BUFSIZE (256*1024)
+
+/**
+ * @brief Record of the binary trace format.
+ */
+struct trace_record
+{
+    int32_t core;    /**< Core ID.              */
+    int32_t id;      /**< Task's real ID.       */
+    int32_t tsid;    /**< Task ID.              */
+    int32_t unused;  /**< Padding.              */
+    int64_t start;   /**< Start time (cycles).  */
+    int64_t end;     /**< End time (cycles).    */
+    uint64_t hits;   /**< Cache hits.           */
+    uint64_t misses; /**< Cache misses.         */
+    uint64_t faults; /**< Page faults.          */
+};
+
+/**
+ * @brief Trace of the time slices of tasks on cores.
+ *
+ * @details Each core buffers its own slices, and a full buffer is
+ *          written out at once. A buffer has a single writer, the
+ *          thread that ends slices on its core, so recording takes
+ *          no locks. Slices are grouped by core in the file, rather
+ *          than sorted by time.
+ *
+ *          The binary format is a header (the characters "SIMTRACE",
+ *          then the version and the number of records as 32-bit and
+ *          64-bit integers) followed by fixed-size records, all in
+ *          host byte order. The number of records is only known, and
+ *          written, when the trace is destroyed.
+ */
+struct trace
+{
+    enum trace_format format; /**< File format.                  */
+    writer_tt wr;             /**< Output.                       */
+    FILE *out;                /**< Output file.                  */
+    int ncores;               /**< Number of cores.              */
+    int *cids;                /**< Core IDs.                     */
+    struct slice *slices;     /**< Buffers, one after the other. */
+    int *nslices;             /**< Slices buffered per core.     */
+    uint64_t nrecords;        /**< Slices written out.           */
+    bool first;               /**< No event written yet?         */
+};
+
+/**
+ * @brief Writes out the slices buffered by a core.
+ *
+ * @param t    Target trace.
+ * @param core Core index.
+ */
+static void trace_flush(struct trace *t, int core)
+{
+    const struct slice *buf = &t->slices[core*TRACE_BUFFER_SLICES];
+
+    for ( int i = 0; i < t->nslices[core]; i++ )
+    {
+        const struct slice *s = &buf[i];
+
+        if ( t->format == TRACE_BINARY )
+        {
+            struct trace_record r;
+
+            r.core = t->cids[core];
+            r.id = s->id;
+            r.tsid = s->tsid;
+            r.unused = 0;
+            r.start = s->start;
+            r.end = s->end;
+            r.hits = s->hits;
+            r.misses = s->misses;
+            r.faults = s->faults;
+            writer_write(t->wr, &r, sizeof(struct trace_record));
+        }
+        else
+        {
+            writer_printf(t->wr,
+                "%s\n{\"name\": \"task %d\", \"cat\": \"task\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %ld, \"dur\": %ld, "
+                "\"args\": {\"id\": %d, \"tsid\": %d, \"hits\": %lu, \"misses\": %lu, \"faults\": %lu}}",
+                (t->first) ? "" : ",", s->id, t->cids[core], s->start, s->end - s->start,
+                s->id, s->tsid, s->hits, s->misses, s->faults
+            );
+        }
+        t->first = false;
+    }
+
+    t->nrecords += t->nslices[core];
+    t->nslices[core] = 0;
+}
+
+/**
+ * @brief Creates a trace.
+ *
+ * @param out    Output file, seekable for binary traces.
+ * @param format File format.
+ * @param cores  Working cores.
+ *
+ * @returns A trace.
+ */
+struct trace *trace_create(FILE *out, enum trace_format format, array_tt cores)
+{
+    struct trace *t;
+
+    /* Sanity check. */
+    assert(out != NULL);
+    assert(cores != NULL);
+
+    t = smalloc(sizeof(struct trace));
+
+    t->format = format;
+    t->out = out;
+    t->wr = writer_create(out, TRACE_BUFSIZE);
+    t->ncores = array_size(cores);
+    t->cids = smalloc(t->ncores*sizeof(int));
+    t->slices = smalloc(t->ncores*TRACE_BUFFER_SLICES*sizeof(struct slice));
+    t->nslices = scalloc(t->ncores, sizeof(int));
+    t->nrecords = 0;
+    t->first = true;
+
+    for ( int i = 0; i < t->ncores; i++ )
+        t->cids[i] = core_getcid(array_get(cores, i));
+
+    if ( format == TRACE_BINARY )
+    {
+        uint32_t version = TRACE_VERSION;
+
+        writer_write(t->wr, "SIMTRACE", 8);
+        writer_write(t->wr, &version, sizeof(uint32_t));
+        writer_write(t->wr, &t->nrecords, sizeof(uint64_t));
+    }
+    else
+    {
+        writer_puts(t->wr, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [");
+
+        /* Name tracks after cores. */
+        for ( int i = 0; i < t->ncores; i++ )
+        {
+            writer_printf(t->wr, "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, \"args\": {\"name\": \"core %d\"}}",
+                (t->first) ? "" : ",", t->cids[i], t->cids[i]
+            );
+            t->first = false;
+        }
+    }
+
+    return (t);
+}
+
+/**
+ * @brief Writes out and destroys a trace.
+ *
+ * @param t Target trace.
+ *
+ * @note The output file is not closed.
+ */
+void trace_destroy(struct trace *t)
+{
+    /* Sanity check. */
+    assert(t != NULL);
+
+    for ( int i = 0; i < t->ncores; i++ )
+        trace_flush(t, i);
+
+    if ( t->format == TRACE_JSON )
+        writer_puts(t->wr, "\n]}\n");
+
+    writer_destroy(t->wr);
+
+    /* Patch number of records in the header. */
+    if ( t->format == TRACE_BINARY )
+    {
+        if ( (fseek(t->out, 8 + sizeof(uint32_t), SEEK_SET) != 0) ||
+             (fwrite(&t->nrecords, sizeof(uint64_t), 1, t->out) != 1) )
+            error("cannot write trace header");
+        fflush(t->out);
+    }
+
+    /* House keeping. */
+    sfree(t->nslices);
+    sfree(t->slices);
+    sfree(t->cids);
+    sfree(t);
+}
+
+/**
+ * @brief Records the time slice of a task on a core.
+ *
+ * @param t     Target trace.
+ * @param core  Core index.
+ * @param slice Target time slice.
+ */
+void trace_slice(struct trace *t, int core, const struct slice *slice)
+{
+    /* Sanity check. */
+    assert(t != NULL);
+    assert((core >= 0) && (core < t->ncores));
+    assert(slice != NULL);
+
+    if ( t->nslices[core] == TRACE_BUFFER_SLICES )
+        trace_flush(t, core);
+
+    t->slices[core*TRACE_BUFFER_SLICES + t->nslices[core]++] = *slice;
+}
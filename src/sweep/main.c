@@ -0,0 +1,590 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ *
+ * This file is part of Scheduler.
+ *
+ * Scheduler is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * Scheduler is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Scheduler; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <mylib/util.h>
+
+#include <config.h>
+#include <core.h>
+#include <process.h>
+#include <scheduler.h>
+#include <workload.h>
+
+/**
+ * @brief Output formats.
+ */
+enum sweep_output
+{
+	SWEEP_CSV, /**< Comma-separated values. */
+	SWEEP_JSON /**< JSON array of objects.  */
+};
+
+/**
+ * @brief List of values of a swept parameter.
+ */
+struct list
+{
+	char **values; /**< Values.           */
+	int n;         /**< Number of values. */
+};
+
+/**
+ * @brief Simulation configuration.
+ */
+struct run
+{
+	const char *scheduler; /**< Loop scheduling strategy name. */
+	const char *processer; /**< Core processing strategy name. */
+	int batchsize;         /**< Scheduling batch size.         */
+	int winsize;           /**< Memory accesses window size.   */
+	int seed;              /**< Seed.                          */
+	bool done;             /**< Did the simulation succeed?    */
+	struct simstats stats; /**< Simulation statistics.         */
+};
+
+/**
+ * @brief Record sent by a simulation back to the sweep driver.
+ */
+struct record
+{
+	int index;             /**< Configuration index.   */
+	struct simstats stats; /**< Simulation statistics. */
+};
+
+/**
+ * @name Program Parameters
+ */
+static struct
+{
+	workload_tt workload;             /**< Input workload.                            */
+	array_tt cores;                   /**< Cores to process tasks.                    */
+	queue_tt caches;                  /**< Caches shared by cores.                    */
+	struct mem_geometry geometry;     /**< Memory geometry.                           */
+	const struct page_policy *paging; /**< Page replacement policy.                   */
+	int optimize;                     /**< If scheduling optimization should be done. */
+	int njobs;                        /**< Simulations running at once.               */
+	enum sweep_output output;         /**< Output format.                             */
+	struct list schedulers;           /**< Loop scheduling strategies.                */
+	struct list processers;           /**< Core processing strategies.                */
+	struct list batchsizes;           /**< Scheduling batch sizes.                    */
+	struct list winsizes;             /**< Memory accesses window sizes.              */
+	struct list seeds;                /**< Seeds.                                     */
+} args = { NULL, NULL, NULL, { 0, 0, 0 }, NULL, 0, 0, SWEEP_CSV, {NULL, 0}, {NULL, 0}, {NULL, 0}, {NULL, 0}, {NULL, 0} };
+
+/*============================================================================*
+ * ARGUMENT CHECKING                                                          *
+ *============================================================================*/
+
+/**
+ * @brief Prints program usage and exits.
+ */
+static void usage(void)
+{
+	printf("Usage: simsched-sweep [options]\n");
+	printf("Brief: runs loop scheduler simulations over a parameter grid\n");
+	printf("Options:\n");
+	printf("  --arch <filename>        Cores' architecture file.\n");
+	printf("  --input <filename>       Input workload file.\n");
+	printf("  --format <type>          Input workload file format (text or binary, default: detected).\n");
+	printf("  --kernel <name>          Kernel complexity.\n");
+	printf("  --ncores <number>        Number of working cores.\n");
+	printf("  --optimize <number>      0 = No Opt. 1 = KMeans DTW. 2 = Simple OPT. 3 = Model OPT\n");
+	printf("  --paging <name>          Page replacement policy.\n");
+	printf("  --schedulers <list>      Loop scheduling strategies.\n");
+	printf("  --processers <list>      Cores' processing strategies.\n");
+	printf("  --batchsizes <list>      Batch sizes (default 1).\n");
+	printf("  --winsizes <list>        Memory accesses window sizes.\n");
+	printf("  --seeds <list>           Seed values (default 0).\n");
+	printf("  --jobs <number>          Simulations running at once (default all cores).\n");
+	printf("  --output <type>          Output format.\n");
+	printf("           csv                  Comma-separated values (default).\n");
+	printf("           json                 JSON array of objects.\n");
+	printf("  --help                   Display this message.\n");
+	printf("Lists are comma-separated, e.g. --schedulers fcfs,srtf\n");
+
+	exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Splits a comma-separated list.
+ *
+ * @param str List of values.
+ *
+ * @returns A list of values.
+ */
+static struct list list_split(const char *str)
+{
+	struct list l;
+	char *buf;
+
+	/* Sanity check. */
+	assert(str != NULL);
+
+	buf = smalloc(strlen(str) + 1);
+	strcpy(buf, str);
+
+	l.n = 1;
+	for (const char *p = str; *p != '\0'; p++)
+	{
+		if (*p == ',')
+			l.n++;
+	}
+	l.values = smalloc(l.n*sizeof(char *));
+
+	l.n = 0;
+	for (char *tok = strtok(buf, ","); tok != NULL; tok = strtok(NULL, ","))
+		l.values[l.n++] = tok;
+
+	if (l.n == 0)
+		error("empty list of values");
+
+	return (l);
+}
+
+/**
+ * @brief Checks program arguments.
+ *
+ * @param wfilename  Input workload filename.
+ * @param afilename  Input architecture filename.
+ * @param kernelname Application kernel name.
+ * @param ncores     Number of cores in our simulation.
+ */
+static void checkargs(const char *wfilename, const char *afilename, const char *kernelname, int ncores)
+{
+	if (afilename == NULL)
+		error("missing architecture file.");
+	if (wfilename == NULL)
+		error("missing input workload file.");
+	if (kernelname == NULL)
+		error("missing kernel name.");
+	if (!(ncores > 0))
+		error("missing cores.");
+	if (args.schedulers.n == 0)
+		error("missing loop scheduling strategies.");
+	if (args.processers.n == 0)
+		error("missing cores' processing strategies.");
+	if (args.winsizes.n == 0)
+		error("missing window sizes.");
+	if (args.optimize < 0 || args.optimize > 3)
+		error("invalid optimization decision.");
+	if (args.njobs < 1)
+		error("number of jobs must be positive.");
+
+	for (int i = 0; i < args.schedulers.n; i++)
+	{
+		if (config_scheduler(args.schedulers.values[i]) == NULL)
+			error("unsupported scheduling strategy");
+	}
+	for (int i = 0; i < args.processers.n; i++)
+	{
+		if (config_processer(args.processers.values[i]) == NULL)
+			error("invalid core processing strategy.");
+	}
+	for (int i = 0; i < args.winsizes.n; i++)
+	{
+		if (atoi(args.winsizes.values[i]) > QUANTUM)
+			error("window size must be equal or smaller than QUANTUM.");
+	}
+}
+
+/**
+ * @brief Reads command line arguments.
+ *
+ * @param argc Argument count.
+ * @param argv Argument variables.
+ */
+static void readargs(int argc, const char **argv)
+{
+	const char *wfilename  = NULL;
+	const char *afilename  = NULL;
+	const char *kernelname = NULL;
+	enum workload_format format = WORKLOAD_AUTO;
+	void (*kernel)(workload_tt);
+	arch_tt arch;
+	int ncores = 0;
+
+	args.njobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+	/* Parse command line arguments. */
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--help"))
+			usage();
+		else if (i + 1 == argc)
+			error("missing option value");
+		else if (!strcmp(argv[i], "--arch"))
+			afilename = argv[++i];
+		else if (!strcmp(argv[i], "--input"))
+			wfilename = argv[++i];
+		else if (!strcmp(argv[i], "--format"))
+			format = config_format(argv[++i]);
+		else if (!strcmp(argv[i], "--kernel"))
+			kernelname = argv[++i];
+		else if (!strcmp(argv[i], "--ncores"))
+			ncores = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--optimize"))
+			args.optimize = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--paging"))
+		{
+			if ((args.paging = config_page_policy(argv[++i])) == NULL)
+				error("unsupported page replacement policy");
+		}
+		else if (!strcmp(argv[i], "--schedulers"))
+			args.schedulers = list_split(argv[++i]);
+		else if (!strcmp(argv[i], "--processers"))
+			args.processers = list_split(argv[++i]);
+		else if (!strcmp(argv[i], "--batchsizes"))
+			args.batchsizes = list_split(argv[++i]);
+		else if (!strcmp(argv[i], "--winsizes"))
+			args.winsizes = list_split(argv[++i]);
+		else if (!strcmp(argv[i], "--seeds"))
+			args.seeds = list_split(argv[++i]);
+		else if (!strcmp(argv[i], "--jobs"))
+			args.njobs = atoi(argv[++i]);
+		else if (!strcmp(argv[i], "--output"))
+		{
+			i++;
+			if (!strcmp(argv[i], "csv"))
+				args.output = SWEEP_CSV;
+			else if (!strcmp(argv[i], "json"))
+				args.output = SWEEP_JSON;
+			else
+				error("unsupported output format");
+		}
+		else
+			error("invalid option");
+	}
+
+	if (args.batchsizes.n == 0)
+		args.batchsizes = list_split("1");
+	if (args.seeds.n == 0)
+		args.seeds = list_split("0");
+
+	checkargs(wfilename, afilename, kernelname, ncores);
+
+	if (args.paging == NULL)
+		args.paging = page_policy_fifo;
+
+	if ((kernel = config_kernel(kernelname)) == NULL)
+		error("unsupported application kernel");
+
+	arch = config_arch(afilename);
+	if (ncores > arch_ncores(arch))
+		error("not enough cores in architecture file");
+
+	arch_memory(arch, &args.geometry);
+	args.workload = config_workload(wfilename, format, ncores, NULL);
+	args.caches = queue_create();
+	args.cores = arch_cores(arch, ncores, args.caches, NULL);
+	arch_destroy(arch);
+
+	kernel(args.workload);
+	workload_sort(args.workload, WORKLOAD_ARRIVAL);
+}
+
+/*============================================================================*
+ * SWEEP                                                                      *
+ *============================================================================*/
+
+/**
+ * @brief Enumerates simulation configurations.
+ *
+ * @param nruns Where to store the number of configurations.
+ *
+ * @returns Simulation configurations.
+ */
+static struct run *runs_create(int *nruns)
+{
+	struct run *runs;
+	int n;
+
+	/* Sanity check. */
+	assert(nruns != NULL);
+
+	n = args.schedulers.n*args.processers.n*args.batchsizes.n*args.winsizes.n*args.seeds.n;
+	runs = smalloc(n*sizeof(struct run));
+
+	n = 0;
+	for (int s = 0; s < args.schedulers.n; s++)
+	{
+		for (int p = 0; p < args.processers.n; p++)
+		{
+			for (int b = 0; b < args.batchsizes.n; b++)
+			{
+				for (int w = 0; w < args.winsizes.n; w++)
+				{
+					for (int r = 0; r < args.seeds.n; r++)
+					{
+						runs[n].scheduler = args.schedulers.values[s];
+						runs[n].processer = args.processers.values[p];
+						runs[n].batchsize = atoi(args.batchsizes.values[b]);
+						runs[n].winsize = atoi(args.winsizes.values[w]);
+						runs[n].seed = atoi(args.seeds.values[r]);
+						runs[n].done = false;
+						n++;
+					}
+				}
+			}
+		}
+	}
+
+	*nruns = n;
+
+	return (runs);
+}
+
+/**
+ * @brief Runs a simulation and reports its statistics.
+ *
+ * @details Runs in a child process, on a copy-on-write snapshot of the
+ *          workload and cores that were loaded by the parent.
+ *
+ * @param r     Simulation configuration.
+ * @param index Configuration index.
+ * @param fd    Where to write the statistics.
+ */
+static void run_simulation(const struct run *r, int index, int fd)
+{
+	struct record rec;
+
+	/* Sanity check. */
+	assert(r != NULL);
+
+	rec.index = index;
+	simsched(args.workload,
+		args.cores,
+		&args.geometry,
+		config_scheduler(r->scheduler),
+		config_processer(r->processer),
+		args.paging,
+		r->batchsize,
+		r->winsize,
+		args.optimize,
+		1,
+		r->seed,
+		NULL,
+		NULL,
+		&rec.stats
+	);
+
+	/* Records are smaller than PIPE_BUF, so writes are atomic. */
+	if (write(fd, &rec, sizeof(rec)) != (ssize_t) sizeof(rec))
+		error("cannot report simulation statistics");
+
+	exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Runs all simulations, at most args.njobs at once.
+ *
+ * @param runs  Simulation configurations.
+ * @param nruns Number of configurations.
+ *
+ * @returns Number of failed simulations.
+ */
+static int sweep(struct run *runs, int nruns)
+{
+	int fd[2];
+	int next = 0, running = 0, failed = 0;
+
+	/* Sanity check. */
+	assert(runs != NULL);
+
+	if (pipe(fd) < 0)
+		error("cannot create pipe");
+
+	while ((next < nruns) || (running > 0))
+	{
+		int status;
+		struct record rec;
+
+		/* Spawn simulations. */
+		while ((next < nruns) && (running < args.njobs))
+		{
+			pid_t pid;
+
+			/* Don't duplicate buffered output. */
+			fflush(NULL);
+
+			if ((pid = fork()) < 0)
+				error("cannot fork simulation");
+
+			if (pid == 0)
+			{
+				close(fd[0]);
+				run_simulation(&runs[next], next, fd[1]);
+			}
+
+			next++;
+			running++;
+		}
+
+		/* Reap a simulation. */
+		if (wait(&status) < 0)
+			error("cannot wait for simulation");
+		running--;
+
+		if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+		{
+			failed++;
+			continue;
+		}
+
+		/*
+		 * Each successful simulation has written exactly one record
+		 * before exiting, so there is at least one pending record.
+		 */
+		if (read(fd[0], &rec, sizeof(rec)) != (ssize_t) sizeof(rec))
+			error("cannot read simulation statistics");
+		runs[rec.index].stats = rec.stats;
+		runs[rec.index].done = true;
+	}
+
+	close(fd[0]);
+	close(fd[1]);
+
+	return (failed);
+}
+
+/*============================================================================*
+ * OUTPUT                                                                     *
+ *============================================================================*/
+
+/**
+ * @brief Dumps simulation statistics as comma-separated values.
+ *
+ * @param runs  Simulation configurations.
+ * @param nruns Number of configurations.
+ */
+static void dump_csv(const struct run *runs, int nruns)
+{
+	printf("scheduler,processer,batchsize,winsize,seed,");
+	printf("waiting_sum,waiting_p99,slowdown_p99,");
+	printf("page_hits,page_faults,evictions,cache_hits,cache_misses,tlb_hits,tlb_misses,");
+	printf("workload_unbalance,ntasks_unbalance,cachemiss_unbalance,");
+	printf("time,cost,performance,total,cov,slowdown\n");
+
+	for (int i = 0; i < nruns; i++)
+	{
+		const struct run *r = &runs[i];
+		const struct simstats *s = &r->stats;
+
+		if (!r->done)
+			continue;
+
+		printf("%s,%s,%d,%d,%d,", r->scheduler, r->processer, r->batchsize, r->winsize, r->seed);
+		printf("%lu,%lu,%f,", s->waiting_sum, s->waiting_p99, s->slowdown_p99);
+		printf("%lu,%lu,%lu,%lu,%lu,%lu,%lu,",
+			s->page_hits, s->page_faults, s->evictions,
+			s->cache_hits, s->cache_misses, s->tlb_hits, s->tlb_misses
+		);
+		printf("%lu,%d,%d,", s->workload_unbalance, s->ntasks_unbalance, s->cachemiss_unbalance);
+		printf("%lu,%lu,%lu,%lu,%lf,%lf\n", s->time, s->cost, s->performance, s->total, s->cov, s->slowdown);
+	}
+}
+
+/**
+ * @brief Dumps simulation statistics as a JSON array.
+ *
+ * @param runs  Simulation configurations.
+ * @param nruns Number of configurations.
+ */
+static void dump_json(const struct run *runs, int nruns)
+{
+	bool first = true;
+
+	printf("[");
+	for (int i = 0; i < nruns; i++)
+	{
+		const struct run *r = &runs[i];
+		const struct simstats *s = &r->stats;
+
+		if (!r->done)
+			continue;
+
+		printf("%s\n  {", (first) ? "" : ",");
+		printf("\"scheduler\": \"%s\", \"processer\": \"%s\", ", r->scheduler, r->processer);
+		printf("\"batchsize\": %d, \"winsize\": %d, \"seed\": %d, ", r->batchsize, r->winsize, r->seed);
+		printf("\"waiting_sum\": %lu, \"waiting_p99\": %lu, \"slowdown_p99\": %f, ",
+			s->waiting_sum, s->waiting_p99, s->slowdown_p99
+		);
+		printf("\"page_hits\": %lu, \"page_faults\": %lu, \"evictions\": %lu, ",
+			s->page_hits, s->page_faults, s->evictions
+		);
+		printf("\"cache_hits\": %lu, \"cache_misses\": %lu, ", s->cache_hits, s->cache_misses);
+		printf("\"tlb_hits\": %lu, \"tlb_misses\": %lu, ", s->tlb_hits, s->tlb_misses);
+		printf("\"workload_unbalance\": %lu, \"ntasks_unbalance\": %d, \"cachemiss_unbalance\": %d, ",
+			s->workload_unbalance, s->ntasks_unbalance, s->cachemiss_unbalance
+		);
+		printf("\"time\": %lu, \"cost\": %lu, \"performance\": %lu, \"total\": %lu, ",
+			s->time, s->cost, s->performance, s->total
+		);
+		printf("\"cov\": %lf, \"slowdown\": %lf}", s->cov, s->slowdown);
+		first = false;
+	}
+	printf("\n]\n");
+}
+
+/*============================================================================*
+ * SIMULATION SWEEP                                                           *
+ *============================================================================*/
+
+/**
+ * @brief Runs independent loop scheduler simulations in parallel.
+ */
+int main(int argc, const char **argv)
+{
+	struct run *runs;
+	int nruns, failed;
+
+	readargs(argc, argv);
+
+	runs = runs_create(&nruns);
+	failed = sweep(runs, nruns);
+
+	if (args.output == SWEEP_JSON)
+		dump_json(runs, nruns);
+	else
+		dump_csv(runs, nruns);
+
+	if (failed > 0)
+		fprintf(stderr, "simsched-sweep: %d of %d simulations failed\n", failed, nruns);
+
+	/* House keeping. */
+	sfree(runs);
+	for (unsigned long int i = 0; i < array_size(args.cores); i++)
+		core_destroy(array_get(args.cores, i));
+	array_destroy(args.cores);
+	while (!queue_empty(args.caches))
+		cache_destroy(queue_remove(args.caches));
+	queue_destroy(args.caches);
+	workload_destroy(args.workload);
+
+	return ((failed > 0) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright(C) 2016 Pedro H. Penna <pedrohenriquepenna@gmail.com>
+ * 
+ * This file is part of Scheduler.
+ *
+ * Scheduler is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * Scheduler is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with Scheduler; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+ * 02110-1301, USA.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <mylib/util.h>
+
+#include <workload.h>
+
+/**
+ * @name Program arguments.
+ */
+static struct
+{
+	const char *infilename;      /**< Input workload filename.  */
+	const char *outfilename;     /**< Output workload filename. */
+	enum workload_format format; /**< Output file format.       */
+} args = { NULL, NULL, WORKLOAD_BINARY };
+
+/*============================================================================*
+ * ARGUMENT CHECKING                                                          *
+ *============================================================================*/
+
+/**
+ * @brief Prints program usage and exits.
+ */
+static void usage(void)
+{
+	printf("Usage: workloadconv [options]\n");
+	printf("Brief: workload file format converter\n");
+	printf("Options:\n");
+	printf("  --input <filename>     Input workload file (format is detected).\n");
+	printf("  --output <filename>    Output workload file.\n");
+	printf("  --format <type>        Output file format.\n");
+	printf("         text                Plain text\n");
+	printf("         binary              Memory-mappable binary (default)\n");
+	printf("  --help                 Display this message.\n");
+
+	exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief Gets workload file format.
+ *
+ * @param formatname File format name.
+ *
+ * @returns Workload file format.
+ */
+static enum workload_format getformat(const char *formatname)
+{
+	if (!strcmp(formatname, "text"))
+		return (WORKLOAD_TEXT);
+	if (!strcmp(formatname, "binary"))
+		return (WORKLOAD_BINARY);
+
+	error("unsupported workload file format");
+
+	/* Never gets here. */
+	return (-1);
+}
+
+/**
+ * @brief Reads command line arguments.
+ *
+ * @param argc Argument count.
+ * @param argv Argument variables.
+ */
+static void readargs(int argc, const char **argv)
+{
+	/* Parse command line arguments. */
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--input"))
+			args.infilename = argv[++i];
+		else if (!strcmp(argv[i], "--output"))
+			args.outfilename = argv[++i];
+		else if (!strcmp(argv[i], "--format"))
+			args.format = getformat(argv[++i]);
+		else
+			usage();
+	}
+
+	if (args.infilename == NULL)
+		error("missing input workload file");
+	if (args.outfilename == NULL)
+		error("missing output workload file");
+}
+
+/*============================================================================*
+ * WORKLOAD CONVERTER                                                         *
+ *============================================================================*/
+
+/**
+ * @brief Converts a workload file between the text and binary formats.
+ */
+int main(int argc, const char **argv)
+{
+	FILE *input;        /* Input workload file.  */
+	FILE *output;       /* Output workload file. */
+	workload_tt w;      /* Workload.             */
+	const char *errmsg; /* What is wrong.        */
+
+	readargs(argc, argv);
+
+	if ((input = fopen(args.infilename, "rb")) == NULL)
+		error("cannot open input workload file");
+
+	if (workload_detect_format(input) == WORKLOAD_BINARY)
+		w = workload_read_binary(input, 0, NULL, &errmsg);
+	else
+		w = workload_read(input, 0, NULL, &errmsg);
+	fclose(input);
+	if (w == NULL)
+		error(errmsg);
+
+	if ((output = fopen(args.outfilename, "wb")) == NULL)
+		error("cannot open output workload file");
+
+	if (args.format == WORKLOAD_BINARY)
+		workload_write_binary(output, w);
+	else
+		workload_write(output, w);
+	fclose(output);
+
+	/* House keeping. */
+	workload_destroy(w);
+
+	return (EXIT_SUCCESS);
+}
@@ -43,7 +43,8 @@ static struct
 	enum workload_sorting sorting; /**< Workload sorting.                         */
 	int skewness;                  /**< Workload skewness.                        */
 	int arrskewness;               /**< Arrival time skewness.                    */
-} args = { NULL, NULL, 0, 0, 0, WORKLOAD_SHUFFLE, WORKLOAD_SKEWNESS_NULL, WORKLOAD_SKEWNESS_NULL };
+	enum workload_format format;   /**< Output file format.                       */
+} args = { NULL, NULL, 0, 0, 0, WORKLOAD_SHUFFLE, WORKLOAD_SKEWNESS_NULL, WORKLOAD_SKEWNESS_NULL, WORKLOAD_TEXT };
 
 /*============================================================================*
  * ARGUMENT CHECKING                                                          *
@@ -79,6 +80,9 @@ static void usage(void)
 	printf("         ascending           Ascending order\n");
 	printf("         descending          Descending order\n");
 	printf("         shuffle             Shuffle\n");
+	printf("  --format <type>        Output file format.\n");
+	printf("         text                Plain text (default)\n");
+	printf("         binary              Memory-mappable binary\n");
 	printf("  --help                 Display this message.\n");
 
 	exit(EXIT_SUCCESS);
@@ -132,6 +136,26 @@ static enum workload_sorting getsort(const char *sortname)
 	return (-1);
 }
 
+/**
+ * @brief Gets workload file format.
+ *
+ * @param formatname File format name.
+ *
+ * @returns Workload file format.
+ */
+static enum workload_format getformat(const char *formatname)
+{
+	if (!strcmp(formatname, "text"))
+		return (WORKLOAD_TEXT);
+	if (!strcmp(formatname, "binary"))
+		return (WORKLOAD_BINARY);
+
+	error("unsupported workload file format");
+
+	/* Never gets here. */
+	return (-1);
+}
+
 /**
  * @brief Gets workload skewness type.
  *
@@ -217,6 +241,8 @@ static void readargs(int argc, const char **argv)
 			srand(atoi(argv[++i]));
 		else if (!strcmp(argv[i], "--sort"))
 			sortname = argv[++i];
+		else if (!strcmp(argv[i], "--format"))
+			args.format = getformat(argv[++i]);
 		else
 			usage();
 	}
@@ -254,7 +280,10 @@ int main(int argc, const char **argv)
 	w = workload_create(hist, arrh, args.skewness, args.arrskewness, args.ntasks);
 	workload_sort(w, args.sorting);
 
-	workload_write(stdout, w);
+	if (args.format == WORKLOAD_BINARY)
+		workload_write_binary(stdout, w);
+	else
+		workload_write(stdout, w);
 
 	/* House keeping, */
 	distribution_destroy(dist);